@@ -0,0 +1,252 @@
+/// Copyright (c) Vito Domenico Tagliente
+
+#pragma once
+#pragma warning(disable : 4201)
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+#include "algorithm.h"
+#include "config.h"
+#include "deterministic.h"
+#include "matrix2.h"
+#include "vector2.h"
+
+#if defined(VDTMATH_PROFILE)
+#include "profile.h"
+#endif
+
+namespace math
+{
+	// 2D affine transformation, a 2x2 linear part and a translation
+	// it follows the row vector convention of matrix4:
+	// p' = p * linear + translation, stored as 3 rows of 2 columns
+	// with the translation in the last row (m20, m21)
+	// the vector components are read by index, the only access
+	// allowed at compile time on the vector types
+	template <typename T>
+	struct affine2_t
+	{
+		static const affine2_t identity;
+
+		// num of rows
+		static constexpr std::size_t rows = 3;
+		// num of columns
+		static constexpr std::size_t columns = 2;
+		// matrix size
+		static constexpr std::size_t length = 3 * 2;
+
+		// matrix data
+		union
+		{
+			struct
+			{
+				T m00, m01;
+				T m10, m11;
+				T m20, m21;
+			};
+
+			T data[3 * 2];
+		};
+
+		constexpr affine2_t()
+			: m00(1), m01(), m10(), m11(1), m20(), m21()
+		{
+
+		}
+
+		constexpr affine2_t(
+			const T m00, const T m01,
+			const T m10, const T m11,
+			const T m20, const T m21
+		) :
+			m00(m00), m01(m01),
+			m10(m10), m11(m11),
+			m20(m20), m21(m21)
+		{
+
+		}
+
+		constexpr affine2_t(const matrix2_t<T>& linear, const vector2_t<T>& translation)
+			: m00(linear.data[0]), m01(linear.data[1])
+			, m10(linear.data[2]), m11(linear.data[3])
+			, m20(translation[0]), m21(translation[1])
+		{
+
+		}
+
+		// precision conversion
+		template <typename U>
+		constexpr explicit affine2_t(const affine2_t<U>& affine)
+			: m00(static_cast<T>(affine.m00)), m01(static_cast<T>(affine.m01))
+			, m10(static_cast<T>(affine.m10)), m11(static_cast<T>(affine.m11))
+			, m20(static_cast<T>(affine.m20)), m21(static_cast<T>(affine.m21))
+		{
+
+		}
+
+		constexpr affine2_t(const affine2_t& affine) = default;
+
+		constexpr matrix2_t<T> linear() const
+		{
+			return matrix2_t<T>(
+				m00, m01,
+				m10, m11
+			);
+		}
+
+		constexpr vector2_t<T> translation() const
+		{
+			return vector2_t<T>(m20, m21);
+		}
+
+		// transform a point, the translation is applied
+		constexpr vector2_t<T> transform_point(const vector2_t<T>& point) const
+		{
+			return vector2_t<T>(
+				point[0] * m00 + point[1] * m10 + m20,
+				point[0] * m01 + point[1] * m11 + m21
+			);
+		}
+
+		// transform a direction, the translation is ignored
+		constexpr vector2_t<T> transform_vector(const vector2_t<T>& vector) const
+		{
+			return vector2_t<T>(
+				vector[0] * m00 + vector[1] * m10,
+				vector[0] * m01 + vector[1] * m11
+			);
+		}
+
+		// determinant of the linear part
+		constexpr T determinant() const
+		{
+			return m00 * m11 - m01 * m10;
+		}
+
+		constexpr affine2_t inverse(bool& is_invertible) const
+		{
+			VDTMATH_PROFILE_COUNT(matrix_inverse, 1);
+			const T d = determinant();
+			is_invertible = d != static_cast<T>(0.0);
+			if (!is_invertible)
+			{
+				return *this;
+			}
+
+			const T f = static_cast<T>(1.0) / d;
+			const T i00 = m11 * f, i01 = -m01 * f;
+			const T i10 = -m10 * f, i11 = m00 * f;
+			return affine2_t(
+				i00, i01,
+				i10, i11,
+				-(m20 * i00 + m21 * i10), -(m20 * i01 + m21 * i11)
+			);
+		}
+
+		static constexpr affine2_t translate(const vector2_t<T>& vector)
+		{
+			return affine2_t(
+				1, 0,
+				0, 1,
+				vector[0], vector[1]
+			);
+		}
+
+		// same orientation as matrix4::rotate_z
+		static affine2_t rotate(const T theta)
+		{
+			const T rad = radians(theta);
+			const T c = detail::cos(rad);
+			const T s = detail::sin(rad);
+			return affine2_t(
+				c, -s,
+				s, c,
+				0, 0
+			);
+		}
+
+		static constexpr affine2_t scale(const vector2_t<T>& vector)
+		{
+			return affine2_t(
+				vector[0], 0,
+				0, vector[1],
+				0, 0
+			);
+		}
+
+		/* Operators overloading */
+
+		constexpr affine2_t& operator= (const affine2_t& affine) = default;
+
+		constexpr bool operator== (const affine2_t& affine) const
+		{
+			return m00 == affine.m00 && m01 == affine.m01
+				&& m10 == affine.m10 && m11 == affine.m11
+				&& m20 == affine.m20 && m21 == affine.m21;
+		}
+
+		constexpr bool operator!= (const affine2_t& affine) const
+		{
+			return !(*this == affine);
+		}
+
+		// compose, the result applies this transformation first
+		// then the other one, as for matrix4 products
+		constexpr affine2_t operator* (const affine2_t& affine) const
+		{
+			return affine2_t(
+				m00 * affine.m00 + m01 * affine.m10, m00 * affine.m01 + m01 * affine.m11,
+				m10 * affine.m00 + m11 * affine.m10, m10 * affine.m01 + m11 * affine.m11,
+				m20 * affine.m00 + m21 * affine.m10 + affine.m20, m20 * affine.m01 + m21 * affine.m11 + affine.m21
+			);
+		}
+
+		constexpr affine2_t& operator*= (const affine2_t& affine)
+		{
+			return *this = *this * affine;
+		}
+
+		constexpr vector2_t<T> operator* (const vector2_t<T>& point) const
+		{
+			return transform_point(point);
+		}
+	};
+
+	template<typename T> const affine2_t<T> affine2_t<T>::identity = affine2_t<T>();
+
+	// transform an array of points, the result can alias the input
+	template <typename T>
+	inline void transform_points(const affine2_t<T>& affine, const vector2_t<T>* points, vector2_t<T>* result, const std::size_t count)
+	{
+		const T m00 = affine.m00, m01 = affine.m01;
+		const T m10 = affine.m10, m11 = affine.m11;
+		const T m20 = affine.m20, m21 = affine.m21;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const T x = points[i].x, y = points[i].y;
+			result[i].x = x * m00 + y * m10 + m20;
+			result[i].y = x * m01 + y * m11 + m21;
+		}
+	}
+
+	// transform an array of directions, the translation is ignored
+	template <typename T>
+	inline void transform_vectors(const affine2_t<T>& affine, const vector2_t<T>* vectors, vector2_t<T>* result, const std::size_t count)
+	{
+		const T m00 = affine.m00, m01 = affine.m01;
+		const T m10 = affine.m10, m11 = affine.m11;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const T x = vectors[i].x, y = vectors[i].y;
+			result[i].x = x * m00 + y * m10;
+			result[i].y = x * m01 + y * m11;
+		}
+	}
+
+	// affine types
+
+	typedef affine2_t<float> affine2;
+	typedef affine2_t<double> daffine2;
+}
@@ -0,0 +1,221 @@
+/// Copyright (c) Vito Domenico Tagliente
+
+#pragma once
+#pragma warning(disable : 4201)
+
+#include <cassert>
+#include <cstddef>
+
+#include "matrix3.h"
+#include "matrix4.h"
+#include "vector3.h"
+
+namespace math
+{
+	// 3D affine transformation without the constant row of matrix4,
+	// 12 elements instead of 16
+	// it is stored as 3 rows of 4 columns, each row produces one
+	// coordinate: p' = (m00 * x + m01 * y + m02 * z + m03, ...)
+	// that is the transpose of the upper 4x3 of the equivalent matrix4,
+	// the same layout of the float3x4 shader types
+	// the products keep the order of matrix4: affine3(a * b) == affine3(a) * affine3(b)
+	template <typename T>
+	struct affine3_t
+	{
+		static const affine3_t identity;
+
+		// num of rows
+		static constexpr std::size_t rows = 3;
+		// num of columns
+		static constexpr std::size_t columns = 4;
+		// matrix size
+		static constexpr std::size_t length = 3 * 4;
+
+		// matrix data
+		union
+		{
+			struct
+			{
+				T m00, m01, m02, m03;
+				T m10, m11, m12, m13;
+				T m20, m21, m22, m23;
+			};
+
+			T data[3 * 4];
+		};
+
+		affine3_t()
+			: m00(1), m01(), m02(), m03()
+			, m10(), m11(1), m12(), m13()
+			, m20(), m21(), m22(1), m23()
+		{
+
+		}
+
+		affine3_t(
+			const T m00, const T m01, const T m02, const T m03,
+			const T m10, const T m11, const T m12, const T m13,
+			const T m20, const T m21, const T m22, const T m23
+		) :
+			m00(m00), m01(m01), m02(m02), m03(m03),
+			m10(m10), m11(m11), m12(m12), m13(m13),
+			m20(m20), m21(m21), m22(m22), m23(m23)
+		{
+
+		}
+
+		// the last column of the matrix is assumed to be (0, 0, 0, 1)
+		explicit affine3_t(const matrix4_t<T>& m)
+			: m00(m.m00), m01(m.m10), m02(m.m20), m03(m.m30)
+			, m10(m.m01), m11(m.m11), m12(m.m21), m13(m.m31)
+			, m20(m.m02), m21(m.m12), m22(m.m22), m23(m.m32)
+		{
+
+		}
+
+		// precision conversion
+		template <typename U>
+		explicit affine3_t(const affine3_t<U>& affine)
+			: data()
+		{
+			for (unsigned int i = 0; i < length; i++)
+				data[i] = static_cast<T>(affine.data[i]);
+		}
+
+		affine3_t(const affine3_t& affine) = default;
+
+		vector3_t<T> translation() const
+		{
+			return vector3_t<T>(m03, m13, m23);
+		}
+
+		// transform a point, the translation is applied
+		vector3_t<T> transform_point(const vector3_t<T>& point) const
+		{
+			return vector3_t<T>(
+				m00 * point.x + m01 * point.y + m02 * point.z + m03,
+				m10 * point.x + m11 * point.y + m12 * point.z + m13,
+				m20 * point.x + m21 * point.y + m22 * point.z + m23
+			);
+		}
+
+		// transform a direction, the translation is ignored
+		vector3_t<T> transform_vector(const vector3_t<T>& vector) const
+		{
+			return vector3_t<T>(
+				m00 * vector.x + m01 * vector.y + m02 * vector.z,
+				m10 * vector.x + m11 * vector.y + m12 * vector.z,
+				m20 * vector.x + m21 * vector.y + m22 * vector.z
+			);
+		}
+
+		// determinant of the linear part
+		T determinant() const
+		{
+			return m00 * (m11 * m22 - m12 * m21)
+				+ m01 * (m12 * m20 - m10 * m22)
+				+ m02 * (m10 * m21 - m11 * m20);
+		}
+
+		affine3_t inverse(bool& is_invertible) const
+		{
+			const matrix3_t<T> linear(
+				m00, m01, m02,
+				m10, m11, m12,
+				m20, m21, m22
+			);
+			const matrix3_t<T> i = linear.inverse(is_invertible);
+			if (!is_invertible)
+			{
+				return *this;
+			}
+
+			const vector3_t<T> t = -(i * translation());
+			return affine3_t(
+				i.m00, i.m01, i.m02, t.x,
+				i.m10, i.m11, i.m12, t.y,
+				i.m20, i.m21, i.m22, t.z
+			);
+		}
+
+		static affine3_t translate(const vector3_t<T>& vector)
+		{
+			affine3_t result;
+			result.m03 = vector.x;
+			result.m13 = vector.y;
+			result.m23 = vector.z;
+			return result;
+		}
+
+		static affine3_t scale(const vector3_t<T>& vector)
+		{
+			affine3_t result;
+			result.m00 = vector.x;
+			result.m11 = vector.y;
+			result.m22 = vector.z;
+			return result;
+		}
+
+		/* Operators overloading */
+
+		affine3_t& operator= (const affine3_t& affine) = default;
+
+		bool operator== (const affine3_t& affine) const
+		{
+			for (unsigned int i = 0; i < length; i++)
+				if (data[i] != affine.data[i]) return false;
+			return true;
+		}
+
+		bool operator!= (const affine3_t& affine) const
+		{
+			return !(*this == affine);
+		}
+
+		// compose, the result applies this transformation first
+		// then the other one, as for matrix4 products
+		affine3_t operator* (const affine3_t& affine) const
+		{
+			affine3_t result;
+			for (unsigned int r = 0; r < rows; ++r)
+			{
+				const T* const b = affine.data + r * columns;
+				for (unsigned int c = 0; c < columns; ++c)
+				{
+					result.data[r * columns + c] = b[0] * data[c] + b[1] * data[columns + c] + b[2] * data[2 * columns + c];
+				}
+				result.data[r * columns + 3] += b[3];
+			}
+			return result;
+		}
+
+		affine3_t& operator*= (const affine3_t& affine)
+		{
+			return *this = *this * affine;
+		}
+
+		vector3_t<T> operator* (const vector3_t<T>& point) const
+		{
+			return transform_point(point);
+		}
+	};
+
+	template<typename T> const affine3_t<T> affine3_t<T>::identity = affine3_t<T>();
+
+	// the equivalent matrix4 in the row vector convention of the library
+	template <typename T>
+	inline matrix4_t<T> to_matrix4(const affine3_t<T>& a)
+	{
+		return matrix4_t<T>(
+			a.m00, a.m10, a.m20, 0,
+			a.m01, a.m11, a.m21, 0,
+			a.m02, a.m12, a.m22, 0,
+			a.m03, a.m13, a.m23, 1
+		);
+	}
+
+	// affine types
+
+	typedef affine3_t<float> affine3;
+	typedef affine3_t<double> daffine3;
+}
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <random>
+#include <type_traits>
 
 namespace math
 {
@@ -21,9 +22,23 @@ namespace math
 		return t_theta * rad2deg_factor;
 	}
 
+	// the conversions in the precision of the double and fixed point types,
+	// the integers are converted to float as before
+	template <typename T, typename = std::enable_if_t<!std::is_integral_v<T>>>
+	inline T radians(const T t_theta)
+	{
+		return t_theta * static_cast<T>(3.14159265358979323846) / static_cast<T>(180);
+	}
+
+	template <typename T, typename = std::enable_if_t<!std::is_integral_v<T>>>
+	inline T degrees(const T t_theta)
+	{
+		return t_theta * static_cast<T>(180) / static_cast<T>(3.14159265358979323846);
+	}
+
 	template <typename T>
 	T lerp(const T& t_a, const T& t_b, const float t_time) {
-		return (1.0f - t_time) * t_a + t_b * t_time;
+		return t_a * (1.0f - t_time) + t_b * t_time;
 	}
 
 	template <typename T>
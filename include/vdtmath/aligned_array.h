@@ -0,0 +1,301 @@
+/// Copyright (c) Vito Domenico Tagliente
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace math
+{
+	// alignment of the library containers, a cache line,
+	// it covers the widest simd register (avx512)
+	constexpr std::size_t cache_line_size = 64;
+
+	inline bool is_aligned(const void* pointer, const std::size_t alignment)
+	{
+		assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+		return (reinterpret_cast<std::uintptr_t>(pointer) & (alignment - 1)) == 0;
+	}
+
+	// the returned memory must be released with aligned_free
+	// using the same alignment
+	inline void* aligned_malloc(const std::size_t size, const std::size_t alignment)
+	{
+		return ::operator new(size, std::align_val_t(alignment));
+	}
+
+	inline void aligned_free(void* pointer, const std::size_t alignment)
+	{
+		::operator delete(pointer, std::align_val_t(alignment));
+	}
+
+	// allocator for the std containers,
+	// std::vector<matrix4, aligned_allocator<matrix4>>
+	template <typename T, std::size_t Alignment = cache_line_size>
+	struct aligned_allocator
+	{
+		static_assert((Alignment & (Alignment - 1)) == 0, "the alignment must be a power of two");
+		static_assert(Alignment >= alignof(T), "the alignment is less than the alignment of the type");
+
+		typedef T value_type;
+
+		template <typename U>
+		struct rebind
+		{
+			typedef aligned_allocator<U, Alignment> other;
+		};
+
+		aligned_allocator() = default;
+
+		template <typename U>
+		aligned_allocator(const aligned_allocator<U, Alignment>&)
+		{
+
+		}
+
+		T* allocate(const std::size_t count)
+		{
+			return static_cast<T*>(aligned_malloc(count * sizeof(T), Alignment));
+		}
+
+		void deallocate(T* pointer, const std::size_t)
+		{
+			aligned_free(pointer, Alignment);
+		}
+
+		template <typename U>
+		bool operator== (const aligned_allocator<U, Alignment>&) const
+		{
+			return true;
+		}
+
+		template <typename U>
+		bool operator!= (const aligned_allocator<U, Alignment>&) const
+		{
+			return false;
+		}
+	};
+
+	// contiguous growable array of math types with aligned storage,
+	// the first element starts on an Alignment boundary so that the
+	// batch kernels take their aligned paths, see kernels.h
+	// the elements must be trivially copyable, they are relocated
+	// with memcpy when the array grows
+	template <typename T, std::size_t Alignment = cache_line_size>
+	class aligned_array
+	{
+	public:
+
+		static_assert((Alignment & (Alignment - 1)) == 0, "the alignment must be a power of two");
+		static_assert(Alignment >= alignof(T), "the alignment is less than the alignment of the type");
+		static_assert(std::is_trivially_copyable<T>::value, "aligned_array supports trivially copyable types");
+
+		typedef T value_type;
+		typedef T* iterator;
+		typedef const T* const_iterator;
+
+		static constexpr std::size_t alignment = Alignment;
+
+		aligned_array()
+			: m_data(nullptr)
+			, m_size(0)
+			, m_capacity(0)
+		{
+
+		}
+
+		explicit aligned_array(const std::size_t size, const T& value = T())
+			: aligned_array()
+		{
+			resize(size, value);
+		}
+
+		aligned_array(const T* values, const std::size_t count)
+			: aligned_array()
+		{
+			assign(values, count);
+		}
+
+		aligned_array(std::initializer_list<T> values)
+			: aligned_array()
+		{
+			assign(values.begin(), values.size());
+		}
+
+		aligned_array(const aligned_array& other)
+			: aligned_array()
+		{
+			assign(other.m_data, other.m_size);
+		}
+
+		aligned_array(aligned_array&& other) noexcept
+			: m_data(other.m_data)
+			, m_size(other.m_size)
+			, m_capacity(other.m_capacity)
+		{
+			other.m_data = nullptr;
+			other.m_size = other.m_capacity = 0;
+		}
+
+		~aligned_array()
+		{
+			if (m_data)
+			{
+				aligned_free(m_data, Alignment);
+			}
+		}
+
+		T* data() { return m_data; }
+		const T* data() const { return m_data; }
+
+		std::size_t size() const { return m_size; }
+		std::size_t capacity() const { return m_capacity; }
+		bool empty() const { return m_size == 0; }
+
+		iterator begin() { return m_data; }
+		iterator end() { return m_data + m_size; }
+		const_iterator begin() const { return m_data; }
+		const_iterator end() const { return m_data + m_size; }
+
+		T& front() { assert(m_size > 0); return m_data[0]; }
+		const T& front() const { assert(m_size > 0); return m_data[0]; }
+		T& back() { assert(m_size > 0); return m_data[m_size - 1]; }
+		const T& back() const { assert(m_size > 0); return m_data[m_size - 1]; }
+
+		void reserve(const std::size_t capacity)
+		{
+			if (capacity <= m_capacity) return;
+
+			T* const data = static_cast<T*>(aligned_malloc(capacity * sizeof(T), Alignment));
+			if (m_data)
+			{
+				std::memcpy(static_cast<void*>(data), m_data, m_size * sizeof(T));
+				aligned_free(m_data, Alignment);
+			}
+			m_data = data;
+			m_capacity = capacity;
+		}
+
+		void resize(const std::size_t size, const T& value = T())
+		{
+			reserve(size);
+			for (std::size_t i = m_size; i < size; ++i)
+			{
+				new (m_data + i) T(value);
+			}
+			m_size = size;
+		}
+
+		void assign(const T* values, const std::size_t count)
+		{
+			reserve(count);
+			if (count > 0)
+			{
+				std::memmove(static_cast<void*>(m_data), values, count * sizeof(T));
+			}
+			m_size = count;
+		}
+
+		void push_back(const T& value)
+		{
+			if (m_size == m_capacity)
+			{
+				// copied first, the value can live in the array
+				const T copy = value;
+				grow(m_size + 1);
+				new (m_data + m_size++) T(copy);
+				return;
+			}
+			new (m_data + m_size++) T(value);
+		}
+
+		template <typename... Args>
+		T& emplace_back(Args&&... args)
+		{
+			if (m_size == m_capacity)
+			{
+				grow(m_size + 1);
+			}
+			return *new (m_data + m_size++) T(std::forward<Args>(args)...);
+		}
+
+		void pop_back()
+		{
+			assert(m_size > 0);
+			--m_size;
+		}
+
+		// the storage is kept for the next frame
+		void clear()
+		{
+			m_size = 0;
+		}
+
+		// release the unused capacity
+		void shrink_to_fit()
+		{
+			if (m_size == m_capacity) return;
+
+			aligned_array other(m_data, m_size);
+			swap(other);
+		}
+
+		void swap(aligned_array& other) noexcept
+		{
+			std::swap(m_data, other.m_data);
+			std::swap(m_size, other.m_size);
+			std::swap(m_capacity, other.m_capacity);
+		}
+
+		/* Operators overloading */
+
+		aligned_array& operator= (const aligned_array& other)
+		{
+			if (this != &other)
+			{
+				assign(other.m_data, other.m_size);
+			}
+			return *this;
+		}
+
+		aligned_array& operator= (aligned_array&& other) noexcept
+		{
+			aligned_array moved(std::move(other));
+			swap(moved);
+			return *this;
+		}
+
+		T& operator[] (const std::size_t i)
+		{
+			assert(i < m_size);
+			return m_data[i];
+		}
+
+		const T& operator[] (const std::size_t i) const
+		{
+			assert(i < m_size);
+			return m_data[i];
+		}
+
+	private:
+
+		void grow(const std::size_t size)
+		{
+			// the first allocation fills at least a cache line
+			const std::size_t minimum = (cache_line_size + sizeof(T) - 1) / sizeof(T);
+			std::size_t capacity = m_capacity > 0 ? m_capacity * 2 : minimum;
+			if (capacity < size) capacity = size;
+			reserve(capacity);
+		}
+
+		T* m_data;
+		std::size_t m_size;
+		std::size_t m_capacity;
+	};
+}
@@ -0,0 +1,346 @@
+/// Copyright (c) Vito Domenico Tagliente
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <type_traits>
+#include <vector>
+
+#include "affine3.h"
+#include "aligned_array.h"
+#include "config.h"
+#include "matrix_n.h"
+#include "quaternion.h"
+#include "rectangle.h"
+#include "vector_n.h"
+
+namespace math
+{
+	// binary format for arrays of math types
+	//
+	//     blob_header     64 bytes at offset 0
+	//     arrays          each one on a blob_alignment boundary
+	//     blob_array      one entry per array, at header.table_offset
+	//
+	// the elements keep their in memory layout and the byte order of
+	// the writer, that the header records: a blob with the native byte
+	// order is used in place through blob_view, over a mapped_file
+	// for instance, the other ones are read by blob_reader that swaps
+	// the scalars
+	// the table is at the end so that blob_writer streams the arrays
+	// without knowing their size in advance, and blob_reader reads
+	// ranges of elements, so the files can be larger than the memory
+
+	constexpr std::uint32_t blob_version = 1;
+	constexpr std::size_t blob_alignment = cache_line_size;
+	constexpr std::size_t blob_name_size = 32;
+
+	struct blob_header
+	{
+		// "VDTM"
+		char magic[4];
+		// 0x01020304 in the byte order of the writer
+		std::uint32_t endian;
+		std::uint32_t version;
+		std::uint32_t array_count;
+		std::uint64_t table_offset;
+		// size of the whole blob in bytes
+		std::uint64_t size;
+		std::uint8_t reserved[32];
+	};
+
+	struct blob_array
+	{
+		// null terminated
+		char name[blob_name_size];
+		// see blob_type
+		std::uint32_t type;
+		std::uint32_t element_size;
+		std::uint32_t scalar_size;
+		std::uint32_t reserved;
+		std::uint64_t count;
+		// from the start of the blob
+		std::uint64_t offset;
+	};
+
+	static_assert(sizeof(blob_header) == 64, "the blob header has a fixed size");
+	static_assert(sizeof(blob_array) == 64, "the blob table entries have a fixed size");
+
+	// identifies the layout of an element type, the scalar type tells
+	// float from double and is the unit of the byte swaps, so the elements
+	// must be made of scalars only
+	// it can be specialized for other types, with ids from 1024
+	template <typename T>
+	struct blob_type;
+
+	namespace detail
+	{
+		template <std::uint32_t Id, typename Scalar>
+		struct blob_type_base
+		{
+			static constexpr std::uint32_t id = Id;
+			typedef Scalar scalar_type;
+		};
+	}
+
+	template <> struct blob_type<float> : detail::blob_type_base<1, float> {};
+	template <> struct blob_type<double> : detail::blob_type_base<1, double> {};
+	template <typename T> struct blob_type<vector_t<T, 2>> : detail::blob_type_base<2, T> {};
+	template <typename T> struct blob_type<vector_t<T, 3>> : detail::blob_type_base<3, T> {};
+	template <typename T> struct blob_type<vector_t<T, 4>> : detail::blob_type_base<4, T> {};
+	template <typename T> struct blob_type<quaternion_t<T>> : detail::blob_type_base<5, T> {};
+	template <typename T> struct blob_type<matrix_t<T, 2, 2>> : detail::blob_type_base<6, T> {};
+	template <typename T> struct blob_type<matrix_t<T, 3, 3>> : detail::blob_type_base<7, T> {};
+	template <typename T> struct blob_type<matrix_t<T, 4, 4>> : detail::blob_type_base<8, T> {};
+	template <typename T> struct blob_type<rectangle_t<T>> : detail::blob_type_base<9, T> {};
+	template <typename T> struct blob_type<affine3_t<T>> : detail::blob_type_base<10, T> {};
+
+	namespace detail
+	{
+		template <typename T>
+		inline bool blob_matches(const blob_array& array)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "the blob elements must be trivially copyable");
+			return array.type == blob_type<T>::id
+				&& array.element_size == sizeof(T)
+				&& array.scalar_size == sizeof(typename blob_type<T>::scalar_type);
+		}
+
+		// index of the array with the given name, count when missing
+		VDTMATH_API std::size_t blob_find(const blob_array* arrays, const std::size_t count, const char* name);
+
+		// reverse the bytes of each scalar
+		VDTMATH_API void swap_bytes(void* data, const std::size_t size, const std::size_t scalar_size);
+	}
+
+	// streaming writer
+	//
+	//     blob_writer writer;
+	//     writer.open("level.blob");
+	//     writer.write("positions", positions.data(), positions.size());
+	//     writer.begin<matrix4>("bones");
+	//     while (...) writer.append(chunk, chunkSize);
+	//     writer.end();
+	//     writer.close();
+	class blob_writer
+	{
+	public:
+
+		VDTMATH_API blob_writer();
+		// the blob is completed if it is still open
+		VDTMATH_API ~blob_writer();
+
+		blob_writer(const blob_writer&) = delete;
+		blob_writer& operator= (const blob_writer&) = delete;
+
+		VDTMATH_API bool open(const char* path);
+
+		// write the table and the header, the return value
+		// is false if any write failed
+		VDTMATH_API bool close();
+
+		bool is_open() const
+		{
+			return m_file != nullptr;
+		}
+
+		template <typename T>
+		bool write(const char* name, const T* values, const std::size_t count)
+		{
+			return begin<T>(name) && append(values, count) && end();
+		}
+
+		// start an array, the name must be shorter than blob_name_size
+		template <typename T>
+		bool begin(const char* name)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "the blob elements must be trivially copyable");
+			return begin_array(name, blob_type<T>::id, sizeof(T), sizeof(typename blob_type<T>::scalar_type));
+		}
+
+		// add elements to the array started by begin
+		template <typename T>
+		bool append(const T* values, const std::size_t count)
+		{
+			assert(m_inArray && detail::blob_matches<T>(m_arrays.back()));
+			return append_bytes(values, count * sizeof(T));
+		}
+
+		VDTMATH_API bool end();
+
+	private:
+
+		VDTMATH_API bool begin_array(const char* name, const std::uint32_t type, const std::uint32_t elementSize, const std::uint32_t scalarSize);
+		VDTMATH_API bool append_bytes(const void* data, const std::size_t size);
+		VDTMATH_API bool write_bytes(const void* data, const std::size_t size);
+		VDTMATH_API bool pad();
+
+		std::FILE* m_file;
+		std::vector<blob_array> m_arrays;
+		std::uint64_t m_offset;
+		bool m_inArray;
+		bool m_failed;
+	};
+
+	// streaming reader, the elements are read by ranges
+	class blob_reader
+	{
+	public:
+
+		VDTMATH_API blob_reader();
+		VDTMATH_API ~blob_reader();
+
+		blob_reader(const blob_reader&) = delete;
+		blob_reader& operator= (const blob_reader&) = delete;
+
+		// read and validate the header and the table
+		VDTMATH_API bool open(const char* path);
+		VDTMATH_API void close();
+
+		bool is_open() const
+		{
+			return m_file != nullptr;
+		}
+
+		// the blob was written with the other byte order
+		bool swapped() const
+		{
+			return m_swapped;
+		}
+
+		std::size_t array_count() const
+		{
+			return m_arrays.size();
+		}
+
+		const blob_array& array(const std::size_t index) const
+		{
+			assert(index < m_arrays.size());
+			return m_arrays[index];
+		}
+
+		// array_count() when missing
+		std::size_t find(const char* name) const
+		{
+			return detail::blob_find(m_arrays.data(), m_arrays.size(), name);
+		}
+
+		// read count elements starting from first, false if the
+		// element type does not match the array or the read fails
+		template <typename T>
+		bool read(const std::size_t index, const std::uint64_t first, const std::size_t count, T* values)
+		{
+			if (index >= m_arrays.size() || !detail::blob_matches<T>(m_arrays[index])) return false;
+			return read_elements(index, first, count, values);
+		}
+
+		// read a whole array
+		template <typename T, std::size_t Alignment>
+		bool read(const std::size_t index, aligned_array<T, Alignment>& values)
+		{
+			if (index >= m_arrays.size() || !detail::blob_matches<T>(m_arrays[index])) return false;
+			values.resize(static_cast<std::size_t>(m_arrays[index].count));
+			return read_elements(index, 0, values.size(), values.data());
+		}
+
+	private:
+
+		VDTMATH_API bool read_elements(const std::size_t index, const std::uint64_t first, const std::size_t count, void* values);
+
+		std::FILE* m_file;
+		std::vector<blob_array> m_arrays;
+		bool m_swapped;
+	};
+
+	// zero copy access to a blob in memory, the memory must outlive
+	// the view and start on a blob_alignment boundary for the arrays
+	// to be aligned, blobs with the other byte order are rejected
+	class blob_view
+	{
+	public:
+
+		VDTMATH_API blob_view();
+
+		// validate the header and the table
+		VDTMATH_API bool open(const void* data, const std::size_t size);
+
+		std::size_t array_count() const
+		{
+			return m_count;
+		}
+
+		const blob_array& array(const std::size_t index) const
+		{
+			assert(index < m_count);
+			return m_arrays[index];
+		}
+
+		// array_count() when missing
+		std::size_t find(const char* name) const
+		{
+			return detail::blob_find(m_arrays, m_count, name);
+		}
+
+		// nullptr if the element type does not match the array
+		template <typename T>
+		const T* data(const std::size_t index, std::size_t& count) const
+		{
+			count = 0;
+			if (index >= m_count || !detail::blob_matches<T>(m_arrays[index])) return nullptr;
+			count = static_cast<std::size_t>(m_arrays[index].count);
+			return reinterpret_cast<const T*>(m_data + m_arrays[index].offset);
+		}
+
+		template <typename T>
+		const T* data(const char* name, std::size_t& count) const
+		{
+			return data<T>(find(name), count);
+		}
+
+	private:
+
+		const unsigned char* m_data;
+		const blob_array* m_arrays;
+		std::size_t m_count;
+	};
+
+	// read only mapping of a whole file, page aligned
+	class mapped_file
+	{
+	public:
+
+		VDTMATH_API mapped_file();
+		VDTMATH_API ~mapped_file();
+
+		mapped_file(const mapped_file&) = delete;
+		mapped_file& operator= (const mapped_file&) = delete;
+
+		VDTMATH_API bool open(const char* path);
+		VDTMATH_API void close();
+
+		const void* data() const
+		{
+			return m_data;
+		}
+
+		std::size_t size() const
+		{
+			return m_size;
+		}
+
+	private:
+
+		const void* m_data;
+		std::size_t m_size;
+#if defined(_WIN32)
+		void* m_mapping;
+#endif
+	};
+}
+
+#if defined(VDTMATH_HEADER_ONLY)
+#include "../../source/blob.cpp"
+#endif
@@ -0,0 +1,139 @@
+/// Copyright (c) Vito Domenico Tagliente
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+#include "deterministic.h"
+#include "matrix4.h"
+#include "vector3.h"
+#include "vector4.h"
+
+namespace math
+{
+	// view and projection matrices in the conventions of matrix4:
+	// row vectors, right handed, the camera looks down -z
+	//
+	//     perspective                     depth in [-1, 1], see matrix4
+	//     perspective_infinite            depth in [-1, 1], no far plane
+	//     perspective_reverse_z           depth from 1 at near to 0 at far
+	//     perspective_infinite_reverse_z  depth from 1 at near to 0 at infinity
+	//
+	// the reverse z projections spread the float precision of a [0, 1]
+	// depth buffer evenly over the distance, the infinite ones never clip
+	// the far geometry, the fov is vertical and in radians
+	// frustum_planes takes clip_depth::one_to_zero for the reverse z ones
+
+	template <typename T>
+	inline matrix4_t<T> look_at(const vector3_t<T>& eye, const vector3_t<T>& target, const vector3_t<T>& up)
+	{
+		vector3_t<T> f = target - eye;
+		f.normalize();
+		vector3_t<T> s = f.cross(up);
+		s.normalize();
+		const vector3_t<T> u = s.cross(f);
+
+		return matrix4_t<T>(
+			s.x, u.x, -f.x, static_cast<T>(0.0),
+			s.y, u.y, -f.y, static_cast<T>(0.0),
+			s.z, u.z, -f.z, static_cast<T>(0.0),
+			-s.dot(eye), -u.dot(eye), f.dot(eye), static_cast<T>(1.0)
+		);
+	}
+
+	namespace detail
+	{
+		// clip z = a * z + b, clip w = -z
+		template <typename T>
+		inline matrix4_t<T> perspective_depth(const T fov, const T aspect, const T a, const T b)
+		{
+			const T f = static_cast<T>(1.0) / static_cast<T>(detail::tan(fov / static_cast<T>(2.0)));
+			matrix4_t<T> m = matrix4_t<T>::zero;
+			m.m00 = f / aspect;
+			m.m11 = f;
+			m.m22 = a;
+			m.m23 = -static_cast<T>(1.0);
+			m.m32 = b;
+			return m;
+		}
+	}
+
+	template <typename T>
+	inline matrix4_t<T> perspective_infinite(const T fov, const T aspect, const T near_plane)
+	{
+		return detail::perspective_depth(fov, aspect, -static_cast<T>(1.0), -static_cast<T>(2.0) * near_plane);
+	}
+
+	template <typename T>
+	inline matrix4_t<T> perspective_reverse_z(const T fov, const T aspect, const T near_plane, const T far_plane)
+	{
+		const T a = near_plane / (far_plane - near_plane);
+		return detail::perspective_depth(fov, aspect, a, a * far_plane);
+	}
+
+	template <typename T>
+	inline matrix4_t<T> perspective_infinite_reverse_z(const T fov, const T aspect, const T near_plane)
+	{
+		return detail::perspective_depth(fov, aspect, static_cast<T>(0.0), near_plane);
+	}
+
+	// view, projection and viewport with their products cached when set,
+	// so that project and unproject are a matrix product and a division
+	// instead of an inversion per call as matrix4::unproject
+	// the viewport is (x, y, width, height) and the depth of the screen
+	// points is the depth of the projection, as matrix4::unproject
+	// the members are defined in camera.cpp, instantiated for float and double
+	template <typename T>
+	class camera_t
+	{
+	public:
+
+		camera_t();
+
+		inline const matrix4_t<T>& view() const { return m_view; }
+		inline const matrix4_t<T>& projection() const { return m_projection; }
+		inline const vector4_t<T>& viewport() const { return m_viewport; }
+		inline const matrix4_t<T>& view_projection() const { return m_viewProjection; }
+		inline const matrix4_t<T>& inverse_view_projection() const { return m_inverseViewProjection; }
+		// false for a singular view projection, unproject is then meaningless
+		inline bool is_invertible() const { return m_isInvertible; }
+
+		void set_view(const matrix4_t<T>& view);
+		void look_at(const vector3_t<T>& eye, const vector3_t<T>& target, const vector3_t<T>& up);
+		void set_projection(const matrix4_t<T>& projection);
+		void set_viewport(const vector4_t<T>& viewport);
+
+		// world to screen
+		vector3_t<T> project(const vector3_t<T>& point) const;
+		// screen to world
+		vector3_t<T> unproject(const vector3_t<T>& point) const;
+
+		// the batch kernel of the active simd level for float, see kernels.h
+		void project(const vector3_t<T>* points, vector3_t<T>* result, const std::size_t count) const;
+		void unproject(const vector3_t<T>* points, vector3_t<T>* result, const std::size_t count) const;
+
+	private:
+
+		void update();
+
+		matrix4_t<T> m_view;
+		matrix4_t<T> m_projection;
+		vector4_t<T> m_viewport;
+		matrix4_t<T> m_viewProjection;
+		matrix4_t<T> m_inverseViewProjection;
+		// with the viewport mapping
+		matrix4_t<T> m_screen;
+		matrix4_t<T> m_inverseScreen;
+		bool m_isInvertible;
+	};
+
+	// camera types
+
+	typedef camera_t<float> camera;
+	typedef camera_t<double> dcamera;
+}
+
+#if defined(VDTMATH_HEADER_ONLY)
+#include "../../source/camera.cpp"
+#endif
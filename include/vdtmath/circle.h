@@ -1,6 +1,11 @@
 /// Copyright (c) Vito Domenico Tagliente
 #pragma once 
 
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "mask.h"
 #include "vector2.h"
 
 namespace math
@@ -18,7 +23,7 @@ namespace math
 			T data[3];
 		};
 
-		const std::size_t length = 3;
+		static constexpr std::size_t length = 3;
 
 		circle_t()
 			: x()
@@ -42,21 +47,19 @@ namespace math
 
 		}
 
-		circle_t(const circle_t& circle)
-			: x(circle.x)
-			, y(circle.y)
-			, radius(circle.radius)
+		// precision conversion
+		template <typename U>
+		explicit circle_t(const circle_t<U>& circle)
+			: x(static_cast<T>(circle.x))
+			, y(static_cast<T>(circle.y))
+			, radius(static_cast<T>(circle.radius))
 		{
 
 		}
 
-		circle_t& operator= (const circle_t& other)
-		{
-			x = other.x;
-			y = other.y;
-			radius = other.radius;
-			return *this;
-		}
+		// trivial, the arrays of circles are copied in bulk
+		circle_t(const circle_t& circle) = default;
+		circle_t& operator= (const circle_t& other) = default;
 
 		bool operator== (const circle_t& circle) const
 		{
@@ -72,7 +75,7 @@ namespace math
 		{
 			const T deltaX = x - circle.x;
 			const T deltaY = y - circle.y;
-			return static_cast<T>(sqrt(deltaX * deltaX + deltaY * deltaY)) <= radius
+			return deltaX * deltaX + deltaY * deltaY <= radius * radius
 				&& circle.radius <= radius;
 		}
 
@@ -81,18 +84,128 @@ namespace math
 		{
 			const T deltaX = x - point.x;
 			const T deltaY = y - point.y;
-			return static_cast<T>(sqrt(deltaX * deltaX + deltaY * deltaY)) <= radius;
+			return deltaX * deltaX + deltaY * deltaY <= radius * radius;
 		}
 
 		bool intersects(const circle_t& circle) const
 		{
 			const T deltaX = x - circle.x;
 			const T deltaY = y - circle.y;
-			return static_cast<T>(sqrt(deltaX * deltaX + deltaY * deltaY)) <= (radius + circle.radius);
+			const T sum = radius + circle.radius;
+			return deltaX * deltaX + deltaY * deltaY <= sum * sum;
+		}
+
+		// batch tests against arrays of circles or points
+		// the mask receives one bit per element, see mask_size,
+		// the return value is the number of hits,
+		// the float circles run the simd kernels of mask.h
+		std::size_t intersects(const circle_t* circles, const std::size_t count, std::uint8_t* mask) const
+		{
+			if constexpr (std::is_same<T, float>::value)
+			{
+				return detail::circle_intersects_circles(data, reinterpret_cast<const float*>(circles), count, mask);
+			}
+			else
+			{
+				return detail::test_mask(count, mask, [this, circles](const std::size_t i)
+					{
+						return intersects(circles[i]);
+					});
+			}
+		}
+
+		std::size_t contains(const circle_t* circles, const std::size_t count, std::uint8_t* mask) const
+		{
+			if constexpr (std::is_same<T, float>::value)
+			{
+				return detail::circle_contains_circles(data, reinterpret_cast<const float*>(circles), count, mask);
+			}
+			else
+			{
+				return detail::test_mask(count, mask, [this, circles](const std::size_t i)
+					{
+						return contains(circles[i]);
+					});
+			}
+		}
+
+		std::size_t contains(const vector2_t<T>* points, const std::size_t count, std::uint8_t* mask) const
+		{
+			if constexpr (std::is_same<T, float>::value)
+			{
+				return detail::circle_contains_points(data, reinterpret_cast<const float*>(points), count, mask);
+			}
+			else
+			{
+				return detail::test_mask(count, mask, [this, points](const std::size_t i)
+					{
+						return contains(points[i]);
+					});
+			}
+		}
+
+		// batch tests writing the indices of the hits, 
+		// indices must have room for count elements
+		std::size_t intersects(const circle_t* circles, const std::size_t count, std::uint32_t* indices) const
+		{
+			if constexpr (std::is_same<T, float>::value)
+			{
+				return detail::kernel_indices(count, indices, [this, circles](const std::size_t first, const std::size_t size, std::uint8_t* mask)
+					{
+						return intersects(circles + first, size, mask);
+					});
+			}
+			else
+			{
+				return detail::test_indices(count, indices, [this, circles](const std::size_t i)
+					{
+						return intersects(circles[i]);
+					});
+			}
+		}
+
+		std::size_t contains(const circle_t* circles, const std::size_t count, std::uint32_t* indices) const
+		{
+			if constexpr (std::is_same<T, float>::value)
+			{
+				return detail::kernel_indices(count, indices, [this, circles](const std::size_t first, const std::size_t size, std::uint8_t* mask)
+					{
+						return contains(circles + first, size, mask);
+					});
+			}
+			else
+			{
+				return detail::test_indices(count, indices, [this, circles](const std::size_t i)
+					{
+						return contains(circles[i]);
+					});
+			}
+		}
+
+		std::size_t contains(const vector2_t<T>* points, const std::size_t count, std::uint32_t* indices) const
+		{
+			if constexpr (std::is_same<T, float>::value)
+			{
+				return detail::kernel_indices(count, indices, [this, points](const std::size_t first, const std::size_t size, std::uint8_t* mask)
+					{
+						return contains(points + first, size, mask);
+					});
+			}
+			else
+			{
+				return detail::test_indices(count, indices, [this, points](const std::size_t i)
+					{
+						return contains(points[i]);
+					});
+			}
 		}
 	};
 
 	// circle types
 
 	typedef circle_t<float> circle;
+	typedef circle_t<double> dcircle;
+
+	static_assert(std::is_trivially_copyable<circle>::value && std::is_trivially_copyable<dcircle>::value, "the circle arrays are copied in bulk and stored in blobs");
+	static_assert(sizeof(circle) == 3 * sizeof(float) && sizeof(vector2) == 2 * sizeof(float), "the simd kernels read packed circles and points");
 }
\ No newline at end of file
@@ -0,0 +1,19 @@
+/// Copyright (c) Vito Domenico Tagliente
+
+#pragma once
+
+// in header only mode the sources are included by the headers, 
+// the non template functions they define become inline
+#if defined(VDTMATH_HEADER_ONLY)
+#define VDTMATH_API inline
+#else
+#define VDTMATH_API
+#endif
+
+// the instrumentation hooks of profile.h, compiled out
+// without VDTMATH_PROFILE
+#if !defined(VDTMATH_PROFILE)
+#define VDTMATH_PROFILE_COUNT(counter, value) ((void)0)
+#define VDTMATH_PROFILE_SCOPE(name, count) ((void)0)
+#define VDTMATH_PROFILE_REBUILD() ((void)0)
+#endif
@@ -0,0 +1,51 @@
+/// Copyright (c) Vito Domenico Tagliente
+
+#pragma once
+
+#include "config.h"
+
+namespace math
+{
+	// instruction sets the batch kernels are specialized for
+	enum class simd_level
+	{
+		none,
+		sse2,
+		avx2,
+		avx512
+	};
+
+	struct cpu_features
+	{
+		bool sse2;
+		bool sse41;
+		bool avx;
+		bool avx2;
+		bool fma;
+		bool f16c;
+		bool avx512f;
+	};
+
+	// features of the running cpu, detected once at startup
+	VDTMATH_API const cpu_features& cpu();
+
+	// the best level supported by the cpu and the operating system
+	VDTMATH_API simd_level supported_simd_level();
+
+	// the level the batch kernels are bound to, by default the
+	// supported one or the value of the VDTMATH_SIMD environment
+	// variable (none, sse2, avx2, avx512) when it is set
+	// with VDTMATH_DETERMINISTIC the level is at most sse2, the kernels
+	// of the higher levels use fma and have different results
+	VDTMATH_API simd_level active_simd_level();
+
+	// bind the batch kernels to another level, used for testing
+	// return false if the level is not supported, leaving the binding as is
+	VDTMATH_API bool set_simd_level(const simd_level level);
+
+	VDTMATH_API const char* to_string(const simd_level level);
+}
+
+#if defined(VDTMATH_HEADER_ONLY)
+#include "../../source/cpu.cpp"
+#endif
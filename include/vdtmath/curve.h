@@ -0,0 +1,360 @@
+/// Copyright (c) Vito Domenico Tagliente
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "config.h"
+#include "quaternion.h"
+#include "vector_n.h"
+
+namespace math
+{
+	// keyframed animation curves over float, vector and quaternion channels
+	// the keys are stored as a structure of arrays: the times and, for
+	// each component, the values and the in/out tangents
+	// every interpolation is evaluated as a cubic hermite segment:
+	//     step         the value of the previous key
+	//     linear
+	//     hermite      the in/out tangents of the keys, in units per second
+	//     catmull_rom  tangents from the neighbour keys
+	//     bezier       the in/out control points of the keys, the curve
+	//                  parameter is uniform in time within a segment
+	// the curves are clamped to their first and last keys, looping is left
+	// to the caller
+	// quaternions are interpolated component-wise and normalized, the keys
+	// are flipped when added to stay in the hemisphere of the previous one
+
+	enum class interpolation
+	{
+		step,
+		linear,
+		hermite,
+		catmull_rom,
+		bezier
+	};
+
+	// the segment found by the last evaluation, one per channel and playback
+	// for a monotonic playback the next segment is found in constant time
+	struct curve_cursor
+	{
+		std::size_t segment = 0;
+	};
+
+	namespace detail
+	{
+		template <typename T>
+		struct curve_traits;
+
+		template <>
+		struct curve_traits<float>
+		{
+			static constexpr std::size_t components = 1;
+			static const float* data(const float& value) { return &value; }
+			static float* data(float& value) { return &value; }
+			static void finish(float&) {}
+		};
+
+		template <std::size_t N>
+		struct curve_traits<vector_t<float, N>>
+		{
+			static constexpr std::size_t components = N;
+			static const float* data(const vector_t<float, N>& value) { return value.data; }
+			static float* data(vector_t<float, N>& value) { return value.data; }
+			static void finish(vector_t<float, N>&) {}
+		};
+
+		template <>
+		struct curve_traits<quaternion>
+		{
+			static constexpr std::size_t components = 4;
+			static const float* data(const quaternion& value) { return value.data; }
+			static float* data(quaternion& value) { return value.data; }
+			static void finish(quaternion& value)
+			{
+				const float l = value.length();
+				if (l > 0.f) value /= l;
+			}
+		};
+	}
+
+	// value = h00 * p0 + h10 * m0 + h01 * p1 + h11 * m1 for every lane,
+	// the tangents are scaled by the segment duration
+	// the kernel of the active simd level, see cpu.h
+	VDTMATH_API void evaluate_hermite(const float* u, const float* p0, const float* m0, const float* p1, const float* m1, float* result, const std::size_t count);
+
+	template <typename T>
+	class curve_t
+	{
+	public:
+
+		typedef detail::curve_traits<T> traits;
+		static constexpr std::size_t components = traits::components;
+
+		explicit curve_t(const interpolation mode = interpolation::linear)
+			: m_mode(mode)
+		{
+
+		}
+
+		interpolation mode() const { return m_mode; }
+		std::size_t size() const { return m_times.size(); }
+		bool empty() const { return m_times.empty(); }
+
+		float start_time() const { assert(!empty()); return m_times.front(); }
+		float end_time() const { assert(!empty()); return m_times.back(); }
+
+		const float* times() const { return m_times.data(); }
+		const float* values(const std::size_t component) const { return m_values[component].data(); }
+
+		T value(const std::size_t key) const
+		{
+			T result;
+			float* const data = traits::data(result);
+			for (std::size_t c = 0; c < components; ++c)
+				data[c] = m_values[c][key];
+			return result;
+		}
+
+		void reserve(const std::size_t count)
+		{
+			m_times.reserve(count);
+			for (std::size_t c = 0; c < components; ++c)
+			{
+				m_values[c].reserve(count);
+				m_in[c].reserve(count);
+				m_out[c].reserve(count);
+			}
+		}
+
+		void clear()
+		{
+			m_times.clear();
+			for (std::size_t c = 0; c < components; ++c)
+			{
+				m_values[c].clear();
+				m_in[c].clear();
+				m_out[c].clear();
+			}
+		}
+
+		// the keys are added in increasing time
+		// zero tangents, or control points on the key for the bezier curves
+		void add_key(const float time, const T& value)
+		{
+			if (m_mode == interpolation::bezier)
+			{
+				add_key(time, value, value, value);
+				return;
+			}
+			T zero = value;
+			float* const data = traits::data(zero);
+			for (std::size_t c = 0; c < components; ++c)
+				data[c] = 0.f;
+			add_key(time, value, zero, zero);
+		}
+
+		// in and out are the tangents of the hermite curves
+		// or the control points of the bezier curves
+		void add_key(const float time, const T& value, const T& in, const T& out)
+		{
+			assert(empty() || time > m_times.back());
+			const float* const v = traits::data(value);
+			const float* const a = traits::data(in);
+			const float* const b = traits::data(out);
+
+			float sign = 1.f;
+			if (std::is_same<T, quaternion>::value && !empty())
+			{
+				// q and -q are the same rotation, take the nearest one
+				float dot = 0.f;
+				for (std::size_t c = 0; c < components; ++c)
+					dot += v[c] * m_values[c].back();
+				sign = dot < 0.f ? -1.f : 1.f;
+			}
+
+			m_times.push_back(time);
+			for (std::size_t c = 0; c < components; ++c)
+			{
+				m_values[c].push_back(v[c] * sign);
+				m_in[c].push_back(a[c] * sign);
+				m_out[c].push_back(b[c] * sign);
+			}
+		}
+
+		// binary search, for random access
+		T evaluate(const float time) const
+		{
+			curve_cursor cursor;
+			cursor.segment = search(time);
+			return evaluate(time, cursor);
+		}
+
+		T evaluate(const float time, curve_cursor& cursor) const
+		{
+			float u[components], p0[components], m0[components], p1[components], m1[components];
+			hermite_segment(time, cursor, u, p0, m0, p1, m1);
+
+			T result;
+			float* const data = traits::data(result);
+			for (std::size_t c = 0; c < components; ++c)
+			{
+				const float s = u[c], s2 = s * s, s3 = s2 * s;
+				data[c] = (2.f * s3 - 3.f * s2 + 1.f) * p0[c] + (s3 - 2.f * s2 + s) * m0[c]
+					+ (3.f * s2 - 2.f * s3) * p1[c] + (s3 - s2) * m1[c];
+			}
+			traits::finish(result);
+			return result;
+		}
+
+		// the cubic hermite form of the segment at time, one lane per component,
+		// used by the batch evaluation
+		void hermite_segment(const float time, curve_cursor& cursor, float* u, float* p0, float* m0, float* p1, float* m1) const
+		{
+			assert(!empty());
+			const std::size_t s = find(time, cursor);
+			const std::size_t n = m_times.size();
+			if (n == 1)
+			{
+				for (std::size_t c = 0; c < components; ++c)
+				{
+					u[c] = 0.f;
+					p0[c] = p1[c] = m_values[c][0];
+					m0[c] = m1[c] = 0.f;
+				}
+				return;
+			}
+
+			const float t0 = m_times[s], t1 = m_times[s + 1];
+			const float dt = t1 - t0;
+			const float t = std::min(std::max((time - t0) / dt, 0.f), 1.f);
+			for (std::size_t c = 0; c < components; ++c)
+			{
+				const std::vector<float>& v = m_values[c];
+				u[c] = t;
+				p0[c] = v[s];
+				p1[c] = v[s + 1];
+				switch (m_mode)
+				{
+				case interpolation::step:
+					// the last key is reached at the end of the curve
+					if (t < 1.f) p1[c] = p0[c];
+					else p0[c] = p1[c];
+					m0[c] = m1[c] = 0.f;
+					break;
+				case interpolation::linear:
+					m0[c] = m1[c] = p1[c] - p0[c];
+					break;
+				case interpolation::hermite:
+					m0[c] = m_out[c][s] * dt;
+					m1[c] = m_in[c][s + 1] * dt;
+					break;
+				case interpolation::catmull_rom:
+					m0[c] = neighbour_tangent(c, s) * dt;
+					m1[c] = neighbour_tangent(c, s + 1) * dt;
+					break;
+				case interpolation::bezier:
+					m0[c] = 3.f * (m_out[c][s] - p0[c]);
+					m1[c] = 3.f * (p1[c] - m_in[c][s + 1]);
+					break;
+				}
+			}
+		}
+
+	private:
+
+		// (v[i + 1] - v[i - 1]) / (t[i + 1] - t[i - 1]), one sided at the ends
+		float neighbour_tangent(const std::size_t c, const std::size_t i) const
+		{
+			const std::size_t a = i > 0 ? i - 1 : i;
+			const std::size_t b = i + 1 < m_times.size() ? i + 1 : i;
+			return (m_values[c][b] - m_values[c][a]) / (m_times[b] - m_times[a]);
+		}
+
+		// the segment [t[i], t[i + 1]) containing time
+		std::size_t search(const float time) const
+		{
+			const std::size_t n = m_times.size();
+			if (n < 2) return 0;
+			const std::size_t i = static_cast<std::size_t>(std::upper_bound(m_times.begin(), m_times.end(), time) - m_times.begin());
+			return std::min(i > 0 ? i - 1 : 0, n - 2);
+		}
+
+		std::size_t find(const float time, curve_cursor& cursor) const
+		{
+			const std::size_t n = m_times.size();
+			if (n < 2) return cursor.segment = 0;
+
+			std::size_t s = std::min(cursor.segment, n - 2);
+			if (time >= m_times[s])
+			{
+				// the same or the next segment for a monotonic playback
+				if (time < m_times[s + 1] || s == n - 2) return cursor.segment = s;
+				if (time < m_times[s + 2] || s + 1 == n - 2) return cursor.segment = s + 1;
+			}
+			else if (s == 0)
+			{
+				return cursor.segment = 0;
+			}
+			return cursor.segment = search(time);
+		}
+
+		interpolation m_mode;
+		std::vector<float> m_times;
+		std::vector<float> m_values[components];
+		std::vector<float> m_in[components];
+		std::vector<float> m_out[components];
+	};
+
+	// evaluate count channels at the same time, simd across the channels:
+	// the segments are found per channel, then the hermite polynomials of
+	// all the components of a block of channels run in one kernel call
+	// the cursors can be null, the segments are then searched
+	template <typename T>
+	inline void evaluate(const float time, const curve_t<T>* const* channels, curve_cursor* cursors, T* result, const std::size_t count)
+	{
+		typedef detail::curve_traits<T> traits;
+		constexpr std::size_t components = traits::components;
+		constexpr std::size_t block = 64;
+		constexpr std::size_t lanes = block * components;
+
+		float u[lanes], p0[lanes], m0[lanes], p1[lanes], m1[lanes], values[lanes];
+		for (std::size_t first = 0; first < count; first += block)
+		{
+			const std::size_t n = std::min(block, count - first);
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				curve_cursor local;
+				curve_cursor& cursor = cursors ? cursors[first + i] : local;
+				const std::size_t lane = i * components;
+				channels[first + i]->hermite_segment(time, cursor, u + lane, p0 + lane, m0 + lane, p1 + lane, m1 + lane);
+			}
+
+			evaluate_hermite(u, p0, m0, p1, m1, values, n * components);
+
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				T& r = result[first + i];
+				float* const data = traits::data(r);
+				for (std::size_t c = 0; c < components; ++c)
+					data[c] = values[i * components + c];
+				traits::finish(r);
+			}
+		}
+	}
+
+	// curve types
+
+	typedef curve_t<float> float_curve;
+	typedef curve_t<vector3> vector3_curve;
+	typedef curve_t<vector4> vector4_curve;
+	typedef curve_t<quaternion> quaternion_curve;
+}
+
+#if defined(VDTMATH_HEADER_ONLY)
+#include "kernels.h"
+#endif
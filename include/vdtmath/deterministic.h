@@ -0,0 +1,207 @@
+/// Copyright (c) Vito Domenico Tagliente
+
+#pragma once
+
+#include <cmath>
+#include <limits>
+
+namespace math
+{
+	// functions with the same results on every compiler, standard library
+	// and cpu, for lockstep simulations
+	// the libm sin, cos and acos are not specified to the last bit, these
+	// are fixed algorithms evaluated in double precision: range reduction
+	// by pi/2 in three parts and the minimax polynomials of fdlibm, the
+	// float versions round the double result
+	// sqrt is correctly rounded by ieee 754, the standard one is used
+	// the results are the same only if the compiler does not contract the
+	// multiplications and additions into fma nor uses the x87 registers,
+	// see VDTMATH_DETERMINISTIC in CMakeLists.txt
+	namespace deterministic
+	{
+		inline float sqrt(const float x) { return std::sqrt(x); }
+		inline double sqrt(const double x) { return std::sqrt(x); }
+
+		// within 2 ulp for |x| < 2^19 * pi/2, larger arguments are reduced
+		// by a rounded 2pi first, same results but less accurate
+		inline void sincos(const double x, double& s, double& c);
+		inline double sin(const double x);
+		inline double cos(const double x);
+		inline double tan(const double x);
+
+		// within 2 ulp, nan out of [-1, 1]
+		inline double acos(const double x);
+
+		inline void sincos(const float x, float& s, float& c);
+		inline float sin(const float x) { return static_cast<float>(sin(static_cast<double>(x))); }
+		inline float cos(const float x) { return static_cast<float>(cos(static_cast<double>(x))); }
+		inline float tan(const float x) { return static_cast<float>(tan(static_cast<double>(x))); }
+		inline float acos(const float x) { return static_cast<float>(acos(static_cast<double>(x))); }
+	}
+
+	namespace detail
+	{
+		// sin on [-pi/4, pi/4]
+		inline double sin_kernel(const double x)
+		{
+			const double s1 = -1.66666666666666324348e-01;
+			const double s2 = 8.33333333332248946124e-03;
+			const double s3 = -1.98412698298579493134e-04;
+			const double s4 = 2.75573137070700676789e-06;
+			const double s5 = -2.50507602534068634195e-08;
+			const double s6 = 1.58969099521155010221e-10;
+
+			const double z = x * x;
+			const double v = z * x;
+			const double r = s2 + z * (s3 + z * (s4 + z * (s5 + z * s6)));
+			return x + v * (s1 + z * r);
+		}
+
+		// cos on [-pi/4, pi/4]
+		inline double cos_kernel(const double x)
+		{
+			const double c1 = 4.16666666666666019037e-02;
+			const double c2 = -1.38888888888741095749e-03;
+			const double c3 = 2.48015872894767294178e-05;
+			const double c4 = -2.75573143513906633035e-07;
+			const double c5 = 2.08757232129817482790e-09;
+			const double c6 = -1.13596475577881948265e-11;
+
+			const double z = x * x;
+			const double r = z * (c1 + z * (c2 + z * (c3 + z * (c4 + z * (c5 + z * c6)))));
+			const double hz = 0.5 * z;
+			const double w = 1.0 - hz;
+			return w + (((1.0 - w) - hz) + z * r);
+		}
+
+		// asin(x) = x + x * asin_rational(x * x) on [0, 0.25]
+		inline double asin_rational(const double z)
+		{
+			const double p0 = 1.66666666666666657415e-01;
+			const double p1 = -3.25565818622400915405e-01;
+			const double p2 = 2.01212532134862925881e-01;
+			const double p3 = -4.00555345006794114027e-02;
+			const double p4 = 7.91534994289814532176e-04;
+			const double p5 = 3.47933107596021167570e-05;
+			const double q1 = -2.40339491173441421878e+00;
+			const double q2 = 2.02094576023350569471e+00;
+			const double q3 = -6.88283971605453293030e-01;
+			const double q4 = 7.70381505559019352791e-02;
+
+			const double p = z * (p0 + z * (p1 + z * (p2 + z * (p3 + z * (p4 + z * p5)))));
+			const double q = 1.0 + z * (q1 + z * (q2 + z * (q3 + z * q4)));
+			return p / q;
+		}
+	}
+
+	namespace deterministic
+	{
+		inline void sincos(const double x, double& s, double& c)
+		{
+			// pi/2 = pio2_1 + pio2_2 + pio2_3, the first two have 33 bits so
+			// that their products by the quadrant are exact
+			const double two_over_pi = 6.36619772367581382433e-01;
+			const double pio2_1 = 1.57079632673412561417e+00;
+			const double pio2_2 = 6.07710050630396597660e-11;
+			const double pio2_3 = 2.02226624871116645580e-21;
+			const double two_pi = 6.28318530717958647692e+00;
+			const double limit = 8.23549664e+05;
+
+			if (!(std::fabs(x) <= std::numeric_limits<double>::max()))
+			{
+				// nan or infinity
+				s = c = std::numeric_limits<double>::quiet_NaN();
+				return;
+			}
+
+			// fmod and floor are exact
+			const double a = std::fabs(x) < limit ? x : std::fmod(x, two_pi);
+			const double n = std::floor(a * two_over_pi + 0.5);
+			const double y = ((a - n * pio2_1) - n * pio2_2) - n * pio2_3;
+			const double m = std::fmod(n, 4.0);
+			const int quadrant = static_cast<int>(m < 0.0 ? m + 4.0 : m);
+
+			const double ys = detail::sin_kernel(y);
+			const double yc = detail::cos_kernel(y);
+			switch (quadrant)
+			{
+			case 0: s = ys; c = yc; break;
+			case 1: s = yc; c = -ys; break;
+			case 2: s = -ys; c = -yc; break;
+			default: s = -yc; c = ys; break;
+			}
+		}
+
+		inline double sin(const double x)
+		{
+			double s, c;
+			sincos(x, s, c);
+			return s;
+		}
+
+		inline double cos(const double x)
+		{
+			double s, c;
+			sincos(x, s, c);
+			return c;
+		}
+
+		inline double tan(const double x)
+		{
+			double s, c;
+			sincos(x, s, c);
+			return s / c;
+		}
+
+		inline double acos(const double x)
+		{
+			const double pi = 3.14159265358979311600e+00;
+			const double pio2_hi = 1.57079632679489655800e+00;
+			const double pio2_lo = 6.12323399573676603587e-17;
+
+			if (!(std::fabs(x) <= 1.0)) return std::numeric_limits<double>::quiet_NaN();
+
+			if (std::fabs(x) < 0.5)
+			{
+				return pio2_hi - (x - (pio2_lo - x * detail::asin_rational(x * x)));
+			}
+			if (x < 0.0)
+			{
+				// acos(x) = pi - 2 * asin(sqrt((1 + x) / 2))
+				const double z = (1.0 + x) * 0.5;
+				const double s = std::sqrt(z);
+				const double w = detail::asin_rational(z) * s - pio2_lo;
+				return pi - 2.0 * (s + w);
+			}
+			// acos(x) = 2 * asin(sqrt((1 - x) / 2))
+			const double z = (1.0 - x) * 0.5;
+			const double s = std::sqrt(z);
+			return 2.0 * (s + s * detail::asin_rational(z));
+		}
+
+		inline void sincos(const float x, float& s, float& c)
+		{
+			double ds, dc;
+			sincos(static_cast<double>(x), ds, dc);
+			s = static_cast<float>(ds);
+			c = static_cast<float>(dc);
+		}
+	}
+
+	namespace detail
+	{
+		// the functions used by the library, the deterministic ones
+		// when VDTMATH_DETERMINISTIC is defined, the other types as
+		// fixed_t have theirs found by argument dependent lookup
+#if defined(VDTMATH_DETERMINISTIC)
+#define VDTMATH_FUNCTIONS deterministic
+#else
+#define VDTMATH_FUNCTIONS std
+#endif
+		template <typename T> inline T sin(const T x) { using VDTMATH_FUNCTIONS::sin; return sin(x); }
+		template <typename T> inline T cos(const T x) { using VDTMATH_FUNCTIONS::cos; return cos(x); }
+		template <typename T> inline T tan(const T x) { using VDTMATH_FUNCTIONS::tan; return tan(x); }
+		template <typename T> inline T acos(const T x) { using VDTMATH_FUNCTIONS::acos; return acos(x); }
+#undef VDTMATH_FUNCTIONS
+	}
+}
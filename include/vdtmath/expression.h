@@ -0,0 +1,279 @@
+/// Copyright (c) Vito Domenico Tagliente
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "matrix_n.h"
+#include "vector_n.h"
+
+namespace math
+{
+	// opt-in lazy evaluation of element-wise arithmetic
+	//
+	// wrapping the first operand with lazy() turns the whole expression
+	// into a tree of nodes that is evaluated in a single loop when it is
+	// assigned, without intermediate vectors, matrices or arrays:
+	//
+	//     vec3 r = lazy(a) * s + b - c;
+	//     evaluate(lazy(xs) * 2.f + ys, out);   // arrays of scalars
+	//
+	// only the element-wise operators are supported: + and - between
+	// operands of the same size, * and / by a scalar, unary -
+	// the nodes keep references to their operands, so an expression
+	// must be evaluated within the statement that builds it
+
+	template <typename E>
+	struct expression_t;
+
+	namespace detail
+	{
+		template <typename T>
+		struct expression_leaf
+		{
+			typedef T value_type;
+
+			const T* data;
+			std::size_t count;
+
+			T operator[] (const std::size_t i) const
+			{
+				return data[i];
+			}
+
+			std::size_t size() const
+			{
+				return count;
+			}
+		};
+
+		struct expression_add
+		{
+			template <typename T>
+			static T apply(const T a, const T b) { return a + b; }
+		};
+
+		struct expression_subtract
+		{
+			template <typename T>
+			static T apply(const T a, const T b) { return a - b; }
+		};
+
+		struct expression_multiply
+		{
+			template <typename T>
+			static T apply(const T a, const T b) { return a * b; }
+		};
+
+		struct expression_divide
+		{
+			template <typename T>
+			static T apply(const T a, const T b) { return a / b; }
+		};
+
+		template <typename L, typename R, typename Op>
+		struct expression_binary
+		{
+			typedef typename L::value_type value_type;
+			static_assert(std::is_same<value_type, typename R::value_type>::value, "the operands must have the same value type");
+
+			L left;
+			R right;
+
+			value_type operator[] (const std::size_t i) const
+			{
+				return Op::apply(left[i], right[i]);
+			}
+
+			std::size_t size() const
+			{
+				assert(left.size() == right.size());
+				return left.size();
+			}
+		};
+
+		// expression op scalar, or scalar op expression when Reversed
+		template <typename E, typename Op, bool Reversed>
+		struct expression_scalar
+		{
+			typedef typename E::value_type value_type;
+
+			E node;
+			value_type scalar;
+
+			value_type operator[] (const std::size_t i) const
+			{
+				return Reversed ? Op::apply(scalar, node[i]) : Op::apply(node[i], scalar);
+			}
+
+			std::size_t size() const
+			{
+				return node.size();
+			}
+		};
+
+		template <typename E>
+		struct expression_negate
+		{
+			typedef typename E::value_type value_type;
+
+			E node;
+
+			value_type operator[] (const std::size_t i) const
+			{
+				return -node[i];
+			}
+
+			std::size_t size() const
+			{
+				return node.size();
+			}
+		};
+
+		template <typename T>
+		struct is_expression : std::false_type {};
+
+		template <typename E>
+		struct is_expression<expression_t<E>> : std::true_type {};
+	}
+
+	template <typename E>
+	struct expression_t
+	{
+		typedef typename E::value_type value_type;
+
+		E node;
+
+		value_type operator[] (const std::size_t i) const
+		{
+			return node[i];
+		}
+
+		std::size_t size() const
+		{
+			return node.size();
+		}
+
+		// evaluate into any type accepted by evaluate()
+		template <typename C>
+		operator C() const
+		{
+			C result;
+			evaluate(*this, result);
+			return result;
+		}
+	};
+
+	// leaves
+
+	template <typename T>
+	inline expression_t<detail::expression_leaf<T>> lazy(const T* data, const std::size_t count)
+	{
+		return { { data, count } };
+	}
+
+	template <typename T>
+	inline expression_t<detail::expression_leaf<T>> lazy(const std::vector<T>& values)
+	{
+		return { { values.data(), values.size() } };
+	}
+
+	template <typename T, std::size_t N>
+	inline expression_t<detail::expression_leaf<T>> lazy(const vector_t<T, N>& vector)
+	{
+		return { { vector.data, N } };
+	}
+
+	template <typename T, std::size_t R, std::size_t C>
+	inline expression_t<detail::expression_leaf<T>> lazy(const matrix_t<T, R, C>& matrix)
+	{
+		return { { matrix.data, R * C } };
+	}
+
+	template <typename E>
+	inline const expression_t<E>& lazy(const expression_t<E>& expression)
+	{
+		return expression;
+	}
+
+	// evaluation, the destination can alias any operand
+
+	template <typename E>
+	inline void evaluate(const expression_t<E>& expression, typename E::value_type* result)
+	{
+		const std::size_t count = expression.size();
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			result[i] = expression[i];
+		}
+	}
+
+	template <typename E>
+	inline void evaluate(const expression_t<E>& expression, std::vector<typename E::value_type>& result)
+	{
+		result.resize(expression.size());
+		evaluate(expression, result.data());
+	}
+
+	template <typename E, typename T, std::size_t N>
+	inline void evaluate(const expression_t<E>& expression, vector_t<T, N>& result)
+	{
+		assert(expression.size() == N);
+		evaluate(expression, result.data);
+	}
+
+	template <typename E, typename T, std::size_t R, std::size_t C>
+	inline void evaluate(const expression_t<E>& expression, matrix_t<T, R, C>& result)
+	{
+		assert(expression.size() == R * C);
+		evaluate(expression, result.data);
+	}
+
+	// operators, at least one operand must be an expression,
+	// the other one is wrapped with lazy()
+
+	template <typename A, typename B,
+		typename = typename std::enable_if<detail::is_expression<A>::value || detail::is_expression<B>::value>::type>
+	inline auto operator+ (const A& a, const B& b)
+		-> expression_t<detail::expression_binary<decltype(lazy(a).node), decltype(lazy(b).node), detail::expression_add>>
+	{
+		return { { lazy(a).node, lazy(b).node } };
+	}
+
+	template <typename A, typename B,
+		typename = typename std::enable_if<detail::is_expression<A>::value || detail::is_expression<B>::value>::type>
+	inline auto operator- (const A& a, const B& b)
+		-> expression_t<detail::expression_binary<decltype(lazy(a).node), decltype(lazy(b).node), detail::expression_subtract>>
+	{
+		return { { lazy(a).node, lazy(b).node } };
+	}
+
+	template <typename E>
+	inline expression_t<detail::expression_negate<E>> operator- (const expression_t<E>& expression)
+	{
+		return { { expression.node } };
+	}
+
+	template <typename E>
+	inline expression_t<detail::expression_scalar<E, detail::expression_multiply, false>> operator* (const expression_t<E>& expression, const typename E::value_type scalar)
+	{
+		return { { expression.node, scalar } };
+	}
+
+	template <typename E>
+	inline expression_t<detail::expression_scalar<E, detail::expression_multiply, true>> operator* (const typename E::value_type scalar, const expression_t<E>& expression)
+	{
+		return { { expression.node, scalar } };
+	}
+
+	template <typename E>
+	inline expression_t<detail::expression_scalar<E, detail::expression_multiply, false>> operator/ (const expression_t<E>& expression, const typename E::value_type scalar)
+	{
+		assert(scalar != static_cast<typename E::value_type>(0.0));
+		// same as the eager operators, multiply by the reciprocal
+		return { { expression.node, static_cast<typename E::value_type>(1.0) / scalar } };
+	}
+}
@@ -0,0 +1,316 @@
+/// Copyright (c) Vito Domenico Tagliente
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <type_traits>
+
+namespace math
+{
+	// fixed point number of IntBits integer bits, the sign included, and
+	// FracBits fractional bits stored in a 32 bit integer
+	// the arithmetic is integer only, the same on every compiler and cpu:
+	// products are rounded to the nearest, quotients toward zero and the
+	// results out of range wrap around at IntBits + FracBits bits
+	// it can be the element type of vectors, matrices and rectangles,
+	// sqrt, sin, cos, tan and acos are found by argument dependent lookup
+	template <unsigned int IntBits, unsigned int FracBits>
+	class fixed_t
+	{
+	public:
+
+		static_assert(IntBits >= 1 && FracBits >= 1 && IntBits + FracBits <= 32, "the number is stored in 32 bits");
+
+		typedef std::int32_t storage_type;
+
+		static constexpr unsigned int integer_bits = IntBits;
+		static constexpr unsigned int fractional_bits = FracBits;
+		static constexpr std::int64_t one_raw = std::int64_t(1) << FracBits;
+
+		// uninitialized as the arithmetic types, fixed_t() is zero
+		fixed_t() = default;
+
+		// the conversions are implicit for the literals of the headers,
+		// as in static_cast<T>(0.0) or x * 2
+		template <typename A, typename = std::enable_if_t<std::is_integral_v<A>>>
+		constexpr fixed_t(const A value)
+			: m_value(wrap(static_cast<std::int64_t>(value) * one_raw))
+		{
+
+		}
+
+		// rounded to the nearest
+		constexpr fixed_t(const double value)
+			: m_value(wrap(static_cast<std::int64_t>(value >= 0.0 ? value * one_raw + 0.5 : value * one_raw - 0.5)))
+		{
+
+		}
+
+		constexpr fixed_t(const float value)
+			: fixed_t(static_cast<double>(value))
+		{
+
+		}
+
+		static constexpr fixed_t from_raw(const std::int64_t value)
+		{
+			fixed_t result;
+			result.m_value = wrap(value);
+			return result;
+		}
+
+		constexpr storage_type raw() const { return m_value; }
+
+		explicit constexpr operator double() const { return static_cast<double>(m_value) / one_raw; }
+		explicit constexpr operator float() const { return static_cast<float>(static_cast<double>(*this)); }
+
+		// truncated toward zero
+		template <typename A, typename = std::enable_if_t<std::is_integral_v<A>>>
+		explicit constexpr operator A() const { return static_cast<A>(m_value / one_raw); }
+
+		constexpr fixed_t operator- () const { return from_raw(-static_cast<std::int64_t>(m_value)); }
+		constexpr fixed_t operator+ () const { return *this; }
+
+		constexpr fixed_t& operator+= (const fixed_t other) { return *this = *this + other; }
+		constexpr fixed_t& operator-= (const fixed_t other) { return *this = *this - other; }
+		constexpr fixed_t& operator*= (const fixed_t other) { return *this = *this * other; }
+		constexpr fixed_t& operator/= (const fixed_t other) { return *this = *this / other; }
+
+		friend constexpr fixed_t operator+ (const fixed_t a, const fixed_t b)
+		{
+			return from_raw(static_cast<std::int64_t>(a.m_value) + b.m_value);
+		}
+
+		friend constexpr fixed_t operator- (const fixed_t a, const fixed_t b)
+		{
+			return from_raw(static_cast<std::int64_t>(a.m_value) - b.m_value);
+		}
+
+		friend constexpr fixed_t operator* (const fixed_t a, const fixed_t b)
+		{
+			return from_raw(shift_round(static_cast<std::int64_t>(a.m_value) * b.m_value, FracBits));
+		}
+
+		friend constexpr fixed_t operator/ (const fixed_t a, const fixed_t b)
+		{
+			assert(b.m_value != 0);
+			return from_raw(static_cast<std::int64_t>(a.m_value) * one_raw / b.m_value);
+		}
+
+		friend constexpr bool operator== (const fixed_t a, const fixed_t b) { return a.m_value == b.m_value; }
+		friend constexpr bool operator!= (const fixed_t a, const fixed_t b) { return a.m_value != b.m_value; }
+		friend constexpr bool operator< (const fixed_t a, const fixed_t b) { return a.m_value < b.m_value; }
+		friend constexpr bool operator<= (const fixed_t a, const fixed_t b) { return a.m_value <= b.m_value; }
+		friend constexpr bool operator> (const fixed_t a, const fixed_t b) { return a.m_value > b.m_value; }
+		friend constexpr bool operator>= (const fixed_t a, const fixed_t b) { return a.m_value >= b.m_value; }
+
+		// value / 2^shift rounded to the nearest, the ties away from zero
+		static constexpr std::int64_t shift_round(const std::int64_t value, const unsigned int shift)
+		{
+			const std::int64_t half = std::int64_t(1) << (shift - 1);
+			const std::int64_t divisor = std::int64_t(1) << shift;
+			return value >= 0 ? (value + half) / divisor : -((-value + half) / divisor);
+		}
+
+	private:
+
+		// two's complement wrap around to IntBits + FracBits bits,
+		// the low bits sign extended from the last one
+		static constexpr storage_type wrap(const std::int64_t value)
+		{
+			const std::uint64_t sign = std::uint64_t(1) << (IntBits + FracBits - 1);
+			const std::uint64_t bits = static_cast<std::uint64_t>(value) & (sign * 2 - 1);
+			return static_cast<storage_type>(static_cast<std::int64_t>(bits ^ sign) - static_cast<std::int64_t>(sign));
+		}
+
+		storage_type m_value;
+	};
+
+	namespace detail
+	{
+		// the functions are computed on 2.30 numbers in 64 bit integers
+		constexpr unsigned int fixed_q = 30;
+		constexpr std::int64_t fixed_one = std::int64_t(1) << fixed_q;
+		constexpr std::int64_t fixed_half_pi = 1686629713;
+		constexpr std::int64_t fixed_pi = 3373259426;
+
+		template <unsigned int I, unsigned int F>
+		constexpr std::int64_t to_q30(const fixed_t<I, F> x)
+		{
+			if constexpr (F <= fixed_q) return x.raw() * (std::int64_t(1) << (fixed_q - F));
+			else return fixed_t<I, F>::shift_round(x.raw(), F - fixed_q);
+		}
+
+		template <unsigned int I, unsigned int F>
+		constexpr fixed_t<I, F> from_q30(const std::int64_t x)
+		{
+			if constexpr (F < fixed_q) return fixed_t<I, F>::from_raw(fixed_t<I, F>::shift_round(x, fixed_q - F));
+			else return fixed_t<I, F>::from_raw(x * (std::int64_t(1) << (F - fixed_q)));
+		}
+
+		// a * b of 2.30 numbers
+		constexpr std::int64_t multiply_q30(const std::int64_t a, const std::int64_t b)
+		{
+			return fixed_t<2, 30>::shift_round(a * b, fixed_q);
+		}
+
+		// floor(sqrt(value)) by the digits of the result
+		constexpr std::uint64_t integer_sqrt(std::uint64_t value)
+		{
+			std::uint64_t result = 0;
+			std::uint64_t bit = std::uint64_t(1) << 62;
+			while (bit > value) bit >>= 2;
+			while (bit != 0)
+			{
+				if (value >= result + bit)
+				{
+					value -= result + bit;
+					result = (result >> 1) + bit;
+				}
+				else
+				{
+					result >>= 1;
+				}
+				bit >>= 2;
+			}
+			return result;
+		}
+
+		// sin and cos of x in [-pi/4, pi/4], the taylor series in horner form
+		constexpr std::int64_t sin_q30(const std::int64_t x)
+		{
+			const std::int64_t x2 = multiply_q30(x, x);
+			std::int64_t r = fixed_one;
+			for (const std::int64_t d : { 110, 72, 42, 20, 6 })
+				r = fixed_one - multiply_q30(x2, r) / d;
+			return multiply_q30(x, r);
+		}
+
+		constexpr std::int64_t cos_q30(const std::int64_t x)
+		{
+			const std::int64_t x2 = multiply_q30(x, x);
+			std::int64_t r = fixed_one;
+			for (const std::int64_t d : { 132, 90, 56, 30, 12, 2 })
+				r = fixed_one - multiply_q30(x2, r) / d;
+			return r;
+		}
+
+		// the quadrant and the remainder of x by pi/2
+		constexpr void reduce_q30(const std::int64_t x, std::int64_t& quadrant, std::int64_t& remainder)
+		{
+			// rounded division, toward minus infinity for the ties
+			const std::int64_t shifted = x + fixed_half_pi / 2;
+			std::int64_t n = shifted / fixed_half_pi;
+			if (shifted % fixed_half_pi < 0) --n;
+			quadrant = n & 3;
+			remainder = x - n * fixed_half_pi;
+		}
+
+		constexpr void sincos_q30(const std::int64_t x, std::int64_t& s, std::int64_t& c)
+		{
+			std::int64_t quadrant = 0, y = 0;
+			reduce_q30(x, quadrant, y);
+			const std::int64_t ys = sin_q30(y);
+			const std::int64_t yc = cos_q30(y);
+			switch (quadrant)
+			{
+			case 0: s = ys; c = yc; break;
+			case 1: s = yc; c = -ys; break;
+			case 2: s = -ys; c = -yc; break;
+			default: s = -yc; c = ys; break;
+			}
+		}
+	}
+
+	// floor of the square root, zero for the negative numbers
+	template <unsigned int I, unsigned int F>
+	constexpr fixed_t<I, F> sqrt(const fixed_t<I, F> x)
+	{
+		assert(x.raw() >= 0);
+		if (x.raw() <= 0) return fixed_t<I, F>::from_raw(0);
+		// sqrt(raw * 2^F) has F fractional bits
+		return fixed_t<I, F>::from_raw(static_cast<std::int64_t>(detail::integer_sqrt(static_cast<std::uint64_t>(x.raw()) << F)));
+	}
+
+	template <unsigned int I, unsigned int F>
+	constexpr fixed_t<I, F> abs(const fixed_t<I, F> x)
+	{
+		return x.raw() < 0 ? -x : x;
+	}
+
+	// radians, the argument is reduced by pi/2 in 2.30
+	template <unsigned int I, unsigned int F>
+	constexpr fixed_t<I, F> sin(const fixed_t<I, F> x)
+	{
+		std::int64_t s = 0, c = 0;
+		detail::sincos_q30(detail::to_q30(x), s, c);
+		return detail::from_q30<I, F>(s);
+	}
+
+	template <unsigned int I, unsigned int F>
+	constexpr fixed_t<I, F> cos(const fixed_t<I, F> x)
+	{
+		std::int64_t s = 0, c = 0;
+		detail::sincos_q30(detail::to_q30(x), s, c);
+		return detail::from_q30<I, F>(c);
+	}
+
+	template <unsigned int I, unsigned int F>
+	constexpr fixed_t<I, F> tan(const fixed_t<I, F> x)
+	{
+		std::int64_t s = 0, c = 0;
+		detail::sincos_q30(detail::to_q30(x), s, c);
+		assert(c != 0);
+		return fixed_t<I, F>::from_raw(s * fixed_t<I, F>::one_raw / c);
+	}
+
+	// x in [-1, 1], abramowitz and stegun 4.4.46:
+	// acos(x) = sqrt(1 - x) * (a0 + a1 * x + ... + a7 * x^7) for x >= 0
+	// acos(-x) = pi - acos(x)
+	template <unsigned int I, unsigned int F>
+	constexpr fixed_t<I, F> acos(const fixed_t<I, F> x)
+	{
+		std::int64_t v = detail::to_q30(x);
+		assert(v >= -detail::fixed_one && v <= detail::fixed_one);
+		const bool negative = v < 0;
+		if (negative) v = -v;
+		if (v > detail::fixed_one) v = detail::fixed_one;
+
+		// the coefficients in 2.30
+		std::int64_t r = 0;
+		for (const std::int64_t a : { -1355589, 7161955, -18348235, 33169905, -53874249, 95540460, -230423709, 1686629690 })
+			r = detail::multiply_q30(r, v) + a;
+		const std::int64_t root = static_cast<std::int64_t>(detail::integer_sqrt(static_cast<std::uint64_t>(detail::fixed_one - v) << detail::fixed_q));
+		r = detail::multiply_q30(root, r);
+		return detail::from_q30<I, F>(negative ? detail::fixed_pi - r : r);
+	}
+
+	// fixed types
+
+	typedef fixed_t<16, 16> fixed;
+}
+
+namespace std
+{
+	template <unsigned int I, unsigned int F>
+	class numeric_limits<math::fixed_t<I, F>>
+	{
+	public:
+		static constexpr bool is_specialized = true;
+		static constexpr bool is_signed = true;
+		static constexpr bool is_integer = false;
+		static constexpr bool is_exact = true;
+		static constexpr bool has_infinity = false;
+		static constexpr bool has_quiet_NaN = false;
+		static constexpr int digits = static_cast<int>(I + F) - 1;
+		static constexpr int radix = 2;
+
+		static constexpr math::fixed_t<I, F> min() { return math::fixed_t<I, F>::from_raw(1); }
+		static constexpr math::fixed_t<I, F> lowest() { return math::fixed_t<I, F>::from_raw(-(std::int64_t(1) << (I + F - 1))); }
+		static constexpr math::fixed_t<I, F> max() { return math::fixed_t<I, F>::from_raw((std::int64_t(1) << (I + F - 1)) - 1); }
+		static constexpr math::fixed_t<I, F> epsilon() { return math::fixed_t<I, F>::from_raw(1); }
+	};
+}
@@ -0,0 +1,110 @@
+/// Copyright (c) Vito Domenico Tagliente
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "aligned_array.h"
+#include "config.h"
+
+namespace math
+{
+	// bump allocator for the temporary arrays of a frame
+	// the allocations are released all together by reset(), the
+	// elements are not destroyed so they must be trivially destructible
+	// when a frame does not fit the arena grows with a new block, the
+	// next reset() merges the blocks so that the following frames
+	// run in a single block
+	//
+	//     arena.reset();
+	//     matrix4* models = arena.allocate<matrix4>(count);
+	//     multiply(locals, parents, models, count);
+	class frame_arena
+	{
+	public:
+
+		// the default size of the first block
+		static constexpr std::size_t default_capacity = 1024 * 1024;
+
+		VDTMATH_API explicit frame_arena(const std::size_t capacity = default_capacity);
+		VDTMATH_API ~frame_arena();
+
+		frame_arena(const frame_arena&) = delete;
+		frame_arena& operator= (const frame_arena&) = delete;
+
+		// uninitialized memory, the alignment is a power of two
+		void* allocate(const std::size_t size, const std::size_t alignment = cache_line_size)
+		{
+			assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+			const std::uintptr_t address = (m_cursor + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+			if (address + size <= m_end)
+			{
+				m_cursor = address + size;
+				return reinterpret_cast<void*>(address);
+			}
+			return allocate_block(size, alignment);
+		}
+
+		// uninitialized array of count elements, aligned to a cache line
+		template <typename T>
+		T* allocate(const std::size_t count)
+		{
+			static_assert(std::is_trivially_destructible<T>::value, "the arena does not destroy its elements");
+			const std::size_t alignment = alignof(T) > cache_line_size ? alignof(T) : cache_line_size;
+			return static_cast<T*>(allocate(count * sizeof(T), alignment));
+		}
+
+		// array of count copies of value
+		template <typename T>
+		T* allocate(const std::size_t count, const T& value)
+		{
+			T* const data = allocate<T>(count);
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				new (data + i) T(value);
+			}
+			return data;
+		}
+
+		// release all the allocations, to be called at the start of a frame
+		VDTMATH_API void reset();
+
+		// bytes handed out since the last reset, padding included
+		VDTMATH_API std::size_t used() const;
+
+		// bytes owned by the arena
+		std::size_t capacity() const
+		{
+			return m_capacity;
+		}
+
+	private:
+
+		struct block
+		{
+			block* previous;
+			std::size_t size;
+		};
+
+		// the first usable byte of a block
+		static constexpr std::size_t header_size = (sizeof(block) + cache_line_size - 1) & ~(cache_line_size - 1);
+
+		VDTMATH_API void* allocate_block(const std::size_t size, const std::size_t alignment);
+		VDTMATH_API void push_block(const std::size_t size);
+		VDTMATH_API void free_blocks();
+
+		block* m_block;
+		std::uintptr_t m_cursor;
+		std::uintptr_t m_end;
+		// bytes used by the blocks before the current one
+		std::size_t m_retired;
+		std::size_t m_capacity;
+	};
+}
+
+#if defined(VDTMATH_HEADER_ONLY)
+#include "../../source/frame_arena.cpp"
+#endif
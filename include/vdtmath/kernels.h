@@ -0,0 +1,77 @@
+/// Copyright (c) Vito Domenico Tagliente
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "affine3.h"
+#include "config.h"
+#include "matrix3.h"
+#include "matrix4.h"
+#include "vector3.h"
+#include "vector4.h"
+
+namespace math
+{
+	// batch kernels over arrays of float types
+	// the implementation is selected at runtime according
+	// to the active simd level, see cpu.h
+	// the result arrays can alias the inputs
+	// the arrays of matrix4 and vector4 in aligned storage, see
+	// aligned_array and frame_arena, take paths with aligned loads
+
+	// result[i] = a[i] * b[i]
+	VDTMATH_API void multiply(const matrix4* a, const matrix4* b, matrix4* result, const std::size_t count);
+
+	// result[i] = matrix * b[i]
+	VDTMATH_API void multiply(const matrix4& matrix, const matrix4* b, matrix4* result, const std::size_t count);
+
+	// result[i] = a[i] * b[i], in the product order of matrix4
+	VDTMATH_API void multiply(const affine3* a, const affine3* b, affine3* result, const std::size_t count);
+
+	// transform the points by a matrix built with translate, rotate and scale,
+	// points are row vectors with w = 1: result = (p, 1) * matrix
+	VDTMATH_API void transform_points(const matrix4& matrix, const vector3* points, vector3* result, const std::size_t count);
+
+	// transform the points by a projective matrix, a view projection
+	// for instance, and divide by w: (x, y, z, w) = (p, 1) * matrix,
+	// result = (x, y, z) / w
+	VDTMATH_API void project_points(const matrix4& matrix, const vector3* points, vector3* result, const std::size_t count);
+
+	// transform the points by an affine transformation
+	VDTMATH_API void transform_points(const affine3& affine, const vector3* points, vector3* result, const std::size_t count);
+
+	// transform the normals by a matrix built with normal_matrix,
+	// normals are row vectors: result = n * matrix, the result is not normalized
+	VDTMATH_API void transform_normals(const matrix3& matrix, const vector3* normals, vector3* result, const std::size_t count);
+
+	// zero length vectors are left untouched
+	VDTMATH_API void normalize(vector3* vectors, const std::size_t count);
+
+	// depth range of the clip space of a projection, see camera.h
+	enum class clip_depth
+	{
+		// matrix4::perspective, matrix4::orthographic, perspective_infinite
+		negative_one_to_one,
+		// perspective_reverse_z, perspective_infinite_reverse_z
+		one_to_zero
+	};
+
+	// extract the 6 frustum planes (left, right, bottom, top, near, far)
+	// from a view projection matrix, as (normal, distance) pairs
+	// pointing inside the frustum, the depth must match the projection
+	// or the near and far planes are wrong, the far plane of the
+	// infinite projections never culls
+	VDTMATH_API void frustum_planes(const matrix4& view_projection, vector4* planes, const clip_depth depth = clip_depth::negative_one_to_one);
+
+	// spheres are stored as (center, radius), the mask receives one bit
+	// per visible sphere, see mask_size, the return value is the number
+	// of visible spheres
+	VDTMATH_API std::size_t cull_spheres(const vector4* planes, const vector4* spheres, const std::size_t count, std::uint8_t* mask);
+}
+
+#if defined(VDTMATH_HEADER_ONLY)
+#include "../../source/kernels.cpp"
+#include "../../source/kernels_x86.cpp"
+#endif
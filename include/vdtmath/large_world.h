@@ -0,0 +1,78 @@
+/// Copyright (c) Vito Domenico Tagliente
+
+#pragma once
+
+#include <cstddef>
+
+#include "matrix4.h"
+#include "transform.h"
+#include "vector3.h"
+
+namespace math
+{
+	// camera relative rendering
+	// world positions are kept in double precision and the origin, usually
+	// the camera position, is subtracted before converting to float, 
+	// so the values sent to the gpu stay small and precise around the camera
+
+	inline vector3 to_relative(const dvector3& position, const dvector3& origin)
+	{
+		return vector3(
+			static_cast<float>(position.x - origin.x),
+			static_cast<float>(position.y - origin.y),
+			static_cast<float>(position.z - origin.z)
+		);
+	}
+
+	inline void to_relative(const dvector3* positions, const std::size_t count, const dvector3& origin, vector3* result)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			result[i].x = static_cast<float>(positions[i].x - origin.x);
+			result[i].y = static_cast<float>(positions[i].y - origin.y);
+			result[i].z = static_cast<float>(positions[i].z - origin.z);
+		}
+	}
+
+	// world matrices, the translation (m30, m31, m32) is moved to the origin
+	inline void to_relative(const dmatrix4* matrices, const std::size_t count, const dvector3& origin, matrix4* result)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const double* const source = matrices[i].data;
+			float* const destination = result[i].data;
+			for (unsigned int j = 0; j < 12; ++j)
+			{
+				destination[j] = static_cast<float>(source[j]);
+			}
+			destination[12] = static_cast<float>(source[12] - origin.x);
+			destination[13] = static_cast<float>(source[13] - origin.y);
+			destination[14] = static_cast<float>(source[14] - origin.z);
+			destination[15] = static_cast<float>(source[15]);
+		}
+	}
+
+	inline matrix4 to_relative(const dmatrix4& matrix, const dvector3& origin)
+	{
+		matrix4 result;
+		to_relative(&matrix, 1, origin, &result);
+		return result;
+	}
+
+	inline matrix4 to_relative(const dtransform& transform, const dvector3& origin)
+	{
+		return to_relative(transform.matrix(), origin);
+	}
+
+	// view matrix to use with positions relative to the origin,
+	// the camera translation is folded in double precision:
+	// (p - origin) * relative_view == p * view
+	inline matrix4 to_relative_view(const dmatrix4& view, const dvector3& origin)
+	{
+		dmatrix4 relative(view);
+		relative.m30 += origin.x * view.m00 + origin.y * view.m10 + origin.z * view.m20;
+		relative.m31 += origin.x * view.m01 + origin.y * view.m11 + origin.z * view.m21;
+		relative.m32 += origin.x * view.m02 + origin.y * view.m12 + origin.z * view.m22;
+		return matrix4(relative);
+	}
+}
@@ -0,0 +1,124 @@
+/// Copyright (c) Vito Domenico Tagliente
+#pragma once 
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "config.h"
+
+namespace math
+{
+	// number of bytes needed by a hit mask of count elements,
+	// batch tests write one bit per element
+	inline std::size_t mask_size(const std::size_t count)
+	{
+		return (count + 7) / 8;
+	}
+
+	inline bool mask_test(const std::uint8_t* mask, const std::size_t i)
+	{
+		return (mask[i / 8] >> (i % 8)) & 1u;
+	}
+
+	namespace detail
+	{
+		inline std::size_t popcount8(unsigned int bits)
+		{
+			bits = bits - ((bits >> 1) & 0x55u);
+			bits = (bits & 0x33u) + ((bits >> 2) & 0x33u);
+			return static_cast<std::size_t>((bits + (bits >> 4)) & 0x0fu);
+		}
+
+		// simd kernels of the float batch tests, see kernels.cpp
+		// circles are packed (x, y, radius) floats and points (x, y) floats,
+		// the boxes are (min x, min y, max x, max y) tested against
+		// the bounds of a structure of arrays, see rectangle_array.h
+		VDTMATH_API std::size_t circle_contains_points(const float* circle, const float* points, const std::size_t count, std::uint8_t* mask);
+		VDTMATH_API std::size_t circle_contains_circles(const float* circle, const float* circles, const std::size_t count, std::uint8_t* mask);
+		VDTMATH_API std::size_t circle_intersects_circles(const float* circle, const float* circles, const std::size_t count, std::uint8_t* mask);
+		VDTMATH_API std::size_t overlap_boxes(const float* box, const float* min_x, const float* min_y, const float* max_x, const float* max_y, const std::size_t count, std::uint8_t* mask);
+
+		// the generic batch test of the types without simd kernels,
+		// 8 lanes at a time, the scalar tests are packed in a byte
+		template <typename Test>
+		std::size_t test_mask(const std::size_t count, std::uint8_t* mask, Test test)
+		{
+			std::size_t hits = 0;
+			std::size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				unsigned int bits = 0;
+				for (unsigned int lane = 0; lane < 8; ++lane)
+				{
+					bits |= static_cast<unsigned int>(test(i + lane)) << lane;
+				}
+				mask[i / 8] = static_cast<std::uint8_t>(bits);
+				hits += popcount8(bits);
+			}
+			if (i < count)
+			{
+				unsigned int bits = 0;
+				for (unsigned int lane = 0; i + lane < count; ++lane)
+				{
+					bits |= static_cast<unsigned int>(test(i + lane)) << lane;
+				}
+				mask[i / 8] = static_cast<std::uint8_t>(bits);
+				hits += popcount8(bits);
+			}
+			return hits;
+		}
+
+		// write the indices of the set bits of a mask, offset by first
+		inline std::size_t mask_indices(const std::uint8_t* mask, const std::size_t count, const std::size_t first, std::uint32_t* indices)
+		{
+			std::size_t hits = 0;
+			for (std::size_t i = 0; i < count; i += 8)
+			{
+				unsigned int bits = mask[i / 8];
+				while (bits != 0)
+				{
+					unsigned int lane = 0;
+					while (((bits >> lane) & 1u) == 0) ++lane;
+					indices[hits++] = static_cast<std::uint32_t>(first + i + lane);
+					bits &= bits - 1;
+				}
+			}
+			return hits;
+		}
+
+		// run a mask kernel over tiles of 256 elements and compact the hits,
+		// kernel(first, count, mask) returns the hits of its tile
+		template <typename Kernel>
+		std::size_t kernel_indices(const std::size_t count, std::uint32_t* indices, Kernel kernel)
+		{
+			std::uint8_t mask[32];
+			std::size_t hits = 0;
+			for (std::size_t first = 0; first < count; first += 256)
+			{
+				const std::size_t size = std::min<std::size_t>(256, count - first);
+				if (kernel(first, size, mask) == 0) continue;
+				hits += mask_indices(mask, size, first, indices + hits);
+			}
+			return hits;
+		}
+
+		// branchless compaction, the index is always written 
+		// and the cursor advances only on hits
+		template <typename Test>
+		std::size_t test_indices(const std::size_t count, std::uint32_t* indices, Test test)
+		{
+			std::size_t hits = 0;
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				indices[hits] = static_cast<std::uint32_t>(i);
+				hits += static_cast<std::size_t>(test(i));
+			}
+			return hits;
+		}
+	}
+}
+
+#if defined(VDTMATH_HEADER_ONLY)
+#include "kernels.h"
+#endif
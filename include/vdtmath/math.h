@@ -2,10 +2,32 @@
 
 #pragma once
 
+#include "affine2.h"
+#include "affine3.h"
+#include "aligned_array.h"
 #include "algorithm.h"
+#include "blob.h"
+#include "camera.h"
 #include "circle.h"
+#include "cpu.h"
+#include "curve.h"
+#include "deterministic.h"
+#include "expression.h"
+#include "fixed.h"
+#include "frame_arena.h"
+#include "kernels.h"
+#include "large_world.h"
 #include "matrix.h"
+#include "parallel.h"
+#include "pose.h"
+#include "profile.h"
 #include "rectangle.h"
+#include "ray.h"
+#include "rectangle_array.h"
+#include "spline.h"
+#include "sweep_and_prune.h"
+#include "quantize.h"
 #include "quaternion.h"
 #include "transform.h"
+#include "trs.h"
 #include "vector.h"
\ No newline at end of file
@@ -4,4 +4,5 @@
 
 #include "matrix2.h"
 #include "matrix3.h"
-#include "matrix4.h"
\ No newline at end of file
+#include "matrix4.h"
+#include "matrix_n.h"
\ No newline at end of file
@@ -5,330 +5,21 @@
 
 #include <cassert>
 #include <cmath>
-#include <cstring>
 
 #include "algorithm.h"
+#include "deterministic.h"
 #include "matrix3.h"
-#include "vector4.h"
+#include "matrix_n.h"
 #include "vector3.h"
+#include "vector4.h"
 
 namespace math
 {
 	template <typename T>
-	struct matrix4_t
-	{
-		static const matrix4_t zero;
-		static const matrix4_t identity;
-
-		// num of rows
-		const std::size_t rows = 4;
-		// num of columns
-		const std::size_t columns = 4;
-		// matrix size
-		const std::size_t length = rows * columns;
-
-		// matrix data
-		union
-		{
-			struct
-			{
-				T m00, m01, m02, m03;
-				T m10, m11, m12, m13;
-				T m20, m21, m22, m23;
-				T m30, m31, m32, m33;
-			};
-
-			T data[4 * 4];
-		};
-
-		matrix4_t()
-			: data()
-		{
-			std::memset(data, 0, length * sizeof(T));
-		}
-
-		matrix4_t(const T value)
-			: data()
-		{
-			std::memset(data, value, length * sizeof(T));
-		}
-
-		matrix4_t(
-			const T m00, const T m01, const T m02, const T m03,
-			const T m10, const T m11, const T m12, const T m13,
-			const T m20, const T m21, const T m22, const T m23,
-			const T m30, const T m31, const T m32, const T m33
-		) :
-			m00(m00), m01(m01), m02(m02), m03(m03),
-			m10(m10), m11(m11), m12(m12), m13(m13),
-			m20(m20), m21(m21), m22(m22), m23(m23),
-			m30(m30), m31(m31), m32(m32), m33(m33)
-		{
-
-		}
-
-		matrix4_t(const matrix4_t& matrix)
-			: data()
-		{
-			std::memcpy(data, matrix.data, length * sizeof(T));
-		}
-
-		std::size_t size() const
-		{
-			return length;
-		}
-
-		// get (i,j) element
-		T& operator() (const unsigned int i, const unsigned int j)
-		{
-			// row major implementation
-			return data[i + j * columns];
-		}
-
-		T operator() (const unsigned int i, const unsigned int j) const
-		{
-			return data[i + j * columns];
-		}
-
-		// transpose matrix
-		matrix4_t transpose() const
-		{
-			matrix4_t MT;
-			for (unsigned int j = 0; j < rows; j++)
-			{
-				for (unsigned int i = 0; i < columns; i++)
-				{
-					MT(i, j) = (*this)(j, i);
-				}
-			}
-			return MT;
-		}
-
-		// sub matrix
-		matrix3_t<T> minor(const unsigned int i, const unsigned int j) const
-		{
-			assert(i < columns
-				&& j < rows);
-			matrix3_t<T> result;
-
-			for (unsigned int _j = 0, __j = 0; _j < rows; ++_j)
-			{
-				if (_j == j) continue;
-				for (unsigned int _i = 0, __i = 0; _i < columns; ++_i)
-				{
-					if (_i == i) continue;
-					result(__i, __j) = (*this)(_i, _j);
-					++__i;
-				}
-				++__j;
-			}
-			return result;
-		}
-
-		matrix4_t inverse(bool& is_invertible) const
-		{
-			is_invertible = false;
-			const T d = determinant();
-			if (d != static_cast<T>(0.0)) {
-				is_invertible = true;
-				return adjugate() / d;
-			}
-			return *this;
-		}
-
-		// adjugate matrix
-		matrix4_t adjugate() const
-		{
-			matrix4_t result;
-			const matrix4_t MT = transpose();
-			for (unsigned int j = 0; j < rows; ++j)
-			{
-				for (unsigned int i = 0; i < columns; ++i)
-				{
-					matrix3_t<T> currentMinor = MT.minor(i, j);
-					result(i, j) = static_cast<T>(std::pow(-1, i + j)) * currentMinor.determinant();
-				}
-			}
-			return result;
-		}
-
-		// determinant 
-		T determinant() const
-		{
-			/* Laplace law */
-			int j = 0;
-			T result{};
-			for (unsigned int i = 0; i < columns; ++i)
-			{
-				const matrix3_t<T> m = minor(i, j);
-				result += (*this)(i, j) * static_cast<T>(std::pow(-1, i + j)) * m.determinant();
-			}
-			return result;
-		}
-
-		// orthograpic pojection
-		static matrix4_t orthographic(
-			const float left,
-			const float right,
-			const float bottom,
-			const float top,
-			const float near_plane,
-			const float far_plane);
-
-		// perspective projection
-		static matrix4_t perspective(
-			const float fov,
-			const float aspect,
-			const float near_plane,
-			const float far_plane);
-
-		static vector3_t<T> unproject(
-			const vector3_t<T>& screencoords,
-			const matrix4_t& view,
-			const matrix4_t& projection,
-			const vector4_t<T>& viewport);
-
-		// translation matrix
-		static matrix4_t translate(const vector3_t<T>& vector);
-
-		// rotation
-		static matrix4_t rotate_x(const float theta);
-		static matrix4_t rotate_y(const float theta);
-		static matrix4_t rotate_z(const float theta);
-		static matrix4_t rotate(const vector3_t<T>& vector, const float theta);
-
-		// scale
-		static matrix4_t scale(const vector3_t<T>& vector);
-
-		/* Operators overloading */
-
-		matrix4_t& operator= (const matrix4_t& matrix)
-		{
-			// check for self-assignment
-			if (this == &matrix)
-				return *this;
-
-			std::memcpy(data, matrix.data, length * sizeof(T));
-			return *this;
-		}
-
-		bool operator== (const matrix4_t& matrix) const
-		{
-			return m00 == matrix.m00 && m01 == matrix.m01 && m02 == matrix.m02 && m03 == matrix.m03
-				&& m10 == matrix.m10 && m11 == matrix.m11 && m12 == matrix.m12 && m13 == matrix.m13
-				&& m20 == matrix.m20 && m21 == matrix.m21 && m22 == matrix.m22 && m23 == matrix.m23
-				&& m30 == matrix.m30 && m31 == matrix.m31 && m32 == matrix.m32 && m33 == matrix.m33;
-		}
-
-		bool operator!= (const matrix4_t& matrix) const
-		{
-			return m00 != matrix.m00 || m01 != matrix.m01 || m02 != matrix.m02 || m03 != matrix.m03
-				|| m10 != matrix.m10 || m11 != matrix.m11 || m12 != matrix.m12 || m13 != matrix.m13
-				|| m20 != matrix.m20 || m21 != matrix.m21 || m22 != matrix.m22 || m23 != matrix.m23
-				|| m30 != matrix.m30 || m31 != matrix.m31 || m32 != matrix.m32 || m33 != matrix.m33;
-		}
-
-		matrix4_t& operator+= (const matrix4_t& matrix)
-		{
-			for (unsigned int i = 0; i < length; i++)
-				data[i] += matrix.data[i];
-			return *this;
-		}
-
-		matrix4_t& operator-= (const matrix4_t& matrix)
-		{
-			for (unsigned int i = 0; i < length; i++)
-				data[i] -= matrix.data[i];
-			return *this;
-		}
-
-		matrix4_t& operator*= (const T scalar)
-		{
-			for (unsigned int i = 0; i < length; i++)
-				data[i] *= scalar;
-			return *this;
-		}
-
-		matrix4_t& operator/= (const T scalar)
-		{
-			assert(scalar != static_cast<T>(0.0));
-			T f = static_cast<T>(1.0) / scalar;
-			return (*this) *= f;
-		}
-
-		matrix4_t operator- () const
-		{
-			matrix4_t result;
-			for (unsigned int i = 0; i < length; i++)
-				result.data[i] = -data[i];
-			return result;
-		}
-
-		matrix4_t operator+ (const matrix4_t& matrix) const
-		{
-			matrix4_t result;
-			for (unsigned int i = 0; i < length; i++)
-				result.data[i] = data[i] + matrix.data[i];
-			return result;
-		}
-
-		matrix4_t operator- (const matrix4_t& matrix) const
-		{
-			matrix4_t result;
-			for (unsigned int i = 0; i < length; i++)
-				result.data[i] = data[i] - matrix.data[i];
-			return result;
-		}
-
-		matrix4_t operator* (const T scalar) const
-		{
-			matrix4_t result;
-			for (unsigned int i = 0; i < length; i++)
-				result.data[i] = data[i] * scalar;
-			return result;
-		}
-
-		matrix4_t operator/ (const T scalar) const
-		{
-			assert(scalar != static_cast<T>(0.0));
-			T f = static_cast<T>(1.0) / scalar;
-			return (*this) * f;
-		}
-
-		matrix4_t operator* (const matrix4_t& matrix) const
-		{
-			matrix4_t result;
-			for (unsigned int j = 0; j < rows; ++j)
-			{
-				for (unsigned int y = 0; y < columns; ++y)
-				{
-					for (unsigned int i = 0; i < rows; ++i)
-					{
-						result(y, j) += (*this)(i, j) * matrix(y, i);
-					}
-				}
-			}
-			return result;
-		}
-
-		vector4_t<T> operator* (const vector4_t<T>& vector) const
-		{
-			vector4_t<T> result;
-			for (unsigned int j = 0; j < rows; ++j)
-			{
-				T value{};
-				for (unsigned int i = 0; i < columns; ++i)
-				{
-					value += (*this)(i, j) * vector[i];
-				}
-				result[j] = value;
-			}
-			return result;
-		}
-	};
+	using matrix4_t = matrix_t<T, 4, 4>;
 
 	template<typename T>
-	inline matrix4_t<T> matrix4_t<T>::orthographic(const float left, const float right, const float bottom, const float top, const float near_plane, const float far_plane)
+	inline matrix4_t<T> detail::matrix_base<T, 4, 4>::orthographic(const float left, const float right, const float bottom, const float top, const float near_plane, const float far_plane)
 	{
 		matrix4_t<T> m = matrix4_t<T>::identity;
 
@@ -346,16 +37,16 @@ namespace math
 	}
 
 	template<typename T>
-	inline matrix4_t<T> matrix4_t<T>::perspective(const float fov, const float aspect, const float near_plane, const float far_plane)
+	inline matrix4_t<T> detail::matrix_base<T, 4, 4>::perspective(const float fov, const float aspect, const float near_plane, const float far_plane)
 	{
 		matrix4_t<T> m = matrix4_t<T>::identity;
 
 		const T two = static_cast<T>(2.0);
 
-		float top = near_plane * std::tan(fov / two);
-		float bottom = -top;
-		float right = top * aspect;
-		float left = -top * aspect;
+		const T top = static_cast<T>(near_plane) * detail::tan(fov / two);
+		const T bottom = -top;
+		const T right = top * aspect;
+		const T left = -top * aspect;
 
 		m.m00 = (two * near_plane) / (right - left);
 		m.m11 = (two * near_plane) / (top - bottom);
@@ -368,7 +59,7 @@ namespace math
 	}
 
 	template<typename T>
-	inline vector3_t<T> matrix4_t<T>::unproject(const vector3_t<T>& screencoords, const matrix4_t<T>& view, const matrix4_t<T>& projection, const vector4_t<T>& viewport)
+	inline vector3_t<T> detail::matrix_base<T, 4, 4>::unproject(const vector3_t<T>& screencoords, const matrix4_t<T>& view, const matrix4_t<T>& projection, const vector4_t<T>& viewport)
 	{
 		bool isInvertible = false;
 		const math::matrix4_t<T> inverse = (projection * view).inverse(isInvertible);
@@ -383,7 +74,7 @@ namespace math
 	}
 
 	template<typename T>
-	inline matrix4_t<T> matrix4_t<T>::translate(const vector3_t<T>& vector)
+	inline matrix4_t<T> detail::matrix_base<T, 4, 4>::translate(const vector3_t<T>& vector)
 	{
 		matrix4_t<T> matrix = matrix4_t<T>::identity;
 
@@ -396,11 +87,11 @@ namespace math
 	}
 
 	template<typename T>
-	inline matrix4_t<T> matrix4_t<T>::rotate_x(const float theta)
+	inline matrix4_t<T> detail::matrix_base<T, 4, 4>::rotate_x(const T theta)
 	{
-		const float rad = radians(theta);
-		const float c = std::cos(rad);
-		const float s = std::sin(rad);
+		const T rad = radians(theta);
+		const T c = detail::cos(rad);
+		const T s = detail::sin(rad);
 
 		matrix4_t<T> matrix = matrix4_t<T>::identity;
 
@@ -413,11 +104,11 @@ namespace math
 	}
 
 	template<typename T>
-	inline matrix4_t<T> matrix4_t<T>::rotate_y(const float theta)
+	inline matrix4_t<T> detail::matrix_base<T, 4, 4>::rotate_y(const T theta)
 	{
-		const float rad = radians(theta);
-		const float c = std::cos(rad);
-		const float s = std::sin(rad);
+		const T rad = radians(theta);
+		const T c = detail::cos(rad);
+		const T s = detail::sin(rad);
 
 		matrix4_t<T> matrix = matrix4_t<T>::identity;
 
@@ -430,11 +121,11 @@ namespace math
 	}
 
 	template<typename T>
-	inline matrix4_t<T> matrix4_t<T>::rotate_z(const float theta)
+	inline matrix4_t<T> detail::matrix_base<T, 4, 4>::rotate_z(const T theta)
 	{
-		const float rad = radians(theta);
-		const float c = std::cos(rad);
-		const float s = std::sin(rad);
+		const T rad = radians(theta);
+		const T c = detail::cos(rad);
+		const T s = detail::sin(rad);
 
 		matrix4_t<T> matrix = matrix4_t<T>::identity;
 
@@ -447,24 +138,25 @@ namespace math
 	}
 
 	template<typename T>
-	inline matrix4_t<T> matrix4_t<T>::rotate(const vector3_t<T>& vector, const float theta)
+	inline matrix4_t<T> detail::matrix_base<T, 4, 4>::rotate(const vector3_t<T>& vector, const T theta)
 	{
-		const float rad = radians(theta);
-		const float c = std::cos(rad);
-		const float s = std::sin(rad);
-		const float c1 = 1 - c;
-
-		matrix4_t<T> matrix({
-			std::pow(vector.x,2) * c1 + c,				vector.x * vector.y * c1 - vector.z * s,	vector.x * vector.normalize * c1 + vector.y * s,	0,
-			vector.x * vector.y * c1 + vector.z * s,	std::pow(vector.y,2) * c1 + c,				vector.y * vector.z * c1 - vector.x * s,			0,
-			vector.x * vector.y * c1 - vector.y * s,	vector.y * vector.z * c1 - vector.x * s,	std::pow(vector.z,2) * c1 + c,						0,
-			0,												0,												0,														1
-			});
+		const T rad = radians(theta);
+		const T c = detail::cos(rad);
+		const T s = detail::sin(rad);
+		const T c1 = static_cast<T>(1.0) - c;
+
+		const T x = vector.x, y = vector.y, z = vector.z;
+		matrix4_t<T> matrix(
+			x * x * c1 + c,		x * y * c1 - z * s,	x * z * c1 + y * s,	0,
+			x * y * c1 + z * s,	y * y * c1 + c,		y * z * c1 - x * s,	0,
+			x * z * c1 - y * s,	y * z * c1 + x * s,	z * z * c1 + c,		0,
+			0,					0,					0,					1
+		);
 		return matrix;
 	}
 
 	template<typename T>
-	inline matrix4_t<T> matrix4_t<T>::scale(const vector3_t<T>& vector)
+	inline matrix4_t<T> detail::matrix_base<T, 4, 4>::scale(const vector3_t<T>& vector)
 	{
 		matrix4_t<T> matrix = matrix4_t<T>::identity;
 
@@ -475,17 +167,31 @@ namespace math
 		return matrix;
 	}
 
-	template<typename T> const matrix4_t<T> matrix4_t<T>::zero = matrix4_t<T>(0.0);
-	template<typename T> const matrix4_t<T> matrix4_t<T>::identity = matrix4_t<T>(
-		1.0, 0.0, 0.0, 0.0,
-		0.0, 1.0, 0.0, 0.0,
-		0.0, 0.0, 1.0, 0.0,
-		0.0, 0.0, 0.0, 1.0
+	// inverse transpose of the upper 3x3 of a transform matrix,
+	// the rows are the cross products of the rows divided by the determinant,
+	// a singular matrix returns the cofactors, still valid for normals
+	// that are normalized after the transformation
+	template<typename T>
+	inline matrix3_t<T> normal_matrix(const matrix4_t<T>& m)
+	{
+		matrix3_t<T> result(
+			m.m11 * m.m22 - m.m12 * m.m21, m.m12 * m.m20 - m.m10 * m.m22, m.m10 * m.m21 - m.m11 * m.m20,
+			m.m21 * m.m02 - m.m22 * m.m01, m.m22 * m.m00 - m.m20 * m.m02, m.m20 * m.m01 - m.m21 * m.m00,
+			m.m01 * m.m12 - m.m02 * m.m11, m.m02 * m.m10 - m.m00 * m.m12, m.m00 * m.m11 - m.m01 * m.m10
 		);
+		const T d = m.m00 * result.m00 + m.m01 * result.m01 + m.m02 * result.m02;
+		if (d != static_cast<T>(0.0))
+		{
+			result *= static_cast<T>(1.0) / d;
+		}
+		return result;
+	}
 
 	// matrix types
 
 	typedef matrix4_t<float> matrix4;
 	typedef matrix4 mat4;
+	typedef matrix4_t<double> dmatrix4;
+	typedef dmatrix4 dmat4;
 
 }
\ No newline at end of file
@@ -0,0 +1,560 @@
+/// Copyright (c) Vito Domenico Tagliente
+
+#pragma once
+#pragma warning(disable : 4201)
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "config.h"
+#include "vector_n.h"
+
+#if defined(VDTMATH_PROFILE)
+#include "profile.h"
+#endif
+
+namespace math
+{
+	template <typename T, std::size_t R, std::size_t C>
+	struct matrix_t;
+
+	namespace detail
+	{
+		// matrix storage, row major, the square 2, 3 and 4 sizes
+		// expose the named elements mRC (row R, column C)
+		// the constructors always initialize the data array, so that
+		// the generic operations can be evaluated at compile time
+		template <typename T, std::size_t R, std::size_t C>
+		struct matrix_base
+		{
+			T data[R * C];
+
+			constexpr matrix_base()
+				: data()
+			{
+
+			}
+
+			template <typename... A>
+			constexpr matrix_base(const elements_tag, const A... values)
+				: data{ values... }
+			{
+
+			}
+		};
+
+		template <typename T>
+		struct matrix_base<T, 2, 2>
+		{
+			union
+			{
+				struct
+				{
+					T m00, m01;
+					T m10, m11;
+				};
+
+				T data[2 * 2];
+			};
+
+			constexpr matrix_base()
+				: data()
+			{
+
+			}
+
+			template <typename... A>
+			constexpr matrix_base(const elements_tag, const A... values)
+				: data{ values... }
+			{
+
+			}
+		};
+
+		template <typename T>
+		struct matrix_base<T, 3, 3>
+		{
+			union
+			{
+				struct
+				{
+					T m00, m01, m02;
+					T m10, m11, m12;
+					T m20, m21, m22;
+				};
+
+				T data[3 * 3];
+			};
+
+			constexpr matrix_base()
+				: data()
+			{
+
+			}
+
+			template <typename... A>
+			constexpr matrix_base(const elements_tag, const A... values)
+				: data{ values... }
+			{
+
+			}
+		};
+
+		template <typename T>
+		struct matrix_base<T, 4, 4>
+		{
+			union
+			{
+				struct
+				{
+					T m00, m01, m02, m03;
+					T m10, m11, m12, m13;
+					T m20, m21, m22, m23;
+					T m30, m31, m32, m33;
+				};
+
+				T data[4 * 4];
+			};
+
+			constexpr matrix_base()
+				: data()
+			{
+
+			}
+
+			template <typename... A>
+			constexpr matrix_base(const elements_tag, const A... values)
+				: data{ values... }
+			{
+
+			}
+
+			// the transformations are defined in matrix4.h
+
+			// orthograpic pojection
+			static matrix_t<T, 4, 4> orthographic(
+				const float left,
+				const float right,
+				const float bottom,
+				const float top,
+				const float near_plane,
+				const float far_plane);
+
+			// perspective projection
+			static matrix_t<T, 4, 4> perspective(
+				const float fov,
+				const float aspect,
+				const float near_plane,
+				const float far_plane);
+
+			static vector_t<T, 3> unproject(
+				const vector_t<T, 3>& screencoords,
+				const matrix_t<T, 4, 4>& view,
+				const matrix_t<T, 4, 4>& projection,
+				const vector_t<T, 4>& viewport);
+
+			// translation matrix
+			static matrix_t<T, 4, 4> translate(const vector_t<T, 3>& vector);
+
+			// rotation
+			static matrix_t<T, 4, 4> rotate_x(const T theta);
+			static matrix_t<T, 4, 4> rotate_y(const T theta);
+			static matrix_t<T, 4, 4> rotate_z(const T theta);
+			static matrix_t<T, 4, 4> rotate(const vector_t<T, 3>& vector, const T theta);
+
+			// scale
+			static matrix_t<T, 4, 4> scale(const vector_t<T, 3>& vector);
+		};
+
+		// the minor of a 2x2 matrix is a scalar
+		template <typename T, std::size_t R, std::size_t C>
+		struct minor_type
+		{
+			typedef matrix_t<T, R - 1, C - 1> type;
+		};
+
+		template <typename T>
+		struct minor_type<T, 2, 2>
+		{
+			typedef T type;
+		};
+	}
+
+	// fixed size matrix, every operation is a loop over
+	// the rows and the columns that the compilers unroll,
+	// the square sizes up to 4 have closed form inverses
+	template <typename T, std::size_t R, std::size_t C>
+	struct matrix_t : detail::matrix_base<T, R, C>
+	{
+		static_assert(R > 1 && C > 1, "a matrix has at least 2 rows and 2 columns");
+
+		typedef detail::matrix_base<T, R, C> base;
+		using base::data;
+
+		static const matrix_t zero;
+		static const matrix_t identity;
+
+		// num of rows
+		static constexpr std::size_t rows = R;
+		// num of columns
+		static constexpr std::size_t columns = C;
+		// matrix size
+		static constexpr std::size_t length = R * C;
+
+		constexpr matrix_t()
+			: base()
+		{
+
+		}
+
+		constexpr matrix_t(const T value)
+			: matrix_t(value, std::make_index_sequence<R * C>())
+		{
+
+		}
+
+		// one value per element, row by row
+		template <typename... A, typename = typename std::enable_if<sizeof...(A) == R * C && detail::all_convertible<T, A...>::value>::type>
+		constexpr matrix_t(const A... values)
+			: base(detail::elements_tag(), static_cast<T>(values)...)
+		{
+
+		}
+
+		// precision conversion
+		template <typename U>
+		constexpr explicit matrix_t(const matrix_t<U, R, C>& matrix)
+			: matrix_t(matrix, std::make_index_sequence<R * C>())
+		{
+
+		}
+
+		constexpr matrix_t(const matrix_t& matrix) = default;
+
+		constexpr std::size_t size() const
+		{
+			return length;
+		}
+
+		// get (i,j) element
+		constexpr T& operator() (const unsigned int i, const unsigned int j)
+		{
+			// row major implementation
+			return data[i + j * C];
+		}
+
+		constexpr T operator() (const unsigned int i, const unsigned int j) const
+		{
+			return data[i + j * C];
+		}
+
+		// transpose matrix
+		constexpr matrix_t<T, C, R> transpose() const
+		{
+			matrix_t<T, C, R> MT;
+			for (std::size_t j = 0; j < R; ++j)
+			{
+				for (std::size_t i = 0; i < C; ++i)
+				{
+					MT.data[i * R + j] = data[j * C + i];
+				}
+			}
+			return MT;
+		}
+
+		// sub matrix without the column i and the row j
+		constexpr typename detail::minor_type<T, R, C>::type minor(const unsigned int i, const unsigned int j) const
+		{
+			assert(i < C && j < R);
+			if constexpr (R == 2 && C == 2)
+			{
+				return (*this)(i == 1 ? 0 : 1, j == 1 ? 0 : 1);
+			}
+			else
+			{
+				matrix_t<T, R - 1, C - 1> result;
+				for (std::size_t _j = 0, __j = 0; _j < R; ++_j)
+				{
+					if (_j == j) continue;
+					for (std::size_t _i = 0, __i = 0; _i < C; ++_i)
+					{
+						if (_i == i) continue;
+						result.data[__j * (C - 1) + __i] = data[_j * C + _i];
+						++__i;
+					}
+					++__j;
+				}
+				return result;
+			}
+		}
+
+		constexpr matrix_t inverse(bool& is_invertible) const
+		{
+			static_assert(R == C, "only square matrices can be inverted");
+			VDTMATH_PROFILE_COUNT(matrix_inverse, 1);
+			const matrix_t adj = adjugate();
+			// expansion along the first row
+			T d = data[0] * adj.data[0];
+			for (std::size_t k = 1; k < C; ++k)
+				d += data[k] * adj.data[k * C];
+			is_invertible = d != static_cast<T>(0.0);
+			if (!is_invertible)
+			{
+				return *this;
+			}
+			return adj * (static_cast<T>(1.0) / d);
+		}
+
+		// adjugate matrix, the transpose of the cofactors
+		constexpr matrix_t adjugate() const
+		{
+			static_assert(R == C, "the adjugate is defined for square matrices");
+			const T* const m = data;
+			if constexpr (R == 2)
+			{
+				return matrix_t(
+					m[3], -m[1],
+					-m[2], m[0]
+				);
+			}
+			else if constexpr (R == 3)
+			{
+				return matrix_t(
+					m[4] * m[8] - m[5] * m[7], m[2] * m[7] - m[1] * m[8], m[1] * m[5] - m[2] * m[4],
+					m[5] * m[6] - m[3] * m[8], m[0] * m[8] - m[2] * m[6], m[2] * m[3] - m[0] * m[5],
+					m[3] * m[7] - m[4] * m[6], m[1] * m[6] - m[0] * m[7], m[0] * m[4] - m[1] * m[3]
+				);
+			}
+			else if constexpr (R == 4)
+			{
+				// 2x2 determinants of the first two rows and of the last two rows
+				const T s0 = m[0] * m[5] - m[4] * m[1];
+				const T s1 = m[0] * m[6] - m[4] * m[2];
+				const T s2 = m[0] * m[7] - m[4] * m[3];
+				const T s3 = m[1] * m[6] - m[5] * m[2];
+				const T s4 = m[1] * m[7] - m[5] * m[3];
+				const T s5 = m[2] * m[7] - m[6] * m[3];
+				const T c5 = m[10] * m[15] - m[14] * m[11];
+				const T c4 = m[9] * m[15] - m[13] * m[11];
+				const T c3 = m[9] * m[14] - m[13] * m[10];
+				const T c2 = m[8] * m[15] - m[12] * m[11];
+				const T c1 = m[8] * m[14] - m[12] * m[10];
+				const T c0 = m[8] * m[13] - m[12] * m[9];
+				return matrix_t(
+					m[5] * c5 - m[6] * c4 + m[7] * c3, -m[1] * c5 + m[2] * c4 - m[3] * c3, m[13] * s5 - m[14] * s4 + m[15] * s3, -m[9] * s5 + m[10] * s4 - m[11] * s3,
+					-m[4] * c5 + m[6] * c2 - m[7] * c1, m[0] * c5 - m[2] * c2 + m[3] * c1, -m[12] * s5 + m[14] * s2 - m[15] * s1, m[8] * s5 - m[10] * s2 + m[11] * s1,
+					m[4] * c4 - m[5] * c2 + m[7] * c0, -m[0] * c4 + m[1] * c2 - m[3] * c0, m[12] * s4 - m[13] * s2 + m[15] * s0, -m[8] * s4 + m[9] * s2 - m[11] * s0,
+					-m[4] * c3 + m[5] * c1 - m[6] * c0, m[0] * c3 - m[1] * c1 + m[2] * c0, -m[12] * s3 + m[13] * s1 - m[14] * s0, m[8] * s3 - m[9] * s1 + m[10] * s0
+				);
+			}
+			else
+			{
+				matrix_t result;
+				for (std::size_t j = 0; j < R; ++j)
+				{
+					for (std::size_t i = 0; i < C; ++i)
+					{
+						// cofactor of the row i, column j
+						const T cofactor = minor(static_cast<unsigned int>(j), static_cast<unsigned int>(i)).determinant();
+						result.data[j * C + i] = ((i + j) & 1) ? -cofactor : cofactor;
+					}
+				}
+				return result;
+			}
+		}
+
+		// determinant
+		// the terms are summed in the written order, see deterministic.h
+		constexpr T determinant() const
+		{
+			static_assert(R == C, "the determinant is defined for square matrices");
+			const T* const m = data;
+			if constexpr (R == 2)
+			{
+				return m[0] * m[3] - m[1] * m[2];
+			}
+			else if constexpr (R == 3)
+			{
+				// Sarrus law
+				return (m[0] * m[4] * m[8]) + (m[1] * m[5] * m[6]) + (m[2] * m[3] * m[7])
+					- (m[6] * m[4] * m[2]) - (m[7] * m[5] * m[0]) - (m[8] * m[3] * m[1]);
+			}
+			else if constexpr (R == 4)
+			{
+				const T s0 = m[0] * m[5] - m[4] * m[1];
+				const T s1 = m[0] * m[6] - m[4] * m[2];
+				const T s2 = m[0] * m[7] - m[4] * m[3];
+				const T s3 = m[1] * m[6] - m[5] * m[2];
+				const T s4 = m[1] * m[7] - m[5] * m[3];
+				const T s5 = m[2] * m[7] - m[6] * m[3];
+				const T c5 = m[10] * m[15] - m[14] * m[11];
+				const T c4 = m[9] * m[15] - m[13] * m[11];
+				const T c3 = m[9] * m[14] - m[13] * m[10];
+				const T c2 = m[8] * m[15] - m[12] * m[11];
+				const T c1 = m[8] * m[14] - m[12] * m[10];
+				const T c0 = m[8] * m[13] - m[12] * m[9];
+				return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+			}
+			else
+			{
+				/* Laplace law */
+				T result{};
+				for (std::size_t i = 0; i < C; ++i)
+				{
+					const T d = data[i] * minor(static_cast<unsigned int>(i), 0).determinant();
+					result += (i & 1) ? -d : d;
+				}
+				return result;
+			}
+		}
+
+		/* Operators overloading */
+
+		constexpr matrix_t& operator= (const matrix_t& matrix) = default;
+
+		constexpr bool operator== (const matrix_t& matrix) const
+		{
+			for (std::size_t i = 0; i < length; ++i)
+				if (data[i] != matrix.data[i]) return false;
+			return true;
+		}
+
+		constexpr bool operator!= (const matrix_t& matrix) const
+		{
+			return !(*this == matrix);
+		}
+
+		constexpr matrix_t& operator+= (const matrix_t& matrix)
+		{
+			for (std::size_t i = 0; i < length; ++i)
+				data[i] += matrix.data[i];
+			return *this;
+		}
+
+		constexpr matrix_t& operator-= (const matrix_t& matrix)
+		{
+			for (std::size_t i = 0; i < length; ++i)
+				data[i] -= matrix.data[i];
+			return *this;
+		}
+
+		constexpr matrix_t& operator*= (const T scalar)
+		{
+			for (std::size_t i = 0; i < length; ++i)
+				data[i] *= scalar;
+			return *this;
+		}
+
+		constexpr matrix_t& operator/= (const T scalar)
+		{
+			assert(scalar != static_cast<T>(0.0));
+			const T f = static_cast<T>(1.0) / scalar;
+			return (*this) *= f;
+		}
+
+		constexpr matrix_t operator- () const
+		{
+			matrix_t result;
+			for (std::size_t i = 0; i < length; ++i)
+				result.data[i] = -data[i];
+			return result;
+		}
+
+		constexpr matrix_t operator+ (const matrix_t& matrix) const
+		{
+			matrix_t result;
+			for (std::size_t i = 0; i < length; ++i)
+				result.data[i] = data[i] + matrix.data[i];
+			return result;
+		}
+
+		constexpr matrix_t operator- (const matrix_t& matrix) const
+		{
+			matrix_t result;
+			for (std::size_t i = 0; i < length; ++i)
+				result.data[i] = data[i] - matrix.data[i];
+			return result;
+		}
+
+		constexpr matrix_t operator* (const T scalar) const
+		{
+			matrix_t result;
+			for (std::size_t i = 0; i < length; ++i)
+				result.data[i] = data[i] * scalar;
+			return result;
+		}
+
+		constexpr matrix_t operator/ (const T scalar) const
+		{
+			assert(scalar != static_cast<T>(0.0));
+			const T f = static_cast<T>(1.0) / scalar;
+			return (*this) * f;
+		}
+
+		// the products are summed from the first column to the last one,
+		// as the sse2 kernels do, see deterministic.h
+		template <std::size_t K>
+		constexpr matrix_t<T, R, K> operator* (const matrix_t<T, C, K>& matrix) const
+		{
+			VDTMATH_PROFILE_COUNT(matrix_multiply, 1);
+			matrix_t<T, R, K> result;
+			for (std::size_t r = 0; r < R; ++r)
+			{
+				for (std::size_t k = 0; k < K; ++k)
+				{
+					T value = data[r * C] * matrix.data[k];
+					for (std::size_t c = 1; c < C; ++c)
+						value += data[r * C + c] * matrix.data[c * K + k];
+					result.data[r * K + k] = value;
+				}
+			}
+			return result;
+		}
+
+		constexpr vector_t<T, R> operator* (const vector_t<T, C>& vector) const
+		{
+			vector_t<T, R> result;
+			for (std::size_t r = 0; r < R; ++r)
+			{
+				T value = data[r * C] * vector.data[0];
+				for (std::size_t c = 1; c < C; ++c)
+					value += data[r * C + c] * vector.data[c];
+				result.data[r] = value;
+			}
+			return result;
+		}
+
+	private:
+
+		template <std::size_t... I>
+		constexpr matrix_t(const T value, std::index_sequence<I...>)
+			: base(detail::elements_tag(), ((void)I, value)...)
+		{
+
+		}
+
+		template <typename U, std::size_t... I>
+		constexpr matrix_t(const matrix_t<U, R, C>& matrix, std::index_sequence<I...>)
+			: base(detail::elements_tag(), static_cast<T>(matrix.data[I])...)
+		{
+
+		}
+	};
+
+	namespace detail
+	{
+		template <typename T, std::size_t R, std::size_t C>
+		constexpr matrix_t<T, R, C> identity()
+		{
+			matrix_t<T, R, C> result;
+			for (std::size_t i = 0; i < R && i < C; ++i)
+				result.data[i * C + i] = static_cast<T>(1.0);
+			return result;
+		}
+	}
+
+	template <typename T, std::size_t R, std::size_t C> const matrix_t<T, R, C> matrix_t<T, R, C>::zero = matrix_t<T, R, C>();
+	template <typename T, std::size_t R, std::size_t C> const matrix_t<T, R, C> matrix_t<T, R, C>::identity = detail::identity<T, R, C>();
+}
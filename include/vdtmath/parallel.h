@@ -0,0 +1,156 @@
+/// Copyright (c) Vito Domenico Tagliente
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "affine3.h"
+#include "config.h"
+#include "matrix4.h"
+#include "transform.h"
+#include "vector3.h"
+#include "vector4.h"
+
+#if defined(VDTMATH_PROFILE)
+#include "profile.h"
+#endif
+
+namespace math
+{
+	// multithreaded batches
+	// the work is split in chunks that run on an executor, the built-in
+	// thread_pool by default or the job system of the application through
+	// set_executor, the batch functions below are the ones of kernels.h
+	// spread over the chunks
+
+	// runs count tasks and returns when all of them are done,
+	// the calling thread can run tasks as well
+	class executor
+	{
+	public:
+
+		virtual ~executor() = default;
+
+		// the number of threads running the tasks, the caller included
+		virtual std::size_t concurrency() const = 0;
+
+		virtual void run(const std::size_t count, void (*task)(void* context, const std::size_t index), void* context) = 0;
+	};
+
+	// worker threads waiting for runs, the tasks of a run are taken in
+	// order from a shared counter by the workers and the caller, so the
+	// threads that finish early take the remaining tasks
+	// a run started from a task of the same pool runs on the calling thread
+	class thread_pool : public executor
+	{
+	public:
+
+		// 0 for one thread per hardware thread, the caller included
+		VDTMATH_API explicit thread_pool(const std::size_t threads = 0);
+		VDTMATH_API ~thread_pool();
+
+		thread_pool(const thread_pool&) = delete;
+		thread_pool& operator= (const thread_pool&) = delete;
+
+		std::size_t concurrency() const override { return m_threads.size() + 1; }
+
+		VDTMATH_API void run(const std::size_t count, void (*task)(void* context, const std::size_t index), void* context) override;
+
+	private:
+
+		VDTMATH_API void work();
+		VDTMATH_API void execute();
+
+		std::vector<std::thread> m_threads;
+		// one run at a time
+		std::mutex m_runMutex;
+		std::mutex m_mutex;
+		std::condition_variable m_wake;
+		std::condition_variable m_done;
+		void (*m_task)(void* context, const std::size_t index);
+		void* m_context;
+		std::size_t m_count;
+		std::atomic<std::size_t> m_next;
+		std::size_t m_active;
+		std::uint64_t m_generation;
+		bool m_stop;
+	};
+
+	// the pool created on first use
+	VDTMATH_API executor& default_executor();
+
+	// the executor of parallel_for, nullptr restores the default one
+	// the executor must outlive its use
+	VDTMATH_API void set_executor(executor* instance);
+	VDTMATH_API executor& current_executor();
+
+	// size of the cache of a core, the L2, 256 KiB when unknown
+	VDTMATH_API std::size_t cache_size();
+
+	// elements per chunk for a batch, a multiple of granularity:
+	// enough chunks to balance the threads, each one at least 16 KiB
+	// for the scheduling to be negligible and, when possible, at most
+	// half of the cache so that the chunk stays in it between the
+	// kernel passes
+	VDTMATH_API std::size_t chunk_size(const std::size_t count, const std::size_t bytes_per_element, const std::size_t granularity = 1);
+
+	// function(begin, end) for the chunks of [0, count)
+	template <typename F>
+	inline void parallel_for(const std::size_t count, const std::size_t chunk, const F& function)
+	{
+		assert(chunk > 0);
+		if (count == 0) return;
+		const std::size_t chunks = (count + chunk - 1) / chunk;
+		if (chunks == 1)
+		{
+			function(std::size_t(0), count);
+			return;
+		}
+
+		struct range
+		{
+			const F* function;
+			std::size_t count;
+			std::size_t chunk;
+		};
+		range context{ &function, count, chunk };
+		current_executor().run(chunks, [](void* c, const std::size_t index)
+			{
+				const range& r = *static_cast<const range*>(c);
+				const std::size_t begin = index * r.chunk;
+				(*r.function)(begin, std::min(begin + r.chunk, r.count));
+			}, &context);
+	}
+
+	// the batch kernels, see kernels.h
+
+	VDTMATH_API void parallel_multiply(const matrix4* a, const matrix4* b, matrix4* result, const std::size_t count);
+	VDTMATH_API void parallel_transform_points(const matrix4& matrix, const vector3* points, vector3* result, const std::size_t count);
+	VDTMATH_API void parallel_transform_points(const affine3& affine, const vector3* points, vector3* result, const std::size_t count);
+	VDTMATH_API void parallel_normalize(vector3* vectors, const std::size_t count);
+	VDTMATH_API std::size_t parallel_cull_spheres(const vector4* planes, const vector4* spheres, const std::size_t count, std::uint8_t* mask);
+
+	// transform_t::update of every transform
+	template <typename T>
+	inline void parallel_update(transform_t<T>* transforms, const std::size_t count)
+	{
+		VDTMATH_PROFILE_SCOPE("parallel_update", count);
+		parallel_for(count, chunk_size(count, sizeof(transform_t<T>)), [transforms](const std::size_t begin, const std::size_t end)
+			{
+				for (std::size_t i = begin; i < end; ++i)
+					transforms[i].update();
+			});
+	}
+}
+
+#if defined(VDTMATH_HEADER_ONLY)
+#include "../../source/parallel.cpp"
+#endif
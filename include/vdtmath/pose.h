@@ -0,0 +1,84 @@
+/// Copyright (c) Vito Domenico Tagliente
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include "aligned_array.h"
+#include "config.h"
+#include "matrix4.h"
+#include "trs.h"
+
+namespace math
+{
+	// skeletal poses
+	// the joints are sorted parent first, every parent index is lower than
+	// the index of its joint and the roots have -1, so the model matrices
+	// are computed in one linear pass:
+	//     model[i] = compose(local[i]) * model[parent[i]]
+	//     palette[i] = inverse_bind[i] * model[i]
+	// the skeleton is shared and read only, the poses of different
+	// characters can be updated concurrently
+
+	// the pass over the joints, the kernel of the active simd level, see cpu.h
+	// the roots are placed by the root matrix, palette and inverse_bind
+	// can be null when the skinning palette is not needed
+	VDTMATH_API void pose_matrices(const trs* locals, const std::int32_t* parents, const matrix4* inverse_bind, const matrix4& root, matrix4* model, matrix4* palette, const std::size_t count);
+
+	// true if every parent comes before its joint
+	VDTMATH_API bool is_parent_first(const std::int32_t* parents, const std::size_t count);
+
+	class skeleton
+	{
+	public:
+
+		VDTMATH_API skeleton();
+
+		// false if the joints are not sorted parent first
+		VDTMATH_API bool set(const std::int32_t* parents, const matrix4* inverse_bind, const std::size_t count);
+
+		std::size_t joint_count() const { return m_parents.size(); }
+		const std::int32_t* parents() const { return m_parents.data(); }
+		const matrix4* inverse_bind() const { return m_inverseBind.data(); }
+
+	private:
+
+		aligned_array<std::int32_t> m_parents;
+		aligned_array<matrix4> m_inverseBind;
+	};
+
+	// the local transformations of the joints of a skeleton
+	// and the matrices computed from them
+	class pose
+	{
+	public:
+
+		// the skeleton must outlive the pose, the locals are identities
+		VDTMATH_API explicit pose(const skeleton& skeleton);
+
+		std::size_t joint_count() const { return m_locals.size(); }
+
+		trs* locals() { return m_locals.data(); }
+		const trs* locals() const { return m_locals.data(); }
+
+		// the results of the last update
+		const matrix4* model() const { return m_model.data(); }
+		const matrix4* palette() const { return m_palette.data(); }
+
+		// model matrices and skinning palette in one pass
+		VDTMATH_API void update(const matrix4& root = matrix4::identity);
+
+	private:
+
+		const skeleton* m_skeleton;
+		aligned_array<trs> m_locals;
+		aligned_array<matrix4> m_model;
+		aligned_array<matrix4> m_palette;
+	};
+}
+
+#if defined(VDTMATH_HEADER_ONLY)
+#include "../../source/pose.cpp"
+#endif
@@ -0,0 +1,208 @@
+/// Copyright (c) Vito Domenico Tagliente
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include "config.h"
+
+namespace math
+{
+	// instrumentation, compiled in with VDTMATH_PROFILE
+	// the library counts its matrix products, inversions and transform
+	// updates and times its batch kernels, the events of the timers go to
+	// the sink set by set_profile_sink
+	// every thread has its own counters, incremented without atomic
+	// read-modify-write, the reads sum the ones of all the threads
+	// without VDTMATH_PROFILE the hooks expand to nothing, no event is
+	// sent and the counters stay at zero, but the ones of transform_t::update
+	// which are always on, only the rebuild times need VDTMATH_PROFILE
+
+	enum class profile_counter
+	{
+		// matrix_t products, one per matrix of the batch kernels
+		matrix_multiply,
+		// matrix_t and affine inversions
+		matrix_inverse,
+		// transform_t::update calls rebuilding the matrix
+		transform_rebuild,
+		// transform_t::update calls of a transform that was static already
+		transform_static_skip,
+		// transform_t::update calls without changes since the last one
+		transform_unchanged_skip,
+		count
+	};
+
+	VDTMATH_API const char* to_string(const profile_counter counter);
+
+	// the sum over the threads, the running ones included
+	VDTMATH_API std::uint64_t profile_count(const profile_counter counter);
+	// the counters and the transform statistics
+	VDTMATH_API void reset_profile_counters();
+
+	// transform_t::update of all the transforms, to choose the ones to
+	// mark static: the skip counters and the time of the rebuilds
+	constexpr std::size_t rebuild_histogram_size = 16;
+
+	// the rebuilds of the bucket i of the histogram take less than
+	// rebuild_bound(i) nanoseconds, and at least rebuild_bound(i - 1),
+	// the last bucket has the longer ones
+	constexpr std::uint64_t rebuild_bound(const std::size_t i)
+	{
+		return std::uint64_t(32) << i;
+	}
+
+	struct transform_statistics
+	{
+		std::uint64_t rebuilds;
+		std::uint64_t static_skips;
+		std::uint64_t unchanged_skips;
+		// nanoseconds, the time and the histogram with VDTMATH_PROFILE only
+		std::uint64_t rebuild_time;
+		std::uint64_t rebuild_histogram[rebuild_histogram_size];
+	};
+
+	VDTMATH_API transform_statistics transform_telemetry();
+
+	// a timed scope, the times in nanoseconds from the first event
+	struct profile_event
+	{
+		const char* name;
+		std::uint64_t begin;
+		std::uint64_t duration;
+		// 1 for the first thread recording an event, 2 for the next one...
+		std::uint32_t thread;
+		// the elements processed, 0 when not relevant
+		std::size_t count;
+	};
+
+	// receives the events, record can be called from any thread
+	class profile_sink
+	{
+	public:
+
+		virtual ~profile_sink() = default;
+
+		virtual void record(const profile_event& event) = 0;
+	};
+
+	// the sink must outlive its use, nullptr disables the timers
+	VDTMATH_API void set_profile_sink(profile_sink* sink);
+	VDTMATH_API profile_sink* current_profile_sink();
+
+	// forwards the events to a function
+	class callback_sink : public profile_sink
+	{
+	public:
+
+		callback_sink(void (*callback)(const profile_event& event, void* context), void* context)
+			: m_callback(callback)
+			, m_context(context)
+		{
+
+		}
+
+		void record(const profile_event& event) override { m_callback(event, m_context); }
+
+	private:
+
+		void (*m_callback)(const profile_event& event, void* context);
+		void* m_context;
+	};
+
+	// collects the events for the trace viewer of chrome and perfetto,
+	// the json object format with complete events
+	class chrome_trace_sink : public profile_sink
+	{
+	public:
+
+		VDTMATH_API void record(const profile_event& event) override;
+
+		VDTMATH_API std::size_t size() const;
+		VDTMATH_API void clear();
+
+		VDTMATH_API void write(std::ostream& stream) const;
+		// false if the file cannot be written
+		VDTMATH_API bool save(const char* path) const;
+
+	private:
+
+		mutable std::mutex m_mutex;
+		std::vector<profile_event> m_events;
+	};
+
+	// records an event for its lifetime if a sink is set
+	class scoped_timer
+	{
+	public:
+
+		VDTMATH_API scoped_timer(const char* name, const std::size_t count = 0);
+		VDTMATH_API ~scoped_timer();
+
+		scoped_timer(const scoped_timer&) = delete;
+		scoped_timer& operator= (const scoped_timer&) = delete;
+
+	private:
+
+		profile_sink* m_sink;
+		const char* m_name;
+		std::size_t m_count;
+		std::uint64_t m_begin;
+	};
+
+	namespace detail
+	{
+		// the constexpr functions do not count during constant evaluation,
+		// the older compilers cannot evaluate them at compile time in the
+		// profile build
+		constexpr bool is_constant_evaluated()
+		{
+#if (defined(__clang__) && __clang_major__ >= 9) || (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+			return __builtin_is_constant_evaluated();
+#else
+			return false;
+#endif
+		}
+
+		VDTMATH_API void profile_add(const profile_counter counter, const std::uint64_t value);
+
+		// nanoseconds from the first call
+		VDTMATH_API std::uint64_t profile_now();
+
+		// times a transform rebuild, for transform_telemetry
+		class rebuild_timer
+		{
+		public:
+
+			rebuild_timer() : m_begin(profile_now()) {}
+			VDTMATH_API ~rebuild_timer();
+
+			rebuild_timer(const rebuild_timer&) = delete;
+			rebuild_timer& operator= (const rebuild_timer&) = delete;
+
+		private:
+
+			std::uint64_t m_begin;
+		};
+	}
+}
+
+// the hooks, see config.h for the disabled ones
+#if defined(VDTMATH_PROFILE)
+#define VDTMATH_PROFILE_CONCAT_(a, b) a##b
+#define VDTMATH_PROFILE_CONCAT(a, b) VDTMATH_PROFILE_CONCAT_(a, b)
+// adds value to a profile_counter
+#define VDTMATH_PROFILE_COUNT(counter, value) (::math::detail::is_constant_evaluated() ? (void)0 : ::math::detail::profile_add(::math::profile_counter::counter, value))
+// times the rest of the scope
+#define VDTMATH_PROFILE_SCOPE(name, count) const ::math::scoped_timer VDTMATH_PROFILE_CONCAT(vdtmath_profile_, __LINE__)(name, count)
+// times the rest of the scope of a transform rebuild
+#define VDTMATH_PROFILE_REBUILD() const ::math::detail::rebuild_timer VDTMATH_PROFILE_CONCAT(vdtmath_profile_, __LINE__)
+#endif
+
+#if defined(VDTMATH_HEADER_ONLY)
+#include "../../source/profile.cpp"
+#endif
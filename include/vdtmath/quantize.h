@@ -0,0 +1,391 @@
+/// Copyright (c) Vito Domenico Tagliente
+
+#pragma once
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "config.h"
+#include "quaternion.h"
+#include "vector3.h"
+#include "vector4.h"
+
+namespace math
+{
+	// compressed representations of float vectors and quaternions,
+	// for network snapshots and animation tracks
+	//
+	//     half float       16 bits per component, relative error 2^-11,
+	//                      normal range 6.1e-5 .. 65504, larger values
+	//                      become infinite
+	//     octahedral       unit vectors in 16 (8 + 8) or 32 (16 + 16) bits,
+	//                      max angular error 0.96 and 0.0037 degrees
+	//     smallest three   unit quaternions in 32 (2 + 3 x 10) or
+	//                      48 (2 + 3 x 15) bits, max component error
+	//                      1.9e-3 and 6.1e-5, rotation error 0.26 and
+	//                      0.0082 degrees
+	//     fixed point      positions inside a box with up to 16 bits per
+	//                      axis, max error half a step, see position_quantizer
+	//
+	// the error bounds are measured over millions of random inputs
+	// the scalar functions are the reference, the batch ones run the
+	// kernels of the active simd level, see cpu.h, and produce the same
+	// codes, the decoded values can differ by the float rounding
+
+	struct half3
+	{
+		std::uint16_t x, y, z;
+	};
+
+	struct half4
+	{
+		std::uint16_t x, y, z, w;
+	};
+
+	// smallest three quaternion in 48 bits
+	struct packed_quaternion48
+	{
+		std::uint16_t data[3];
+	};
+
+	// fixed point position, see position_quantizer
+	struct packed_position
+	{
+		std::uint16_t x, y, z;
+	};
+
+	namespace detail
+	{
+		inline std::uint32_t float_bits(const float value)
+		{
+			std::uint32_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			return bits;
+		}
+
+		inline float bits_float(const std::uint32_t bits)
+		{
+			float value;
+			std::memcpy(&value, &bits, sizeof(value));
+			return value;
+		}
+
+		// round to the nearest integer, half away from zero, as the kernels
+		inline int round_to_int(const float value)
+		{
+			return static_cast<int>(value + (value < 0.f ? -.5f : .5f));
+		}
+	}
+
+	// round to nearest even, NaN becomes the quiet NaN 0x7e00 with its sign
+	inline std::uint16_t to_half(const float value)
+	{
+		std::uint32_t f = detail::float_bits(value);
+		const std::uint32_t sign = f & 0x80000000u;
+		f ^= sign;
+
+		std::uint32_t result;
+		if (f >= 0x47800000u)
+		{
+			// overflow and infinity, or NaN
+			result = f > 0x7f800000u ? 0x7e00u : 0x7c00u;
+		}
+		else if (f < 0x38800000u)
+		{
+			// subnormal or zero, the float addition does the rounding
+			result = detail::float_bits(detail::bits_float(f) + detail::bits_float(0x3f000000u)) - 0x3f000000u;
+		}
+		else
+		{
+			// rebias the exponent and round the mantissa to nearest even
+			const std::uint32_t odd = (f >> 13) & 1u;
+			f += 0xc8000fffu + odd;
+			result = f >> 13;
+		}
+		return static_cast<std::uint16_t>(result | (sign >> 16));
+	}
+
+	// NaN becomes the quiet NaN 0x7fc00000 with its sign, as by to_half
+	inline float from_half(const std::uint16_t value)
+	{
+		const std::uint32_t h = value;
+		std::uint32_t f = (h & 0x7fffu) << 13;
+		const std::uint32_t exponent = f & 0x0f800000u;
+		f += 0x38000000u;
+		if (exponent == 0x0f800000u)
+		{
+			// infinity or NaN
+			f = (h & 0x03ffu) != 0 ? 0x7fc00000u : 0x7f800000u;
+		}
+		else if (exponent == 0)
+		{
+			// subnormal or zero
+			f = detail::float_bits(detail::bits_float(f + 0x00800000u) - detail::bits_float(0x38800000u));
+		}
+		return detail::bits_float(f | ((h & 0x8000u) << 16));
+	}
+
+	inline half3 to_half(const vector3& vector)
+	{
+		return { to_half(vector.x), to_half(vector.y), to_half(vector.z) };
+	}
+
+	inline half4 to_half(const vector4& vector)
+	{
+		return { to_half(vector.x), to_half(vector.y), to_half(vector.z), to_half(vector.w) };
+	}
+
+	inline vector3 from_half(const half3& vector)
+	{
+		return vector3(from_half(vector.x), from_half(vector.y), from_half(vector.z));
+	}
+
+	inline vector4 from_half(const half4& vector)
+	{
+		return vector4(from_half(vector.x), from_half(vector.y), from_half(vector.z), from_half(vector.w));
+	}
+
+	namespace detail
+	{
+		// project the unit sphere on the octahedron and unfold it on the square
+		inline void octahedral_project(const vector3& normal, float& u, float& v)
+		{
+			const float l = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+			u = normal.x / l;
+			v = normal.y / l;
+			if (normal.z < 0.f)
+			{
+				const float fu = (1.f - std::abs(v)) * (u >= 0.f ? 1.f : -1.f);
+				const float fv = (1.f - std::abs(u)) * (v >= 0.f ? 1.f : -1.f);
+				u = fu;
+				v = fv;
+			}
+		}
+
+		inline vector3 octahedral_unproject(float u, float v)
+		{
+			const float z = 1.f - std::abs(u) - std::abs(v);
+			const float t = z < 0.f ? -z : 0.f;
+			u += u >= 0.f ? -t : t;
+			v += v >= 0.f ? -t : t;
+			const float f = 1.f / std::sqrt(u * u + v * v + z * z);
+			return vector3(u * f, v * f, z * f);
+		}
+	}
+
+	// the normal must have a non zero length
+	inline std::uint16_t encode_octahedral16(const vector3& normal)
+	{
+		float u, v;
+		detail::octahedral_project(normal, u, v);
+		const std::uint32_t x = static_cast<std::uint8_t>(static_cast<std::int8_t>(detail::round_to_int(u * 127.f)));
+		const std::uint32_t y = static_cast<std::uint8_t>(static_cast<std::int8_t>(detail::round_to_int(v * 127.f)));
+		return static_cast<std::uint16_t>(x | (y << 8));
+	}
+
+	// the normal must have a non zero length
+	inline std::uint32_t encode_octahedral32(const vector3& normal)
+	{
+		float u, v;
+		detail::octahedral_project(normal, u, v);
+		const std::uint32_t x = static_cast<std::uint16_t>(static_cast<std::int16_t>(detail::round_to_int(u * 32767.f)));
+		const std::uint32_t y = static_cast<std::uint16_t>(static_cast<std::int16_t>(detail::round_to_int(v * 32767.f)));
+		return x | (y << 16);
+	}
+
+	inline vector3 decode_octahedral(const std::uint16_t value)
+	{
+		const float u = static_cast<std::int8_t>(value & 0xffu) / 127.f;
+		const float v = static_cast<std::int8_t>(value >> 8) / 127.f;
+		return detail::octahedral_unproject(u, v);
+	}
+
+	inline vector3 decode_octahedral(const std::uint32_t value)
+	{
+		const float u = static_cast<std::int16_t>(value & 0xffffu) / 32767.f;
+		const float v = static_cast<std::int16_t>(value >> 16) / 32767.f;
+		return detail::octahedral_unproject(u, v);
+	}
+
+	namespace detail
+	{
+		// the largest component is dropped and rebuilt from the unit length,
+		// the other ones are within +-1/sqrt(2) and quantized on Bits bits
+		template <unsigned int Bits>
+		inline std::uint64_t encode_smallest_three(const quaternion& q)
+		{
+			const float c[4] = { q.x, q.y, q.z, q.w };
+			unsigned int largest = 0;
+			for (unsigned int i = 1; i < 4; ++i)
+			{
+				if (std::abs(c[i]) > std::abs(c[largest])) largest = i;
+			}
+			// q and -q are the same rotation, the dropped component is positive
+			const float sign = c[largest] < 0.f ? -1.f : 1.f;
+			const float scale = static_cast<float>((1u << Bits) - 1) * .5f;
+
+			std::uint64_t result = largest;
+			unsigned int shift = 2;
+			for (unsigned int i = 0; i < 4; ++i)
+			{
+				if (i == largest) continue;
+				float value = (c[i] * sign * 1.41421356f + 1.f) * scale;
+				value = value < 0.f ? 0.f : (value > 2.f * scale ? 2.f * scale : value);
+				result |= static_cast<std::uint64_t>(value + .5f) << shift;
+				shift += Bits;
+			}
+			return result;
+		}
+
+		template <unsigned int Bits>
+		inline quaternion decode_smallest_three(const std::uint64_t value)
+		{
+			const unsigned int largest = static_cast<unsigned int>(value & 3u);
+			const std::uint64_t mask = (std::uint64_t(1) << Bits) - 1;
+			const float scale = 2.f / static_cast<float>(mask);
+
+			float c[4];
+			float sum = 0.f;
+			unsigned int shift = 2;
+			for (unsigned int i = 0; i < 4; ++i)
+			{
+				if (i == largest) continue;
+				c[i] = (static_cast<float>((value >> shift) & mask) * scale - 1.f) * .707106781f;
+				sum += c[i] * c[i];
+				shift += Bits;
+			}
+			c[largest] = std::sqrt(sum < 1.f ? 1.f - sum : 0.f);
+			return quaternion(c[0], c[1], c[2], c[3]);
+		}
+	}
+
+	// the quaternion must be normalized
+	inline std::uint32_t encode_quaternion32(const quaternion& q)
+	{
+		return static_cast<std::uint32_t>(detail::encode_smallest_three<10>(q));
+	}
+
+	// the quaternion must be normalized
+	inline packed_quaternion48 encode_quaternion48(const quaternion& q)
+	{
+		const std::uint64_t bits = detail::encode_smallest_three<15>(q);
+		return { { static_cast<std::uint16_t>(bits), static_cast<std::uint16_t>(bits >> 16), static_cast<std::uint16_t>(bits >> 32) } };
+	}
+
+	inline quaternion decode_quaternion(const std::uint32_t value)
+	{
+		return detail::decode_smallest_three<10>(value);
+	}
+
+	inline quaternion decode_quaternion(const packed_quaternion48& value)
+	{
+		const std::uint64_t bits = value.data[0]
+			| (static_cast<std::uint64_t>(value.data[1]) << 16)
+			| (static_cast<std::uint64_t>(value.data[2]) << 32);
+		return detail::decode_smallest_three<15>(bits);
+	}
+
+	// fixed point positions inside a box, each axis is split in
+	// 2^bits - 1 steps, the positions outside are clamped to the box
+	struct position_quantizer
+	{
+		vector3 min;
+		// size of a step on each axis
+		vector3 step;
+		vector3 inverse_step;
+		// the largest code, 2^bits - 1
+		float max_code;
+
+		position_quantizer(const vector3& min, const vector3& max, const unsigned int bits = 16)
+			: min(min)
+			, step()
+			, inverse_step()
+			, max_code(static_cast<float>((1u << bits) - 1))
+		{
+			assert(bits > 0 && bits <= 16);
+			const vector3 extent = max - min;
+			for (unsigned int i = 0; i < 3; ++i)
+			{
+				assert(extent[i] >= 0.f);
+				step[i] = extent[i] / max_code;
+				inverse_step[i] = extent[i] > 0.f ? max_code / extent[i] : 0.f;
+			}
+		}
+
+		// max distance on each axis between a position inside
+		// the box and its decoding, up to the float rounding
+		vector3 error() const
+		{
+			return step * .5f;
+		}
+
+		packed_position encode(const vector3& position) const
+		{
+			std::uint16_t code[3];
+			for (unsigned int i = 0; i < 3; ++i)
+			{
+				float value = (position[i] - min[i]) * inverse_step[i];
+				value = value < 0.f ? 0.f : (value > max_code ? max_code : value);
+				code[i] = static_cast<std::uint16_t>(value + .5f);
+			}
+			return { code[0], code[1], code[2] };
+		}
+
+		vector3 decode(const packed_position& position) const
+		{
+			return vector3(
+				min.x + position.x * step.x,
+				min.y + position.y * step.y,
+				min.z + position.z * step.z
+			);
+		}
+	};
+
+	// batch encoding and decoding, the results cannot alias the inputs
+
+	VDTMATH_API void encode_half(const float* values, std::uint16_t* result, const std::size_t count);
+	VDTMATH_API void decode_half(const std::uint16_t* values, float* result, const std::size_t count);
+
+	static_assert(sizeof(vector3) == 3 * sizeof(float) && sizeof(half3) == 3 * sizeof(std::uint16_t), "vector3 and half3 arrays are arrays of scalars");
+	static_assert(sizeof(vector4) == 4 * sizeof(float) && sizeof(half4) == 4 * sizeof(std::uint16_t), "vector4 and half4 arrays are arrays of scalars");
+
+	inline void encode_half(const vector3* vectors, half3* result, const std::size_t count)
+	{
+		encode_half(vectors[0].data, &result[0].x, count * 3);
+	}
+
+	inline void decode_half(const half3* vectors, vector3* result, const std::size_t count)
+	{
+		decode_half(&vectors[0].x, result[0].data, count * 3);
+	}
+
+	inline void encode_half(const vector4* vectors, half4* result, const std::size_t count)
+	{
+		encode_half(vectors[0].data, &result[0].x, count * 4);
+	}
+
+	inline void decode_half(const half4* vectors, vector4* result, const std::size_t count)
+	{
+		decode_half(&vectors[0].x, result[0].data, count * 4);
+	}
+
+	VDTMATH_API void encode_octahedral(const vector3* normals, std::uint16_t* result, const std::size_t count);
+	VDTMATH_API void encode_octahedral(const vector3* normals, std::uint32_t* result, const std::size_t count);
+	VDTMATH_API void decode_octahedral(const std::uint16_t* values, vector3* result, const std::size_t count);
+	VDTMATH_API void decode_octahedral(const std::uint32_t* values, vector3* result, const std::size_t count);
+
+	VDTMATH_API void encode_quaternions(const quaternion* quaternions, std::uint32_t* result, const std::size_t count);
+	VDTMATH_API void encode_quaternions(const quaternion* quaternions, packed_quaternion48* result, const std::size_t count);
+	VDTMATH_API void decode_quaternions(const std::uint32_t* values, quaternion* result, const std::size_t count);
+	VDTMATH_API void decode_quaternions(const packed_quaternion48* values, quaternion* result, const std::size_t count);
+
+	VDTMATH_API void encode_positions(const position_quantizer& quantizer, const vector3* positions, packed_position* result, const std::size_t count);
+	VDTMATH_API void decode_positions(const position_quantizer& quantizer, const packed_position* positions, vector3* result, const std::size_t count);
+}
+
+#if defined(VDTMATH_HEADER_ONLY)
+#include "kernels.h"
+#endif
@@ -10,67 +10,93 @@
 
 namespace math
 {
-	struct quaternion
+	// the members are defined in quaternion.cpp, 
+	// instantiated for float and double
+	template <typename T>
+	struct quaternion_t
 	{
-		static const quaternion identity;
+		static const quaternion_t identity;
 
 		union
 		{
 			struct
 			{
-				float x, y, z, w;
+				T x, y, z, w;
 			};
 
-			float data[4];
+			T data[4];
 		};
 
-		quaternion();
-		quaternion(const vector3& vector, const float scalar);
-		quaternion(const float _x, const float _y, const float _z, const float _w = 1.0f);
+		quaternion_t();
+		quaternion_t(const vector3_t<T>& vector, const T scalar);
+		quaternion_t(const T _x, const T _y, const T _z, const T _w = static_cast<T>(1.0));
+
+		// precision conversion
+		template <typename U>
+		explicit quaternion_t(const quaternion_t<U>& quaternion)
+			: x(static_cast<T>(quaternion.x))
+			, y(static_cast<T>(quaternion.y))
+			, z(static_cast<T>(quaternion.z))
+			, w(static_cast<T>(quaternion.w))
+		{
+
+		}
 
-		float dot(const quaternion& quaternion) const;
+		T dot(const quaternion_t& quaternion) const;
 
-		quaternion cross(const quaternion& quaternion) const;
+		quaternion_t cross(const quaternion_t& quaternion) const;
 
-		matrix4 matrix() const;
+		matrix4_t<T> matrix() const;
 
-		vector4 axisAngle() const;
+		vector4_t<T> axisAngle() const;
 
 		// operators overloading
 
-		quaternion& operator= (const quaternion& quaternion);
+		quaternion_t& operator= (const quaternion_t& quaternion) = default;
 
-		bool operator== (const quaternion& quaternion) const;
-		bool operator!= (const quaternion& quaternion) const;
+		bool operator== (const quaternion_t& quaternion) const;
+		bool operator!= (const quaternion_t& quaternion) const;
 
-		quaternion operator- ();
+		quaternion_t operator- ();
 
-		quaternion operator+ (const quaternion& quaternion) const;
+		quaternion_t operator+ (const quaternion_t& quaternion) const;
 
-		quaternion& operator+= (const quaternion& quaternion);
-		quaternion& operator-= (const quaternion& quaternion);
+		quaternion_t& operator+= (const quaternion_t& quaternion);
+		quaternion_t& operator-= (const quaternion_t& quaternion);
 
-		quaternion operator* (const float scalar) const;
+		quaternion_t operator* (const T scalar) const;
 
-		quaternion& operator*= (const float scalar);
+		quaternion_t& operator*= (const T scalar);
 
-		quaternion operator/ (const float scalar) const;
+		quaternion_t operator/ (const T scalar) const;
 
-		quaternion& operator/= (const float scalar);
+		quaternion_t& operator/= (const T scalar);
 
-		float length() const;
+		T length() const;
 
-		quaternion normalize() const;
+		quaternion_t normalize() const;
 
-		quaternion inverse() const;
+		quaternion_t inverse() const;
 
-		float operator* (const quaternion& quaternion) const;
-		vector3 operator* (const vector3& vector) const;
-		vector4 operator* (const vector4& vector) const;
+		T operator* (const quaternion_t& quaternion) const;
+		vector3_t<T> operator* (const vector3_t<T>& vector) const;
+		vector4_t<T> operator* (const vector4_t<T>& vector) const;
 	};
 
-	inline quaternion operator* (const float scalar, const quaternion& quaternion)
+	template <typename T>
+	inline quaternion_t<T> operator* (const T scalar, const quaternion_t<T>& quaternion)
 	{
 		return quaternion * scalar;
 	}
-}
\ No newline at end of file
+
+	// quaternion types
+
+	typedef quaternion_t<float> quaternion;
+	typedef quaternion quat;
+	typedef quaternion_t<double> dquaternion;
+	typedef dquaternion dquat;
+}
+
+#if defined(VDTMATH_HEADER_ONLY)
+#include "../../source/quaternion.cpp"
+#endif
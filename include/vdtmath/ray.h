@@ -0,0 +1,394 @@
+/// Copyright (c) Vito Domenico Tagliente
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+#include "circle.h"
+#include "rectangle.h"
+#include "vector2.h"
+#include "vector3.h"
+
+namespace math
+{
+	// the hit distances are expressed in units of the ray direction,
+	// they are world distances when the direction is normalized
+	// max_distance limits the cast, a segment is a ray with max_distance 1
+
+	namespace detail
+	{
+		// clips [nearest, farthest] by the slab [min, max] of an axis,
+		// a ray parallel to the slab has an infinite inverse and is inside
+		// it or not at all, the origin on a plane would give 0 * inf = nan
+		template <typename T>
+		inline void clip_slab(const T min, const T max, const T origin, const T inv_direction, T& nearest, T& farthest)
+		{
+			const T infinity = std::numeric_limits<T>::infinity();
+			const T t0 = (min - origin) * inv_direction;
+			const T t1 = (max - origin) * inv_direction;
+			const bool parallel = std::abs(inv_direction) == infinity;
+			const bool inside = (min <= origin) & (origin <= max);
+			nearest = std::max(nearest, parallel ? (inside ? -infinity : infinity) : std::min(t0, t1));
+			farthest = std::min(farthest, parallel ? (inside ? infinity : -infinity) : std::max(t0, t1));
+		}
+
+		// the determinant of Moller-Trumbore is the triple product of the
+		// direction and the edges, it is compared with their lengths so
+		// that the test does not depend on the size of the triangle
+		template <typename T>
+		inline bool parallel_to_triangle(const T determinant, const T lengths)
+		{
+			const T epsilon = std::numeric_limits<T>::epsilon();
+			return determinant * determinant <= epsilon * epsilon * lengths;
+		}
+	}
+
+	template <typename T>
+	struct ray2_t
+	{
+		vector2_t<T> origin;
+		vector2_t<T> direction;
+		// precomputed for the slab tests
+		vector2_t<T> inv_direction;
+
+		ray2_t()
+			: ray2_t(vector2_t<T>(), vector2_t<T>(static_cast<T>(1.0), static_cast<T>(0.0)))
+		{
+
+		}
+
+		ray2_t(const vector2_t<T>& origin, const vector2_t<T>& direction)
+			: origin(origin)
+			, direction(direction)
+			, inv_direction(static_cast<T>(1.0) / direction.x, static_cast<T>(1.0) / direction.y)
+		{
+
+		}
+
+		// ray going from a to b, b is at distance 1
+		static ray2_t segment(const vector2_t<T>& a, const vector2_t<T>& b)
+		{
+			return ray2_t(a, b - a);
+		}
+
+		vector2_t<T> point(const T distance) const
+		{
+			return origin + direction * distance;
+		}
+
+		bool intersects(const circle_t<T>& circle, T& distance,
+			const T max_distance = std::numeric_limits<T>::max()) const
+		{
+			const T ox = origin.x - circle.x;
+			const T oy = origin.y - circle.y;
+			const T a = direction.x * direction.x + direction.y * direction.y;
+			const T b = ox * direction.x + oy * direction.y;
+			const T c = ox * ox + oy * oy - circle.radius * circle.radius;
+			// outside and pointing away
+			if (c > static_cast<T>(0.0) && b > static_cast<T>(0.0)) return false;
+			const T discriminant = b * b - a * c;
+			if (discriminant < static_cast<T>(0.0)) return false;
+			// starting inside the circle is a hit at distance 0
+			const T t = std::max((-b - static_cast<T>(std::sqrt(discriminant))) / a, static_cast<T>(0.0));
+			if (t > max_distance) return false;
+			distance = t;
+			return true;
+		}
+
+		// slab test
+		bool intersects(const rectangle_t<T>& rect, T& distance,
+			const T max_distance = std::numeric_limits<T>::max()) const
+		{
+			T nearest = static_cast<T>(0.0);
+			T farthest = max_distance;
+			detail::clip_slab(rect.x - rect.width, rect.x + rect.width, origin.x, inv_direction.x, nearest, farthest);
+			detail::clip_slab(rect.y - rect.height, rect.y + rect.height, origin.y, inv_direction.y, nearest, farthest);
+			if (nearest > farthest) return false;
+			distance = nearest;
+			return true;
+		}
+	};
+
+	template <typename T>
+	struct ray3_t
+	{
+		vector3_t<T> origin;
+		vector3_t<T> direction;
+		// precomputed for the slab tests
+		vector3_t<T> inv_direction;
+
+		ray3_t()
+			: ray3_t(vector3_t<T>(), vector3_t<T>::forward)
+		{
+
+		}
+
+		ray3_t(const vector3_t<T>& origin, const vector3_t<T>& direction)
+			: origin(origin)
+			, direction(direction)
+			, inv_direction(static_cast<T>(1.0) / direction.x, static_cast<T>(1.0) / direction.y, static_cast<T>(1.0) / direction.z)
+		{
+
+		}
+
+		// ray going from a to b, b is at distance 1
+		static ray3_t segment(const vector3_t<T>& a, const vector3_t<T>& b)
+		{
+			return ray3_t(a, b - a);
+		}
+
+		vector3_t<T> point(const T distance) const
+		{
+			return origin + direction * distance;
+		}
+
+		bool intersects_sphere(const vector3_t<T>& center, const T radius, T& distance,
+			const T max_distance = std::numeric_limits<T>::max()) const
+		{
+			const vector3_t<T> o = origin - center;
+			const T a = direction * direction;
+			const T b = o * direction;
+			const T c = o * o - radius * radius;
+			// outside and pointing away
+			if (c > static_cast<T>(0.0) && b > static_cast<T>(0.0)) return false;
+			const T discriminant = b * b - a * c;
+			if (discriminant < static_cast<T>(0.0)) return false;
+			// starting inside the sphere is a hit at distance 0
+			const T t = std::max((-b - static_cast<T>(std::sqrt(discriminant))) / a, static_cast<T>(0.0));
+			if (t > max_distance) return false;
+			distance = t;
+			return true;
+		}
+
+		// slab test against an axis aligned box
+		bool intersects_box(const vector3_t<T>& min, const vector3_t<T>& max, T& distance,
+			const T max_distance = std::numeric_limits<T>::max()) const
+		{
+			T nearest = static_cast<T>(0.0);
+			T farthest = max_distance;
+			detail::clip_slab(min.x, max.x, origin.x, inv_direction.x, nearest, farthest);
+			detail::clip_slab(min.y, max.y, origin.y, inv_direction.y, nearest, farthest);
+			detail::clip_slab(min.z, max.z, origin.z, inv_direction.z, nearest, farthest);
+			if (nearest > farthest) return false;
+			distance = nearest;
+			return true;
+		}
+
+		// Moller-Trumbore, both faces are hit
+		bool intersects_triangle(const vector3_t<T>& v0, const vector3_t<T>& v1, const vector3_t<T>& v2, T& distance,
+			const T max_distance = std::numeric_limits<T>::max()) const
+		{
+			const vector3_t<T> edge1 = v1 - v0;
+			const vector3_t<T> edge2 = v2 - v0;
+			const vector3_t<T> p = direction.cross(edge2);
+			const T determinant = edge1 * p;
+			if (detail::parallel_to_triangle(determinant, (edge1 * edge1) * (edge2 * edge2) * (direction * direction))) return false;
+			const T f = static_cast<T>(1.0) / determinant;
+			const vector3_t<T> s = origin - v0;
+			const T u = (s * p) * f;
+			if (u < static_cast<T>(0.0) || u > static_cast<T>(1.0)) return false;
+			const vector3_t<T> q = s.cross(edge1);
+			const T v = (direction * q) * f;
+			if (v < static_cast<T>(0.0) || u + v > static_cast<T>(1.0)) return false;
+			const T t = (edge2 * q) * f;
+			if (t < static_cast<T>(0.0) || t > max_distance) return false;
+			distance = t;
+			return true;
+		}
+	};
+
+	// packets of N rays stored as structure of arrays,
+	// the tests run the same code on every lane without branches
+	// and return a mask with one bit per ray, the distances of the
+	// missing lanes are left untouched
+
+	template <typename T, std::size_t N>
+	struct ray2_packet_t
+	{
+		static_assert(N <= 32, "the hit mask holds up to 32 rays");
+
+		T origin_x[N], origin_y[N];
+		T inv_direction_x[N], inv_direction_y[N];
+		T direction_x[N], direction_y[N];
+
+		ray2_packet_t() = default;
+
+		ray2_packet_t(const ray2_t<T>* rays)
+		{
+			for (std::size_t i = 0; i < N; ++i)
+			{
+				set(i, rays[i]);
+			}
+		}
+
+		void set(const std::size_t i, const ray2_t<T>& ray)
+		{
+			origin_x[i] = ray.origin.x; origin_y[i] = ray.origin.y;
+			direction_x[i] = ray.direction.x; direction_y[i] = ray.direction.y;
+			inv_direction_x[i] = ray.inv_direction.x; inv_direction_y[i] = ray.inv_direction.y;
+		}
+
+		unsigned int intersects(const rectangle_t<T>& rect, T* distances,
+			const T max_distance = std::numeric_limits<T>::max()) const
+		{
+			const T zero = static_cast<T>(0.0);
+			const T minX = rect.x - rect.width, maxX = rect.x + rect.width;
+			const T minY = rect.y - rect.height, maxY = rect.y + rect.height;
+			unsigned int mask = 0;
+			for (std::size_t i = 0; i < N; ++i)
+			{
+				T nearest = zero;
+				T farthest = max_distance;
+				detail::clip_slab(minX, maxX, origin_x[i], inv_direction_x[i], nearest, farthest);
+				detail::clip_slab(minY, maxY, origin_y[i], inv_direction_y[i], nearest, farthest);
+				const bool hit = nearest <= farthest;
+				distances[i] = hit ? nearest : distances[i];
+				mask |= static_cast<unsigned int>(hit) << i;
+			}
+			return mask;
+		}
+
+		unsigned int intersects(const circle_t<T>& circle, T* distances,
+			const T max_distance = std::numeric_limits<T>::max()) const
+		{
+			const T zero = static_cast<T>(0.0);
+			const T r2 = circle.radius * circle.radius;
+			unsigned int mask = 0;
+			for (std::size_t i = 0; i < N; ++i)
+			{
+				const T ox = origin_x[i] - circle.x;
+				const T oy = origin_y[i] - circle.y;
+				const T a = direction_x[i] * direction_x[i] + direction_y[i] * direction_y[i];
+				const T b = ox * direction_x[i] + oy * direction_y[i];
+				const T c = ox * ox + oy * oy - r2;
+				const T discriminant = b * b - a * c;
+				const T t = std::max((-b - static_cast<T>(std::sqrt(std::max(discriminant, zero)))) / a, zero);
+				const bool hit = (discriminant >= zero) & !((c > zero) & (b > zero)) & (t <= max_distance);
+				distances[i] = hit ? t : distances[i];
+				mask |= static_cast<unsigned int>(hit) << i;
+			}
+			return mask;
+		}
+	};
+
+	template <typename T, std::size_t N>
+	struct ray3_packet_t
+	{
+		static_assert(N <= 32, "the hit mask holds up to 32 rays");
+
+		T origin_x[N], origin_y[N], origin_z[N];
+		T direction_x[N], direction_y[N], direction_z[N];
+		T inv_direction_x[N], inv_direction_y[N], inv_direction_z[N];
+
+		ray3_packet_t() = default;
+
+		ray3_packet_t(const ray3_t<T>* rays)
+		{
+			for (std::size_t i = 0; i < N; ++i)
+			{
+				set(i, rays[i]);
+			}
+		}
+
+		void set(const std::size_t i, const ray3_t<T>& ray)
+		{
+			origin_x[i] = ray.origin.x; origin_y[i] = ray.origin.y; origin_z[i] = ray.origin.z;
+			direction_x[i] = ray.direction.x; direction_y[i] = ray.direction.y; direction_z[i] = ray.direction.z;
+			inv_direction_x[i] = ray.inv_direction.x; inv_direction_y[i] = ray.inv_direction.y; inv_direction_z[i] = ray.inv_direction.z;
+		}
+
+		unsigned int intersects_box(const vector3_t<T>& min, const vector3_t<T>& max, T* distances,
+			const T max_distance = std::numeric_limits<T>::max()) const
+		{
+			const T zero = static_cast<T>(0.0);
+			unsigned int mask = 0;
+			for (std::size_t i = 0; i < N; ++i)
+			{
+				T nearest = zero;
+				T farthest = max_distance;
+				detail::clip_slab(min.x, max.x, origin_x[i], inv_direction_x[i], nearest, farthest);
+				detail::clip_slab(min.y, max.y, origin_y[i], inv_direction_y[i], nearest, farthest);
+				detail::clip_slab(min.z, max.z, origin_z[i], inv_direction_z[i], nearest, farthest);
+				const bool hit = nearest <= farthest;
+				distances[i] = hit ? nearest : distances[i];
+				mask |= static_cast<unsigned int>(hit) << i;
+			}
+			return mask;
+		}
+
+		unsigned int intersects_sphere(const vector3_t<T>& center, const T radius, T* distances,
+			const T max_distance = std::numeric_limits<T>::max()) const
+		{
+			const T zero = static_cast<T>(0.0);
+			const T r2 = radius * radius;
+			unsigned int mask = 0;
+			for (std::size_t i = 0; i < N; ++i)
+			{
+				const T ox = origin_x[i] - center.x;
+				const T oy = origin_y[i] - center.y;
+				const T oz = origin_z[i] - center.z;
+				const T a = direction_x[i] * direction_x[i] + direction_y[i] * direction_y[i] + direction_z[i] * direction_z[i];
+				const T b = ox * direction_x[i] + oy * direction_y[i] + oz * direction_z[i];
+				const T c = ox * ox + oy * oy + oz * oz - r2;
+				const T discriminant = b * b - a * c;
+				const T t = std::max((-b - static_cast<T>(std::sqrt(std::max(discriminant, zero)))) / a, zero);
+				const bool hit = (discriminant >= zero) & !((c > zero) & (b > zero)) & (t <= max_distance);
+				distances[i] = hit ? t : distances[i];
+				mask |= static_cast<unsigned int>(hit) << i;
+			}
+			return mask;
+		}
+
+		unsigned int intersects_triangle(const vector3_t<T>& v0, const vector3_t<T>& v1, const vector3_t<T>& v2, T* distances,
+			const T max_distance = std::numeric_limits<T>::max()) const
+		{
+			const T zero = static_cast<T>(0.0);
+			const T one = static_cast<T>(1.0);
+			const vector3_t<T> e1 = v1 - v0;
+			const vector3_t<T> e2 = v2 - v0;
+			const T edges = (e1 * e1) * (e2 * e2);
+			unsigned int mask = 0;
+			for (std::size_t i = 0; i < N; ++i)
+			{
+				// p = direction x e2
+				const T px = direction_y[i] * e2.z - direction_z[i] * e2.y;
+				const T py = direction_z[i] * e2.x - direction_x[i] * e2.z;
+				const T pz = direction_x[i] * e2.y - direction_y[i] * e2.x;
+				const T determinant = e1.x * px + e1.y * py + e1.z * pz;
+				const T lengths = edges * (direction_x[i] * direction_x[i] + direction_y[i] * direction_y[i] + direction_z[i] * direction_z[i]);
+				const bool valid = !detail::parallel_to_triangle(determinant, lengths);
+				const T f = one / (valid ? determinant : one);
+				const T sx = origin_x[i] - v0.x;
+				const T sy = origin_y[i] - v0.y;
+				const T sz = origin_z[i] - v0.z;
+				const T u = (sx * px + sy * py + sz * pz) * f;
+				// q = s x e1
+				const T qx = sy * e1.z - sz * e1.y;
+				const T qy = sz * e1.x - sx * e1.z;
+				const T qz = sx * e1.y - sy * e1.x;
+				const T v = (direction_x[i] * qx + direction_y[i] * qy + direction_z[i] * qz) * f;
+				const T t = (e2.x * qx + e2.y * qy + e2.z * qz) * f;
+				const bool hit = valid & (u >= zero) & (v >= zero) & (u + v <= one) & (t >= zero) & (t <= max_distance);
+				distances[i] = hit ? t : distances[i];
+				mask |= static_cast<unsigned int>(hit) << i;
+			}
+			return mask;
+		}
+	};
+
+	// ray types
+
+	typedef ray2_t<float> ray2;
+	typedef ray3_t<float> ray3;
+	typedef ray3 ray;
+	typedef ray2_t<double> dray2;
+	typedef ray3_t<double> dray3;
+	typedef dray3 dray;
+
+	typedef ray2_packet_t<float, 4> ray2_packet4;
+	typedef ray2_packet_t<float, 8> ray2_packet8;
+	typedef ray3_packet_t<float, 4> ray3_packet4;
+	typedef ray3_packet_t<float, 8> ray3_packet8;
+}
@@ -1,6 +1,10 @@
 /// Copyright (c) Vito Domenico Tagliente
 #pragma once 
 
+#include <cstddef>
+#include <cstdint>
+
+#include "mask.h"
 #include "vector2.h"
 
 namespace math
@@ -18,7 +22,7 @@ namespace math
 			T data[4];
 		};
 
-		const std::size_t length = 4;
+		static constexpr std::size_t length = 4;
 
 		rectangle_t()
 			: x()
@@ -45,23 +49,20 @@ namespace math
 
 		}
 
-		rectangle_t(const rectangle_t& rect)
-			: x(rect.x)
-			, y(rect.y)
-			, width(rect.width)
-			, height(rect.height)
+		// precision conversion
+		template <typename U>
+		explicit rectangle_t(const rectangle_t<U>& rect)
+			: x(static_cast<T>(rect.x))
+			, y(static_cast<T>(rect.y))
+			, width(static_cast<T>(rect.width))
+			, height(static_cast<T>(rect.height))
 		{
 
 		}
 
-		rectangle_t& operator= (const rectangle_t& other)
-		{
-			x = other.x;
-			y = other.y;
-			width = other.width;
-			height = other.height;
-			return *this;
-		}
+		rectangle_t(const rectangle_t& rect) = default;
+
+		rectangle_t& operator= (const rectangle_t& other) = default;
 
 		bool operator== (const rectangle_t& rect) const
 		{
@@ -74,28 +75,55 @@ namespace math
 			return !(*this == rect);
 		}
 
+		// the rectangle is centered in (x, y) and extends 
+		// width and height on each side
+		vector2_t<T> min() const
+		{
+			return { x - width, y - height };
+		}
+
+		vector2_t<T> max() const
+		{
+			return { x + width, y + height };
+		}
+
+		// the comparisons are combined with & instead of && 
+		// so that the tests compile to straight-line code
 		bool contains(const rectangle_t& rect) const
 		{
-			return x - width <= rect.x - width
-				&& rect.x + rect.width <= x + width
-				&& y - height <= rect.y - rect.height
-				&& rect.y + rect.height <= y + height;
+			return (x - width <= rect.x - rect.width)
+				& (rect.x + rect.width <= x + width)
+				& (y - height <= rect.y - rect.height)
+				& (rect.y + rect.height <= y + height);
 		}
 
 		bool contains(const vector2_t<T>& point) const
 		{
-			return point.x >= x - width
-				&& point.x <= x + width
-				&& point.y >= y - height
-				&& point.y <= y + height;
+			return (point.x >= x - width)
+				& (point.x <= x + width)
+				& (point.y >= y - height)
+				& (point.y <= y + height);
 		}
 
 		bool intersects(const rectangle_t& rect) const
 		{
-			return !(x - width > rect.x + rect.width
-				|| x + width < rect.x - rect.width
-				|| y - height > rect.y + rect.height
-				|| y + height < rect.y - height);
+			return (x - width <= rect.x + rect.width)
+				& (x + width >= rect.x - rect.width)
+				& (y - height <= rect.y + rect.height)
+				& (y + height >= rect.y - rect.height);
+		}
+
+		// batch point test, the mask receives one bit per point, 
+		// see mask_size, the return value is the number of hits
+		std::size_t contains(const vector2_t<T>* points, const std::size_t count, std::uint8_t* mask) const
+		{
+			const T minX = x - width, maxX = x + width;
+			const T minY = y - height, maxY = y + height;
+			return detail::test_mask(count, mask, [=](const std::size_t i)
+				{
+					return (points[i].x >= minX) & (points[i].x <= maxX)
+						& (points[i].y >= minY) & (points[i].y <= maxY);
+				});
 		}
 	};
 
@@ -103,4 +131,6 @@ namespace math
 
 	typedef rectangle_t<float> rect;
 	typedef rect rectangle;
+	typedef rectangle_t<double> drect;
+	typedef drect drectangle;
 }
\ No newline at end of file
@@ -0,0 +1,342 @@
+/// Copyright (c) Vito Domenico Tagliente
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "mask.h"
+#include "rectangle.h"
+
+namespace math
+{
+	// structure of arrays collection of rectangles,
+	// each rectangle is stored as min/max bounds in separate lanes
+	// so that the batch kernels run over contiguous arrays
+	template <typename T>
+	struct rectangle_array_t
+	{
+		typedef std::pair<std::uint32_t, std::uint32_t> pair_t;
+
+		// the number of rows and columns tested per block
+		// by the many-vs-many overlap kernels
+		static constexpr std::size_t tile_size = 256;
+
+		std::vector<T> min_x;
+		std::vector<T> min_y;
+		std::vector<T> max_x;
+		std::vector<T> max_y;
+
+		rectangle_array_t() = default;
+
+		rectangle_array_t(const rectangle_t<T>* rects, const std::size_t count)
+		{
+			reserve(count);
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				push_back(rects[i]);
+			}
+		}
+
+		std::size_t size() const
+		{
+			return min_x.size();
+		}
+
+		bool empty() const
+		{
+			return min_x.empty();
+		}
+
+		void reserve(const std::size_t count)
+		{
+			min_x.reserve(count);
+			min_y.reserve(count);
+			max_x.reserve(count);
+			max_y.reserve(count);
+		}
+
+		void clear()
+		{
+			min_x.clear();
+			min_y.clear();
+			max_x.clear();
+			max_y.clear();
+		}
+
+		void push_back(const rectangle_t<T>& rect)
+		{
+			min_x.push_back(rect.x - rect.width);
+			min_y.push_back(rect.y - rect.height);
+			max_x.push_back(rect.x + rect.width);
+			max_y.push_back(rect.y + rect.height);
+		}
+
+		void set(const std::size_t i, const rectangle_t<T>& rect)
+		{
+			min_x[i] = rect.x - rect.width;
+			min_y[i] = rect.y - rect.height;
+			max_x[i] = rect.x + rect.width;
+			max_y[i] = rect.y + rect.height;
+		}
+
+		rectangle_t<T> operator[] (const std::size_t i) const
+		{
+			const T half = static_cast<T>(0.5);
+			return rectangle_t<T>(
+				(min_x[i] + max_x[i]) * half,
+				(min_y[i] + max_y[i]) * half,
+				(max_x[i] - min_x[i]) * half,
+				(max_y[i] - min_y[i]) * half
+			);
+		}
+
+		// one-vs-many intersection, the mask receives one bit
+		// per rectangle, see mask_size
+		std::size_t intersects(const rectangle_t<T>& rect, std::uint8_t* mask) const
+		{
+			const T box[4] = { rect.x - rect.width, rect.y - rect.height, rect.x + rect.width, rect.y + rect.height };
+			return test_boxes(box, min_x.data(), min_y.data(), max_x.data(), max_y.data(), size(), mask);
+		}
+
+		// hit testing, which rectangles contain the point
+		std::size_t contains(const vector2_t<T>& point, std::uint8_t* mask) const
+		{
+			const T box[4] = { point.x, point.y, point.x, point.y };
+			return test_boxes(box, min_x.data(), min_y.data(), max_x.data(), max_y.data(), size(), mask);
+		}
+
+		// many-vs-many overlap between the rows [first, last) of this
+		// collection and the whole other collection, processed in blocks
+		// of rows against tiles of columns that stay in cache,
+		// disjoint row ranges can run on different threads
+		void overlaps(const rectangle_array_t& other, std::vector<pair_t>& pairs,
+			const std::size_t first, const std::size_t last) const
+		{
+			assert(first <= last && last <= size());
+			std::uint8_t mask[tile_size / 8];
+			for (std::size_t block = first; block < last; block += tile_size)
+			{
+				const std::size_t rows = std::min(last, block + tile_size);
+				for (std::size_t tile = 0; tile < other.size(); tile += tile_size)
+				{
+					const std::size_t count = std::min(tile_size, other.size() - tile);
+					for (std::size_t i = block; i < rows; ++i)
+					{
+						const T box[4] = { min_x[i], min_y[i], max_x[i], max_y[i] };
+						if (test_boxes(box, other.min_x.data() + tile, other.min_y.data() + tile, other.max_x.data() + tile, other.max_y.data() + tile, count, mask) == 0) continue;
+						collect(mask, count, static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(tile), pairs);
+					}
+				}
+			}
+		}
+
+		void overlaps(const rectangle_array_t& other, std::vector<pair_t>& pairs) const
+		{
+			overlaps(other, pairs, 0, size());
+		}
+
+		// self overlap, each pair (i, j) is reported once with i < j,
+		// the columns of a row start after it
+		void overlaps(std::vector<pair_t>& pairs, const std::size_t first, const std::size_t last) const
+		{
+			assert(first <= last && last <= size());
+			std::uint8_t mask[tile_size / 8];
+			for (std::size_t block = first; block < last; block += tile_size)
+			{
+				const std::size_t rows = std::min(last, block + tile_size);
+				for (std::size_t tile = block + 1; tile < size(); tile += tile_size)
+				{
+					const std::size_t end = std::min(size(), tile + tile_size);
+					for (std::size_t i = block; i < rows; ++i)
+					{
+						const std::size_t column = std::max(tile, i + 1);
+						if (column >= end) break;
+						const T box[4] = { min_x[i], min_y[i], max_x[i], max_y[i] };
+						if (test_boxes(box, min_x.data() + column, min_y.data() + column, max_x.data() + column, max_y.data() + column, end - column, mask) == 0) continue;
+						collect(mask, end - column, static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(column), pairs);
+					}
+				}
+			}
+		}
+
+		void overlaps(std::vector<pair_t>& pairs) const
+		{
+			overlaps(pairs, 0, size());
+		}
+
+		// sum of the areas covered by the intersection
+		// of each rectangle with the given one
+		T intersection_area(const rectangle_t<T>& rect) const
+		{
+			const T zero = static_cast<T>(0.0);
+			const T minX = rect.x - rect.width, maxX = rect.x + rect.width;
+			const T minY = rect.y - rect.height, maxY = rect.y + rect.height;
+			T result = zero;
+			for (std::size_t i = 0; i < size(); ++i)
+			{
+				const T w = std::min(max_x[i], maxX) - std::max(min_x[i], minX);
+				const T h = std::min(max_y[i], maxY) - std::max(min_y[i], minY);
+				result += std::max(w, zero) * std::max(h, zero);
+			}
+			return result;
+		}
+
+		// sum of the areas of all the rectangles
+		T area() const
+		{
+			T result = static_cast<T>(0.0);
+			for (std::size_t i = 0; i < size(); ++i)
+			{
+				result += (max_x[i] - min_x[i]) * (max_y[i] - min_y[i]);
+			}
+			return result;
+		}
+
+		// area of the union of the rectangles, the overlaps counted once:
+		// a sweep over the sorted x edges updates a segment tree over the
+		// sorted y coordinates, every node counts the rectangles covering
+		// its whole span and caches the length covered below it
+		T union_area() const
+		{
+			const T zero = static_cast<T>(0.0);
+
+			std::vector<T> ys;
+			ys.reserve(size() * 2);
+			for (std::size_t i = 0; i < size(); ++i)
+			{
+				if (!(min_x[i] < max_x[i] && min_y[i] < max_y[i])) continue;
+				ys.push_back(min_y[i]);
+				ys.push_back(max_y[i]);
+			}
+			if (ys.empty()) return zero;
+			std::sort(ys.begin(), ys.end());
+			ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+
+			// the y spans as ranges of the intervals between the coordinates
+			struct edge
+			{
+				T x;
+				std::uint32_t begin, end;
+				int delta;
+			};
+			std::vector<edge> edges;
+			edges.reserve(size() * 2);
+			for (std::size_t i = 0; i < size(); ++i)
+			{
+				if (!(min_x[i] < max_x[i] && min_y[i] < max_y[i])) continue;
+				const std::uint32_t begin = static_cast<std::uint32_t>(std::lower_bound(ys.begin(), ys.end(), min_y[i]) - ys.begin());
+				const std::uint32_t end = static_cast<std::uint32_t>(std::lower_bound(ys.begin(), ys.end(), max_y[i]) - ys.begin());
+				edges.push_back({ min_x[i], begin, end, 1 });
+				edges.push_back({ max_x[i], begin, end, -1 });
+			}
+			std::sort(edges.begin(), edges.end(), [](const edge& a, const edge& b) { return a.x < b.x; });
+
+			const std::size_t intervals = ys.size() - 1;
+			std::vector<int> counts(intervals * 4, 0);
+			std::vector<T> lengths(intervals * 4, zero);
+			T result = zero;
+			for (std::size_t e = 0; e < edges.size(); ++e)
+			{
+				if (e > 0)
+				{
+					result += lengths[1] * (edges[e].x - edges[e - 1].x);
+				}
+				cover(1, 0, intervals, edges[e].begin, edges[e].end, edges[e].delta, ys, counts, lengths);
+			}
+			return result;
+		}
+
+		// union reduction, the smallest rectangle containing all the others
+		rectangle_t<T> bounds() const
+		{
+			if (empty()) return rectangle_t<T>();
+			T minX = min_x[0], minY = min_y[0];
+			T maxX = max_x[0], maxY = max_y[0];
+			for (std::size_t i = 1; i < size(); ++i)
+			{
+				minX = std::min(minX, min_x[i]);
+				minY = std::min(minY, min_y[i]);
+				maxX = std::max(maxX, max_x[i]);
+				maxY = std::max(maxY, max_y[i]);
+			}
+			const T half = static_cast<T>(0.5);
+			return rectangle_t<T>(
+				(minX + maxX) * half,
+				(minY + maxY) * half,
+				(maxX - minX) * half,
+				(maxY - minY) * half
+			);
+		}
+
+	private:
+
+		// add delta to the nodes of the segment tree spanning the intervals
+		// [begin, end), the node spans the intervals [first, last)
+		static void cover(const std::size_t node, const std::size_t first, const std::size_t last,
+			const std::size_t begin, const std::size_t end, const int delta,
+			const std::vector<T>& ys, std::vector<int>& counts, std::vector<T>& lengths)
+		{
+			if (end <= first || last <= begin) return;
+			if (begin <= first && last <= end)
+			{
+				counts[node] += delta;
+			}
+			else
+			{
+				const std::size_t middle = (first + last) / 2;
+				cover(node * 2, first, middle, begin, end, delta, ys, counts, lengths);
+				cover(node * 2 + 1, middle, last, begin, end, delta, ys, counts, lengths);
+			}
+
+			if (counts[node] > 0) lengths[node] = ys[last] - ys[first];
+			else if (last - first == 1) lengths[node] = static_cast<T>(0.0);
+			else lengths[node] = lengths[node * 2] + lengths[node * 2 + 1];
+		}
+
+		// box is (min x, min y, max x, max y), the float
+		// arrays run the simd kernel of mask.h
+		static std::size_t test_boxes(const T* box, const T* x0, const T* y0, const T* x1, const T* y1,
+			const std::size_t count, std::uint8_t* mask)
+		{
+			if constexpr (std::is_same<T, float>::value)
+			{
+				return detail::overlap_boxes(box, x0, y0, x1, y1, count, mask);
+			}
+			else
+			{
+				return detail::test_mask(count, mask, [=](const std::size_t i)
+					{
+						return (x0[i] <= box[2]) & (x1[i] >= box[0]) & (y0[i] <= box[3]) & (y1[i] >= box[1]);
+					});
+			}
+		}
+
+		static void collect(const std::uint8_t* mask, const std::size_t count,
+			const std::uint32_t row, const std::uint32_t offset, std::vector<pair_t>& pairs)
+		{
+			for (std::size_t j = 0; j < count; j += 8)
+			{
+				unsigned int bits = mask[j / 8];
+				while (bits != 0)
+				{
+					unsigned int lane = 0;
+					while (((bits >> lane) & 1u) == 0) ++lane;
+					pairs.emplace_back(row, offset + static_cast<std::uint32_t>(j + lane));
+					bits &= bits - 1;
+				}
+			}
+		}
+	};
+
+	// rectangle array types
+
+	typedef rectangle_array_t<float> rect_array;
+	typedef rect_array rectangle_array;
+	typedef rectangle_array_t<double> drect_array;
+	typedef drect_array drectangle_array;
+}
@@ -0,0 +1,416 @@
+/// Copyright (c) Vito Domenico Tagliente
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "vector_n.h"
+
+namespace math
+{
+	// bezier curves and piecewise cubic splines over vector2_t and vector3_t
+	// every spline segment is stored as a cubic bezier: the b-spline and
+	// catmull-rom control points are converted once when they are set, so
+	// the evaluation, the flattening and the arc-length tables have one
+	// code path
+
+	template <typename T, std::size_t N>
+	struct cubic_bezier_t
+	{
+		typedef vector_t<T, N> vector_type;
+
+		vector_type p0, p1, p2, p3;
+
+		cubic_bezier_t() = default;
+		cubic_bezier_t(const vector_type& _p0, const vector_type& _p1, const vector_type& _p2, const vector_type& _p3)
+			: p0(_p0), p1(_p1), p2(_p2), p3(_p3)
+		{
+
+		}
+
+		// de casteljau, t in [0, 1]
+		vector_type evaluate(const T t) const
+		{
+			const vector_type a = lerp(p0, p1, t), b = lerp(p1, p2, t), c = lerp(p2, p3, t);
+			const vector_type d = lerp(a, b, t), e = lerp(b, c, t);
+			return lerp(d, e, t);
+		}
+
+		vector_type derivative(const T t) const
+		{
+			const T s = static_cast<T>(1.0) - t;
+			return (p1 - p0) * (static_cast<T>(3.0) * s * s)
+				+ (p2 - p1) * (static_cast<T>(6.0) * s * t)
+				+ (p3 - p2) * (static_cast<T>(3.0) * t * t);
+		}
+
+		// the two halves at t, from the same de casteljau steps
+		void split(const T t, cubic_bezier_t& left, cubic_bezier_t& right) const
+		{
+			const vector_type a = lerp(p0, p1, t), b = lerp(p1, p2, t), c = lerp(p2, p3, t);
+			const vector_type d = lerp(a, b, t), e = lerp(b, c, t);
+			const vector_type f = lerp(d, e, t);
+			left = cubic_bezier_t(p0, a, d, f);
+			right = cubic_bezier_t(f, e, c, p3);
+		}
+
+		// 16 times the square of an upper bound of the distance between
+		// the curve and its chord
+		T flatness() const
+		{
+			const vector_type u = p1 * static_cast<T>(3.0) - p0 * static_cast<T>(2.0) - p3;
+			const vector_type v = p2 * static_cast<T>(3.0) - p0 - p3 * static_cast<T>(2.0);
+			T result = static_cast<T>(0.0);
+			for (std::size_t i = 0; i < N; ++i)
+				result += std::max(u[i] * u[i], v[i] * v[i]);
+			return result;
+		}
+
+		// steps + 1 points at uniform parameters by forward differencing,
+		// three additions per point instead of a de casteljau evaluation
+		void tessellate(const std::size_t steps, vector_type* result) const
+		{
+			assert(steps > 0);
+			// power basis a t^3 + b t^2 + c t + d
+			const vector_type a = p3 - p0 + (p1 - p2) * static_cast<T>(3.0);
+			const vector_type b = (p0 - p1 * static_cast<T>(2.0) + p2) * static_cast<T>(3.0);
+			const vector_type c = (p1 - p0) * static_cast<T>(3.0);
+
+			const T h = static_cast<T>(1.0) / static_cast<T>(steps);
+			const T h2 = h * h, h3 = h2 * h;
+			vector_type d1 = a * h3 + b * h2 + c * h;
+			vector_type d2 = a * (static_cast<T>(6.0) * h3) + b * (static_cast<T>(2.0) * h2);
+			const vector_type d3 = a * (static_cast<T>(6.0) * h3);
+
+			vector_type point = p0;
+			result[0] = point;
+			for (std::size_t i = 1; i < steps; ++i)
+			{
+				point += d1;
+				d1 += d2;
+				d2 += d3;
+				result[i] = point;
+			}
+			// no accumulated error at the end
+			result[steps] = p3;
+		}
+
+	private:
+
+		static vector_type lerp(const vector_type& a, const vector_type& b, const T t)
+		{
+			return a + (b - a) * t;
+		}
+	};
+
+	template <typename T, std::size_t N>
+	struct quadratic_bezier_t
+	{
+		typedef vector_t<T, N> vector_type;
+
+		vector_type p0, p1, p2;
+
+		quadratic_bezier_t() = default;
+		quadratic_bezier_t(const vector_type& _p0, const vector_type& _p1, const vector_type& _p2)
+			: p0(_p0), p1(_p1), p2(_p2)
+		{
+
+		}
+
+		// de casteljau, t in [0, 1]
+		vector_type evaluate(const T t) const
+		{
+			const vector_type a = p0 + (p1 - p0) * t, b = p1 + (p2 - p1) * t;
+			return a + (b - a) * t;
+		}
+
+		vector_type derivative(const T t) const
+		{
+			return ((p1 - p0) * (static_cast<T>(1.0) - t) + (p2 - p1) * t) * static_cast<T>(2.0);
+		}
+
+		void split(const T t, quadratic_bezier_t& left, quadratic_bezier_t& right) const
+		{
+			const vector_type a = p0 + (p1 - p0) * t, b = p1 + (p2 - p1) * t;
+			const vector_type c = a + (b - a) * t;
+			left = quadratic_bezier_t(p0, a, c);
+			right = quadratic_bezier_t(c, b, p2);
+		}
+
+		// degree elevation, the same curve
+		cubic_bezier_t<T, N> cubic() const
+		{
+			const T f = static_cast<T>(2.0) / static_cast<T>(3.0);
+			return cubic_bezier_t<T, N>(p0, p0 + (p1 - p0) * f, p2 + (p1 - p2) * f, p2);
+		}
+	};
+
+	// the bezier form of the uniform segments between p1 and p2
+
+	template <typename T, std::size_t N>
+	inline cubic_bezier_t<T, N> catmull_rom_segment(const vector_t<T, N>& p0, const vector_t<T, N>& p1, const vector_t<T, N>& p2, const vector_t<T, N>& p3)
+	{
+		const T f = static_cast<T>(1.0) / static_cast<T>(6.0);
+		return cubic_bezier_t<T, N>(p1, p1 + (p2 - p0) * f, p2 - (p3 - p1) * f, p2);
+	}
+
+	// the b-spline does not pass through its control points
+	template <typename T, std::size_t N>
+	inline cubic_bezier_t<T, N> bspline_segment(const vector_t<T, N>& p0, const vector_t<T, N>& p1, const vector_t<T, N>& p2, const vector_t<T, N>& p3)
+	{
+		const T sixth = static_cast<T>(1.0) / static_cast<T>(6.0);
+		const T third = static_cast<T>(1.0) / static_cast<T>(3.0);
+		return cubic_bezier_t<T, N>(
+			(p0 + p1 * static_cast<T>(4.0) + p2) * sixth,
+			(p1 * static_cast<T>(2.0) + p2) * third,
+			(p1 + p2 * static_cast<T>(2.0)) * third,
+			(p1 + p2 * static_cast<T>(4.0) + p3) * sixth
+		);
+	}
+
+	// append to points the end points of the flat pieces of the curve,
+	// the distance between the curve and the polyline is below tolerance
+	// the start point is not appended, so that the segments of a spline chain
+	template <typename T, std::size_t N>
+	inline void flatten(const cubic_bezier_t<T, N>& curve, const T tolerance, std::vector<vector_t<T, N>>& points)
+	{
+		constexpr unsigned int max_depth = 16;
+		struct entry
+		{
+			cubic_bezier_t<T, N> curve;
+			unsigned int depth;
+		};
+
+		const T limit = static_cast<T>(16.0) * tolerance * tolerance;
+		// depth first, at most one pending right half per level
+		entry stack[max_depth + 1];
+		std::size_t top = 0;
+		stack[top++] = { curve, 0 };
+		while (top > 0)
+		{
+			const entry e = stack[--top];
+			if (e.depth == max_depth || e.curve.flatness() <= limit)
+			{
+				points.push_back(e.curve.p3);
+				continue;
+			}
+			cubic_bezier_t<T, N> left, right;
+			e.curve.split(static_cast<T>(0.5), left, right);
+			stack[top++] = { right, e.depth + 1 };
+			stack[top++] = { left, e.depth + 1 };
+		}
+	}
+
+	enum class spline_type
+	{
+		// 3 * segments + 1 points, the segments share their end points
+		bezier,
+		// segments + 3 points
+		bspline,
+		// segments + 1 points, the curve passes through all of them
+		catmull_rom
+	};
+
+	// piecewise cubic curve, the parameter goes from 0 to segment_count()
+	// and is clamped, the integer part selects the segment
+	template <typename T, std::size_t N>
+	class spline_t
+	{
+	public:
+
+		typedef vector_t<T, N> vector_type;
+		typedef cubic_bezier_t<T, N> segment_type;
+
+		spline_t() = default;
+
+		spline_t(const spline_type type, const vector_type* points, const std::size_t count)
+		{
+			set_points(type, points, count);
+		}
+
+		void set_points(const spline_type type, const vector_type* points, const std::size_t count)
+		{
+			m_segments.clear();
+			switch (type)
+			{
+			case spline_type::bezier:
+				assert(count >= 4 && (count - 1) % 3 == 0);
+				for (std::size_t i = 0; i + 3 < count; i += 3)
+					m_segments.emplace_back(points[i], points[i + 1], points[i + 2], points[i + 3]);
+				break;
+			case spline_type::bspline:
+				assert(count >= 4);
+				for (std::size_t i = 0; i + 3 < count; ++i)
+					m_segments.push_back(bspline_segment(points[i], points[i + 1], points[i + 2], points[i + 3]));
+				break;
+			case spline_type::catmull_rom:
+				assert(count >= 2);
+				for (std::size_t i = 0; i + 1 < count; ++i)
+				{
+					// the end points are reflected, one sided tangents
+					const vector_type before = i > 0 ? points[i - 1] : points[0] * static_cast<T>(2.0) - points[1];
+					const vector_type after = i + 2 < count ? points[i + 2] : points[i + 1] * static_cast<T>(2.0) - points[i];
+					m_segments.push_back(catmull_rom_segment(before, points[i], points[i + 1], after));
+				}
+				break;
+			}
+		}
+
+		void add_segment(const segment_type& segment)
+		{
+			m_segments.push_back(segment);
+		}
+
+		std::size_t segment_count() const { return m_segments.size(); }
+		const segment_type& segment(const std::size_t i) const { return m_segments[i]; }
+		bool empty() const { return m_segments.empty(); }
+
+		vector_type evaluate(const T t) const
+		{
+			T u;
+			const segment_type& s = locate(t, u);
+			return s.evaluate(u);
+		}
+
+		// with respect to the spline parameter
+		vector_type derivative(const T t) const
+		{
+			T u;
+			const segment_type& s = locate(t, u);
+			return s.derivative(u);
+		}
+
+		void evaluate(const T* parameters, vector_type* result, const std::size_t count) const
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				T u;
+				const segment_type& s = locate(parameters[i], u);
+				result[i] = s.evaluate(u);
+			}
+		}
+
+		// the polyline within tolerance of the spline, from its start point
+		void flatten(const T tolerance, std::vector<vector_type>& points) const
+		{
+			if (empty()) return;
+			points.push_back(m_segments.front().p0);
+			for (const segment_type& s : m_segments)
+				math::flatten(s, tolerance, points);
+		}
+
+	private:
+
+		const segment_type& locate(const T t, T& u) const
+		{
+			assert(!empty());
+			const T last = static_cast<T>(m_segments.size());
+			const T clamped = std::min(std::max(t, static_cast<T>(0.0)), last);
+			const std::size_t i = std::min(static_cast<std::size_t>(clamped), m_segments.size() - 1);
+			u = clamped - static_cast<T>(i);
+			return m_segments[i];
+		}
+
+		std::vector<segment_type> m_segments;
+	};
+
+	// distance along a spline to its parameter, for constant speed motion
+	// the spline is sampled by forward differencing and the lengths of the
+	// chords are accumulated, the error shrinks with the square of the
+	// samples per segment
+	template <typename T, std::size_t N>
+	class arc_length_table_t
+	{
+	public:
+
+		typedef vector_t<T, N> vector_type;
+
+		arc_length_table_t() = default;
+
+		arc_length_table_t(const spline_t<T, N>& spline, const std::size_t samples = 16)
+		{
+			build(spline, samples);
+		}
+
+		void build(const spline_t<T, N>& spline, const std::size_t samples = 16)
+		{
+			assert(samples > 0);
+			m_lengths.clear();
+			m_parameters.clear();
+			if (spline.empty()) return;
+
+			m_lengths.reserve(spline.segment_count() * samples + 1);
+			m_parameters.reserve(spline.segment_count() * samples + 1);
+			m_lengths.push_back(static_cast<T>(0.0));
+			m_parameters.push_back(static_cast<T>(0.0));
+
+			std::vector<vector_type> points(samples + 1);
+			const T step = static_cast<T>(1.0) / static_cast<T>(samples);
+			T length = static_cast<T>(0.0);
+			for (std::size_t s = 0; s < spline.segment_count(); ++s)
+			{
+				spline.segment(s).tessellate(samples, points.data());
+				for (std::size_t i = 1; i <= samples; ++i)
+				{
+					length += points[i].distance(points[i - 1]);
+					m_lengths.push_back(length);
+					m_parameters.push_back(i == samples ? static_cast<T>(s + 1) : static_cast<T>(s) + static_cast<T>(i) * step);
+				}
+			}
+		}
+
+		T length() const
+		{
+			return m_lengths.empty() ? static_cast<T>(0.0) : m_lengths.back();
+		}
+
+		// the distance is clamped to [0, length()]
+		T parameter(const T distance) const
+		{
+			assert(!m_lengths.empty());
+			if (distance <= static_cast<T>(0.0)) return m_parameters.front();
+			if (distance >= m_lengths.back()) return m_parameters.back();
+
+			const std::size_t i = static_cast<std::size_t>(std::upper_bound(m_lengths.begin(), m_lengths.end(), distance) - m_lengths.begin());
+			const T l0 = m_lengths[i - 1], l1 = m_lengths[i];
+			const T f = l1 > l0 ? (distance - l0) / (l1 - l0) : static_cast<T>(0.0);
+			return m_parameters[i - 1] + (m_parameters[i] - m_parameters[i - 1]) * f;
+		}
+
+		void parameters(const T* distances, T* result, const std::size_t count) const
+		{
+			for (std::size_t i = 0; i < count; ++i)
+				result[i] = parameter(distances[i]);
+		}
+
+		// the points of the spline at the distances, one per agent
+		void evaluate(const spline_t<T, N>& spline, const T* distances, vector_type* result, const std::size_t count) const
+		{
+			for (std::size_t i = 0; i < count; ++i)
+				result[i] = spline.evaluate(parameter(distances[i]));
+		}
+
+	private:
+
+		std::vector<T> m_lengths;
+		std::vector<T> m_parameters;
+	};
+
+	// spline types
+
+	typedef quadratic_bezier_t<float, 2> quadratic_bezier2;
+	typedef quadratic_bezier_t<float, 3> quadratic_bezier3;
+	typedef cubic_bezier_t<float, 2> cubic_bezier2;
+	typedef cubic_bezier_t<float, 3> cubic_bezier3;
+	typedef spline_t<float, 2> spline2;
+	typedef spline_t<float, 3> spline3;
+	typedef spline_t<double, 2> dspline2;
+	typedef spline_t<double, 3> dspline3;
+	typedef arc_length_table_t<float, 2> arc_length_table2;
+	typedef arc_length_table_t<float, 3> arc_length_table3;
+	typedef arc_length_table_t<double, 2> darc_length_table2;
+	typedef arc_length_table_t<double, 3> darc_length_table3;
+}
@@ -0,0 +1,294 @@
+/// Copyright (c) Vito Domenico Tagliente
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "circle.h"
+#include "rectangle.h"
+
+namespace math
+{
+	// incremental sort and sweep broad-phase
+	// the bounds of every proxy are projected on one axis as a pair of
+	// endpoints kept sorted with an insertion sort: from one frame to the
+	// next the order barely changes, so the sort and the pair updates cost
+	// close to O(n) for mostly static scenes
+	// circles are tracked through their bounding rectangles
+	template <typename T>
+	class sweep_and_prune_t
+	{
+	public:
+
+		typedef std::uint32_t id_t;
+		// overlapping proxies, first < second
+		typedef std::pair<id_t, id_t> pair_t;
+
+		// axis 0 sweeps along x, axis 1 along y
+		sweep_and_prune_t(const unsigned int axis = 0)
+			: m_axis(axis)
+		{
+			assert(axis < 2);
+		}
+
+		std::size_t size() const { return m_proxies.size() - m_free.size(); }
+
+		id_t insert(const rectangle_t<T>& rect)
+		{
+			id_t id;
+			if (m_free.empty())
+			{
+				id = static_cast<id_t>(m_proxies.size());
+				m_proxies.emplace_back();
+			}
+			else
+			{
+				id = m_free.back();
+				m_free.pop_back();
+			}
+
+			proxy& p = m_proxies[id];
+			p.alive = true;
+			set_bounds(p, rect);
+			// appended at the end, the next sweep moves them in place
+			m_endpoints.push_back({ p.min[m_axis], id << 1 });
+			m_endpoints.push_back({ p.max[m_axis], (id << 1) | 1 });
+			return id;
+		}
+
+		id_t insert(const circle_t<T>& circle)
+		{
+			return insert(rectangle_t<T>(circle.x, circle.y, circle.radius, circle.radius));
+		}
+
+		void update(const id_t id, const rectangle_t<T>& rect)
+		{
+			assert(id < m_proxies.size() && m_proxies[id].alive);
+			set_bounds(m_proxies[id], rect);
+		}
+
+		void update(const id_t id, const circle_t<T>& circle)
+		{
+			update(id, rectangle_t<T>(circle.x, circle.y, circle.radius, circle.radius));
+		}
+
+		// the proxy is released on the next sweep,
+		// its pairs are reported as removed
+		void remove(const id_t id)
+		{
+			assert(id < m_proxies.size() && m_proxies[id].alive);
+			m_proxies[id].alive = false;
+			m_proxies[id].pending = true;
+		}
+
+		// sort the endpoints and refresh the pair list,
+		// added() and removed() return the events of this sweep
+		void sweep()
+		{
+			m_added.clear();
+			m_removed.clear();
+
+			purge();
+
+			// refresh the endpoint values from the proxies bounds
+			for (endpoint& e : m_endpoints)
+			{
+				const proxy& p = m_proxies[e.data >> 1];
+				e.value = (e.data & 1) ? p.max[m_axis] : p.min[m_axis];
+			}
+
+			// insertion sort, each swap between a min and a max endpoint
+			// starts or ends an overlap on the sweep axis
+			for (std::size_t i = 1; i < m_endpoints.size(); ++i)
+			{
+				const endpoint current = m_endpoints[i];
+				std::size_t j = i;
+				while (j > 0 && less(current, m_endpoints[j - 1]))
+				{
+					const endpoint& previous = m_endpoints[j - 1];
+					const bool currentIsMax = (current.data & 1) != 0;
+					const bool previousIsMax = (previous.data & 1) != 0;
+					if (currentIsMax != previousIsMax)
+					{
+						const std::uint64_t k = key(current.data >> 1, previous.data >> 1);
+						if (!currentIsMax)
+						{
+							// a reported pair may separate and overlap again
+							// within the same sort, restore it without events
+							auto dropped = std::find(m_dropped.begin(), m_dropped.end(), k);
+							if (dropped != m_dropped.end())
+							{
+								m_dropped.erase(dropped);
+								m_candidates.emplace(k, true);
+							}
+							else m_candidates.emplace(k, false);
+						}
+						else
+						{
+							auto it = m_candidates.find(k);
+							if (it != m_candidates.end())
+							{
+								if (it->second) m_dropped.push_back(k);
+								m_candidates.erase(it);
+							}
+						}
+					}
+					m_endpoints[j] = previous;
+					--j;
+				}
+				m_endpoints[j] = current;
+			}
+
+			for (const std::uint64_t k : m_dropped)
+			{
+				m_removed.push_back(to_pair(k));
+			}
+			m_dropped.clear();
+
+			// the candidates overlap on the sweep axis,
+			// check the other one to report the actual pairs
+			const unsigned int other = 1 - m_axis;
+			for (auto& candidate : m_candidates)
+			{
+				const proxy& a = m_proxies[static_cast<id_t>(candidate.first >> 32)];
+				const proxy& b = m_proxies[static_cast<id_t>(candidate.first & 0xffffffffu)];
+				const bool overlapping = (a.min[other] <= b.max[other]) & (b.min[other] <= a.max[other]);
+				if (overlapping != candidate.second)
+				{
+					(overlapping ? m_added : m_removed).push_back(to_pair(candidate.first));
+					candidate.second = overlapping;
+				}
+			}
+		}
+
+		// events produced by the last sweep
+		const std::vector<pair_t>& added() const { return m_added; }
+		const std::vector<pair_t>& removed() const { return m_removed; }
+
+		// all the overlapping pairs after the last sweep
+		void pairs(std::vector<pair_t>& result) const
+		{
+			for (const auto& candidate : m_candidates)
+			{
+				if (candidate.second)
+				{
+					result.push_back(to_pair(candidate.first));
+				}
+			}
+		}
+
+		void clear()
+		{
+			m_proxies.clear();
+			m_free.clear();
+			m_endpoints.clear();
+			m_candidates.clear();
+			m_dropped.clear();
+			m_added.clear();
+			m_removed.clear();
+		}
+
+	private:
+
+		struct proxy
+		{
+			T min[2];
+			T max[2];
+			bool alive;
+			// removed but not yet purged by a sweep
+			bool pending;
+		};
+
+		struct endpoint
+		{
+			T value;
+			// proxy id << 1 | is max
+			std::uint32_t data;
+		};
+
+		void set_bounds(proxy& p, const rectangle_t<T>& rect)
+		{
+			p.min[0] = rect.x - rect.width;
+			p.min[1] = rect.y - rect.height;
+			p.max[0] = rect.x + rect.width;
+			p.max[1] = rect.y + rect.height;
+		}
+
+		void purge()
+		{
+			bool found = false;
+			for (const proxy& p : m_proxies)
+			{
+				found |= p.pending;
+			}
+			if (!found) return;
+
+			m_endpoints.erase(std::remove_if(m_endpoints.begin(), m_endpoints.end(), [this](const endpoint& e)
+				{
+					return !m_proxies[e.data >> 1].alive;
+				}), m_endpoints.end());
+
+			for (auto it = m_candidates.begin(); it != m_candidates.end();)
+			{
+				const id_t a = static_cast<id_t>(it->first >> 32);
+				const id_t b = static_cast<id_t>(it->first & 0xffffffffu);
+				if (!m_proxies[a].alive || !m_proxies[b].alive)
+				{
+					if (it->second) m_removed.push_back(to_pair(it->first));
+					it = m_candidates.erase(it);
+				}
+				else ++it;
+			}
+
+			for (id_t id = 0; id < m_proxies.size(); ++id)
+			{
+				if (m_proxies[id].pending)
+				{
+					m_proxies[id].pending = false;
+					m_free.push_back(id);
+				}
+			}
+		}
+
+		// min endpoints come first on ties so that touching bounds overlap
+		static bool less(const endpoint& a, const endpoint& b)
+		{
+			return a.value < b.value
+				|| (a.value == b.value && (a.data & 1) < (b.data & 1));
+		}
+
+		static std::uint64_t key(const id_t a, const id_t b)
+		{
+			return a < b
+				? (static_cast<std::uint64_t>(a) << 32) | b
+				: (static_cast<std::uint64_t>(b) << 32) | a;
+		}
+
+		static pair_t to_pair(const std::uint64_t k)
+		{
+			return pair_t(static_cast<id_t>(k >> 32), static_cast<id_t>(k & 0xffffffffu));
+		}
+
+		unsigned int m_axis;
+		std::vector<proxy> m_proxies;
+		std::vector<id_t> m_free;
+		std::vector<endpoint> m_endpoints;
+		// pairs overlapping on the sweep axis,
+		// the value tells if the pair is overlapping on both axes
+		std::unordered_map<std::uint64_t, bool> m_candidates;
+		// reported pairs separated during the current sort
+		std::vector<std::uint64_t> m_dropped;
+		std::vector<pair_t> m_added;
+		std::vector<pair_t> m_removed;
+	};
+
+	// sweep and prune types
+
+	typedef sweep_and_prune_t<float> sweep_and_prune;
+	typedef sweep_and_prune_t<double> dsweep_and_prune;
+}
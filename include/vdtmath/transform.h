@@ -2,40 +2,58 @@
 
 #pragma once
 
+#include "affine3.h"
 #include "matrix4.h"
 #include "vector3.h"
 
 namespace math
 {
-	class transform
+	// the members are defined in transform.cpp, 
+	// instantiated for float and double
+	template <typename T>
+	class transform_t
 	{
 	public:
 
-		transform();
+		transform_t();
 
-		inline const matrix4& matrix() const { return m_matrix; }
+		inline const matrix4_t<T>& matrix() const { return m_matrix; }
+		// the cached matrix without its constant column, 25% smaller
+		// for instance buffers
+		inline affine3_t<T> affine() const { return affine3_t<T>(m_matrix); }
 
+		// rebuilds the matrix if a component has changed, unless the
+		// transform was static already, see transform_telemetry
 		void update();
 
-		vector3 position;
-		vector3 rotation;
-		vector3 scale;
+		vector3_t<T> position;
+		vector3_t<T> rotation;
+		vector3_t<T> scale;
 		bool isStatic;
 
 	private:
 
 		struct State
 		{
-			vector3 position;
-			vector3 rotation;
-			vector3 scale;	
+			vector3_t<T> position;
+			vector3_t<T> rotation;
+			vector3_t<T> scale;	
 
-			bool update(transform& transform);
+			bool update(transform_t& transform);
 		};
 
 		// cached matrix
-		matrix4 m_matrix;
+		matrix4_t<T> m_matrix;
 		bool m_wasStatic;
 		State m_state;
 	};
-}
\ No newline at end of file
+
+	// transform types
+
+	typedef transform_t<float> transform;
+	typedef transform_t<double> dtransform;
+}
+
+#if defined(VDTMATH_HEADER_ONLY)
+#include "../../source/transform.cpp"
+#endif
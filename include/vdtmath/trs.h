@@ -0,0 +1,178 @@
+/// Copyright (c) Vito Domenico Tagliente
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+#include "config.h"
+#include "matrix4.h"
+#include "quaternion.h"
+#include "vector3.h"
+
+namespace math
+{
+	// translation, rotation and scale of a transformation, the matrix is
+	// scale, then rotation, then translation as transform_t:
+	// matrix = scale(scale) * rotation.matrix() * translate(position)
+	template <typename T>
+	struct trs_t
+	{
+		vector3_t<T> position;
+		quaternion_t<T> rotation;
+		vector3_t<T> scale;
+
+		trs_t()
+			: position()
+			, rotation()
+			, scale(static_cast<T>(1.0))
+		{
+
+		}
+
+		trs_t(const vector3_t<T>& _position, const quaternion_t<T>& _rotation, const vector3_t<T>& _scale)
+			: position(_position)
+			, rotation(_rotation)
+			, scale(_scale)
+		{
+
+		}
+	};
+
+	// the matrix written element by element, without matrix products
+	template <typename T>
+	inline matrix4_t<T> compose(const trs_t<T>& trs)
+	{
+		const quaternion_t<T>& q = trs.rotation;
+		const T two = static_cast<T>(2.0);
+		const T xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+		const T xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+		const T wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+		const T sx = trs.scale.x, sy = trs.scale.y, sz = trs.scale.z;
+		const T one = static_cast<T>(1.0), zero = static_cast<T>(0.0);
+
+		return matrix4_t<T>(
+			sx * (one - two * (yy + zz)), sx * two * (xy + wz), sx * two * (xz - wy), zero,
+			sy * two * (xy - wz), sy * (one - two * (xx + zz)), sy * two * (yz + wx), zero,
+			sz * two * (xz + wy), sz * two * (yz - wx), sz * (one - two * (xx + yy)), zero,
+			trs.position.x, trs.position.y, trs.position.z, one
+		);
+	}
+
+	// inverse of compose for the matrices without shear or projection
+	// the rows of the upper 3x3 are orthogonalized in order (a QR
+	// decomposition by gram-schmidt), their lengths are the scale and a
+	// reflection is moved to the x scale, the shear of other matrices is
+	// dropped, false if a scale is zero
+	template <typename T>
+	inline bool decompose(const matrix4_t<T>& m, trs_t<T>& result)
+	{
+		const T zero = static_cast<T>(0.0), one = static_cast<T>(1.0);
+		result.position = vector3_t<T>(m.m30, m.m31, m.m32);
+
+		vector3_t<T> x(m.m00, m.m01, m.m02);
+		vector3_t<T> y(m.m10, m.m11, m.m12);
+		vector3_t<T> z(m.m20, m.m21, m.m22);
+
+		T sx = x.magnitude();
+		if (sx == zero) return false;
+		x *= one / sx;
+		y -= x * x.dot(y);
+		const T sy = y.magnitude();
+		if (sy == zero) return false;
+		y *= one / sy;
+		z -= x * x.dot(z) + y * y.dot(z);
+		const T sz = z.magnitude();
+		if (sz == zero) return false;
+		z *= one / sz;
+
+		if (x.cross(y).dot(z) < zero)
+		{
+			sx = -sx;
+			x = -x;
+		}
+		result.scale = vector3_t<T>(sx, sy, sz);
+
+		// the rows are the rotated axes, shepperd's method on the largest
+		// of the diagonal and the trace
+		const T quarter = static_cast<T>(0.25);
+		quaternion_t<T>& q = result.rotation;
+		const T trace = x.x + y.y + z.z;
+		if (trace > zero)
+		{
+			const T s = std::sqrt(trace + one) * static_cast<T>(2.0);
+			q = quaternion_t<T>((y.z - z.y) / s, (z.x - x.z) / s, (x.y - y.x) / s, quarter * s);
+		}
+		else if (x.x > y.y && x.x > z.z)
+		{
+			const T s = std::sqrt(one + x.x - y.y - z.z) * static_cast<T>(2.0);
+			q = quaternion_t<T>(quarter * s, (x.y + y.x) / s, (x.z + z.x) / s, (y.z - z.y) / s);
+		}
+		else if (y.y > z.z)
+		{
+			const T s = std::sqrt(one + y.y - x.x - z.z) * static_cast<T>(2.0);
+			q = quaternion_t<T>((x.y + y.x) / s, quarter * s, (y.z + z.y) / s, (z.x - x.z) / s);
+		}
+		else
+		{
+			const T s = std::sqrt(one + z.z - x.x - y.y) * static_cast<T>(2.0);
+			q = quaternion_t<T>((x.z + z.x) / s, (y.z + z.y) / s, quarter * s, (x.y - y.x) / s);
+		}
+		return true;
+	}
+
+	// linear position and scale, normalized linear rotation along the
+	// shortest arc, close to slerp for the small steps of animation
+	// blending and network smoothing
+	template <typename T>
+	inline trs_t<T> interpolate(const trs_t<T>& a, const trs_t<T>& b, const T weight)
+	{
+		const T sign = a.rotation.dot(b.rotation) < static_cast<T>(0.0) ? -static_cast<T>(1.0) : static_cast<T>(1.0);
+		quaternion_t<T> rotation = b.rotation * sign;
+		rotation -= a.rotation;
+		rotation *= weight;
+		rotation += a.rotation;
+		rotation /= rotation.length();
+		return trs_t<T>(
+			a.position + (b.position - a.position) * weight,
+			rotation,
+			a.scale + (b.scale - a.scale) * weight
+		);
+	}
+
+	template <typename T>
+	inline void compose(const trs_t<T>* transforms, matrix4_t<T>* result, const std::size_t count)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+			result[i] = compose(transforms[i]);
+	}
+
+	// the return value is the number of matrices decomposed,
+	// see decompose(matrix, result)
+	template <typename T>
+	inline std::size_t decompose(const matrix4_t<T>* matrices, trs_t<T>* result, const std::size_t count)
+	{
+		std::size_t decomposed = 0;
+		for (std::size_t i = 0; i < count; ++i)
+			decomposed += decompose(matrices[i], result[i]) ? 1 : 0;
+		return decomposed;
+	}
+
+	// trs types
+
+	typedef trs_t<float> trs;
+	typedef trs_t<double> dtrs;
+
+	static_assert(sizeof(trs) == 10 * sizeof(float), "the trs arrays are read with a float stride");
+
+	// result[i] = interpolate(a[i], b[i], weight), the kernel of the
+	// active simd level, see cpu.h, the result can alias the inputs
+	VDTMATH_API void blend(const trs* a, const trs* b, const float weight, trs* result, const std::size_t count);
+
+	// one weight per element
+	VDTMATH_API void blend(const trs* a, const trs* b, const float* weights, trs* result, const std::size_t count);
+}
+
+#if defined(VDTMATH_HEADER_ONLY)
+#include "kernels.h"
+#endif
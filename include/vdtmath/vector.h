@@ -5,6 +5,7 @@
 #include "vector2.h"
 #include "vector3.h"
 #include "vector4.h"
+#include "vector_n.h"
 
 namespace math
 {
@@ -0,0 +1,396 @@
+/// Copyright (c) Vito Domenico Tagliente
+
+#pragma once
+#pragma warning(disable : 4201)
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace math
+{
+	template <typename T, std::size_t N>
+	struct vector_t;
+
+	namespace detail
+	{
+		// selects the constructor that initializes every element
+		struct elements_tag {};
+
+		template <typename T, typename... A>
+		struct all_convertible : std::conjunction<std::is_convertible<A, T>...> {};
+
+		// vector storage, the 2, 3 and 4 sizes expose the named components
+		// the constructors always initialize the data array, so that
+		// the generic operations can be evaluated at compile time
+		template <typename T, std::size_t N>
+		struct vector_base
+		{
+			T data[N];
+
+			constexpr vector_base()
+				: data()
+			{
+
+			}
+
+			template <typename... A>
+			constexpr vector_base(const elements_tag, const A... values)
+				: data{ values... }
+			{
+
+			}
+		};
+
+		template <typename T>
+		struct vector_base<T, 2>
+		{
+			union
+			{
+				struct
+				{
+					T x, y;
+				};
+
+				T data[2];
+			};
+
+			constexpr vector_base()
+				: data()
+			{
+
+			}
+
+			template <typename... A>
+			constexpr vector_base(const elements_tag, const A... values)
+				: data{ values... }
+			{
+
+			}
+		};
+
+		template <typename T>
+		struct vector_base<T, 3>
+		{
+			union
+			{
+				struct
+				{
+					T x, y, z;
+				};
+
+				T data[3];
+			};
+
+			constexpr vector_base()
+				: data()
+			{
+
+			}
+
+			template <typename... A>
+			constexpr vector_base(const elements_tag, const A... values)
+				: data{ values... }
+			{
+
+			}
+		};
+
+		template <typename T>
+		struct vector_base<T, 4>
+		{
+			union
+			{
+				struct
+				{
+					T x, y, z, w;
+				};
+
+				T data[4];
+			};
+
+			constexpr vector_base()
+				: data()
+			{
+
+			}
+
+			template <typename... A>
+			constexpr vector_base(const elements_tag, const A... values)
+				: data{ values... }
+			{
+
+			}
+		};
+	}
+
+	// fixed size vector, every operation is a loop over N
+	// that the compilers unroll
+	template <typename T, std::size_t N>
+	struct vector_t : detail::vector_base<T, N>
+	{
+		static_assert(N > 1, "a vector has at least 2 components");
+
+		typedef detail::vector_base<T, N> base;
+		using base::data;
+
+		static const vector_t zero;
+		static const vector_t ones;
+		// axis directions, available according to the size
+		static const vector_t right;
+		static const vector_t up;
+		static const vector_t forward;
+
+		static constexpr std::size_t length = N;
+
+		constexpr vector_t()
+			: base()
+		{
+
+		}
+
+		constexpr vector_t(const T value)
+			: vector_t(value, std::make_index_sequence<N>())
+		{
+
+		}
+
+		// one value per component
+		template <typename... A, typename = typename std::enable_if<sizeof...(A) == N && detail::all_convertible<T, A...>::value>::type>
+		constexpr vector_t(const A... values)
+			: base(detail::elements_tag(), static_cast<T>(values)...)
+		{
+
+		}
+
+		// precision conversion
+		template <typename U>
+		constexpr explicit vector_t(const vector_t<U, N>& vector)
+			: vector_t(vector, std::make_index_sequence<N>())
+		{
+
+		}
+
+		constexpr vector_t(const vector_t& vector) = default;
+
+		constexpr std::size_t size() const
+		{
+			return length;
+		}
+
+		// return the i-index component
+		constexpr T& operator[] (const unsigned int i)
+		{
+			return data[i];
+		}
+
+		constexpr T operator[] (const unsigned int i) const
+		{
+			return data[i];
+		}
+
+		constexpr T& operator() (const unsigned int i)
+		{
+			return data[i];
+		}
+
+		constexpr T operator() (const unsigned int i) const
+		{
+			return data[i];
+		}
+
+		// compute the magnitude
+		// magnitude = sqrt(x1 * x1 + x2 * x2 + ... + xn * xn)
+		T magnitude() const
+		{
+			using std::sqrt;
+			return static_cast<T>(sqrt(dot(*this)));
+		}
+
+		// compute the distance between another vector
+		T distance(const vector_t& vector) const
+		{
+			return (*this - vector).magnitude();
+		}
+
+		// dot product
+		constexpr T dot(const vector_t& vector) const
+		{
+			T result = data[0] * vector.data[0];
+			for (std::size_t i = 1; i < N; ++i)
+				result += data[i] * vector.data[i];
+			return result;
+		}
+
+		// cross product
+		constexpr vector_t cross(const vector_t& vector) const
+		{
+			static_assert(N == 3, "the cross product is defined for 3 components");
+			return vector_t(
+				data[1] * vector.data[2] - data[2] * vector.data[1],
+				data[2] * vector.data[0] - data[0] * vector.data[2],
+				data[0] * vector.data[1] - data[1] * vector.data[0]
+			);
+		}
+
+		// scalar triple product
+		constexpr T triple(const vector_t& vector1, const vector_t& vector2) const
+		{
+			return cross(vector1).dot(vector2);
+		}
+
+		// normalize the vector
+		vector_t normalize()
+		{
+			const T mag = magnitude();
+			if (mag != static_cast<T>(0.0))
+			{
+				(*this *= (static_cast<T>(1.0) / mag));
+			}
+			return *this;
+		}
+
+		vector_t project(const vector_t& v) const
+		{
+			const T d = v.dot(v);
+			assert(d != static_cast<T>(0.0));
+			return v * (dot(v) / d);
+		}
+
+		vector_t reject(const vector_t& v) const
+		{
+			return *this - project(v);
+		}
+
+		// Operators overloading
+
+		constexpr vector_t& operator= (const vector_t& vector) = default;
+
+		constexpr bool operator== (const vector_t& vector) const
+		{
+			for (std::size_t i = 0; i < N; ++i)
+				if (data[i] != vector.data[i]) return false;
+			return true;
+		}
+
+		constexpr bool operator!= (const vector_t& vector) const
+		{
+			return !(*this == vector);
+		}
+
+		constexpr vector_t& operator+= (const vector_t& vector)
+		{
+			for (std::size_t i = 0; i < N; ++i)
+				data[i] += vector.data[i];
+			return *this;
+		}
+
+		constexpr vector_t& operator-= (const vector_t& vector)
+		{
+			for (std::size_t i = 0; i < N; ++i)
+				data[i] -= vector.data[i];
+			return *this;
+		}
+
+		constexpr vector_t& operator*= (const T scalar)
+		{
+			for (std::size_t i = 0; i < N; ++i)
+				data[i] *= scalar;
+			return *this;
+		}
+
+		constexpr vector_t& operator/= (const T scalar)
+		{
+			assert(scalar != static_cast<T>(0.0));
+			const T f = static_cast<T>(1.0) / scalar;
+			return (*this) *= f;
+		}
+
+		constexpr vector_t operator- () const
+		{
+			vector_t result;
+			for (std::size_t i = 0; i < N; ++i)
+				result.data[i] = -data[i];
+			return result;
+		}
+
+		constexpr vector_t operator+ (const vector_t& vector) const
+		{
+			vector_t result;
+			for (std::size_t i = 0; i < N; ++i)
+				result.data[i] = data[i] + vector.data[i];
+			return result;
+		}
+
+		constexpr vector_t operator- (const vector_t& vector) const
+		{
+			vector_t result;
+			for (std::size_t i = 0; i < N; ++i)
+				result.data[i] = data[i] - vector.data[i];
+			return result;
+		}
+
+		constexpr vector_t operator* (const T scalar) const
+		{
+			vector_t result;
+			for (std::size_t i = 0; i < N; ++i)
+				result.data[i] = data[i] * scalar;
+			return result;
+		}
+
+		constexpr vector_t operator/ (const T scalar) const
+		{
+			assert(scalar != static_cast<T>(0.0));
+			const T f = static_cast<T>(1.0) / scalar;
+			return (*this) * f;
+		}
+
+		// dot product
+		constexpr T operator* (const vector_t& vector) const
+		{
+			return dot(vector);
+		}
+
+	private:
+
+		template <std::size_t... I>
+		constexpr vector_t(const T value, std::index_sequence<I...>)
+			: base(detail::elements_tag(), ((void)I, value)...)
+		{
+
+		}
+
+		template <typename U, std::size_t... I>
+		constexpr vector_t(const vector_t<U, N>& vector, std::index_sequence<I...>)
+			: base(detail::elements_tag(), static_cast<T>(vector.data[I])...)
+		{
+
+		}
+	};
+
+	template <typename T, std::size_t N>
+	constexpr vector_t<T, N> operator* (const T scalar, const vector_t<T, N>& vector)
+	{
+		return vector * scalar;
+	}
+
+	namespace detail
+	{
+		template <typename T, std::size_t N, std::size_t Axis>
+		constexpr vector_t<T, N> axis(const T value)
+		{
+			static_assert(Axis < N, "the axis is not available for this size");
+			vector_t<T, N> result;
+			result.data[Axis] = value;
+			return result;
+		}
+	}
+
+	template <typename T, std::size_t N> const vector_t<T, N> vector_t<T, N>::zero = vector_t<T, N>();
+	template <typename T, std::size_t N> const vector_t<T, N> vector_t<T, N>::ones = vector_t<T, N>(static_cast<T>(1.0));
+	template <typename T, std::size_t N> const vector_t<T, N> vector_t<T, N>::right = detail::axis<T, N, 0>(static_cast<T>(1.0));
+	template <typename T, std::size_t N> const vector_t<T, N> vector_t<T, N>::up = detail::axis<T, N, 1>(static_cast<T>(1.0));
+	template <typename T, std::size_t N> const vector_t<T, N> vector_t<T, N>::forward = detail::axis<T, N, 2>(-static_cast<T>(1.0));
+}
@@ -0,0 +1,10 @@
+// a translation unit including a single leaf header and not math.h,
+// header only builds must still compile and link it
+#include <vdtmath/quantize.h>
+
+std::uint16_t leaf_encode_half(const float value)
+{
+	std::uint16_t half = 0;
+	math::encode_half(&value, &half, 1);
+	return half;
+}
@@ -1,10 +1,15 @@
 #include <cassert>
+#include <cstring>
 #include <iostream>
+#include <sstream>
 #include <vdtmath/math.h>
 
 using namespace std;
 using namespace math;
 
+// see leaf.cpp
+std::uint16_t leaf_encode_half(float value);
+
 int main()
 {
 	bool canInvert = false;
@@ -32,6 +37,40 @@ int main()
 		assert(a * a.inverse(canInvert) == matrix2::identity);
 	}
 
+	// constexpr matrix2
+	{
+		constexpr matrix2 a(
+			2.f, 1.f,
+			1.f, 1.f
+		);
+		static_assert(a * matrix2(1.f, -1.f, -1.f, 2.f) == matrix2(1.f, 0.f, 0.f, 1.f), "matrix2 product");
+		static_assert(a.transpose().determinant() == 1.f, "matrix2 determinant");
+		static_assert(a * vec2(1.f, 2.f) == vec2(4.f, 3.f), "matrix2 vector product");
+	}
+
+	// affine2
+	{
+		constexpr affine2 move = affine2::translate(vec2(1.f, 2.f));
+		constexpr affine2 stretch = affine2::scale(vec2(2.f, 4.f));
+		static_assert((move * stretch).transform_point(vec2(1.f, 1.f)) == vec2(4.f, 12.f), "affine2 compose");
+		static_assert((stretch * move).transform_vector(vec2(1.f, 1.f)) == vec2(2.f, 4.f), "affine2 vector");
+
+		const affine2 a = affine2::rotate(90.f) * move * stretch;
+		const affine2 b = a.inverse(canInvert);
+		assert(canInvert);
+		const vec2 p = b.transform_point(a.transform_point(vec2(3.f, -2.f)));
+		assert(std::abs(p.x - 3.f) < 1e-5f && std::abs(p.y + 2.f) < 1e-5f);
+
+		vec2 points[3] = { vec2(0.f, 0.f), vec2(1.f, 1.f), vec2(-1.f, 2.f) };
+		transform_points(move * stretch, points, points, 3);
+		assert(points[0] == vec2(2.f, 8.f) && points[2] == vec2(0.f, 16.f));
+		affine2().inverse(canInvert);
+		assert(canInvert);
+		affine2::scale(vec2(0.f, 1.f)).inverse(canInvert);
+		assert(!canInvert);
+		(void)p;
+	}
+
 	// unit testing matrix3
 	{
 		const matrix3 a(
@@ -56,6 +95,15 @@ int main()
 
 		// matrix multiplication
 		assert(a * a.inverse(canInvert) == matrix3::identity);
+
+		// normal matrix
+		const matrix4 scaled = matrix4::scale(vec3(2.f, 4.f, 1.f)) * matrix4::translate(vec3(1.f, 2.f, 3.f));
+		assert(normal_matrix(scaled) == matrix3(
+			0.5f, 0.f, 0.f,
+			0.f, 0.25f, 0.f,
+			0.f, 0.f, 1.f
+		));
+		(void)scaled;
 	}
 
 	// unit testing matrix4
@@ -130,9 +178,1371 @@ int main()
 
 	}
 
+	// generic sizes
+	{
+		static_assert(sizeof(vec3) == 3 * sizeof(float) && sizeof(mat4) == 16 * sizeof(float), "no per instance members");
+
+		const vector_t<float, 8> features(2.f);
+		assert(features.dot(features) == 32.f);
+
+		const matrix_t<float, 3, 4> m(1.f);
+		assert(m * vec4(1.f, 2.f, 3.f, 4.f) == vec3(10.f, 10.f, 10.f));
+		assert(m.transpose() * vec3(1.f, 1.f, 1.f) == vec4(3.f, 3.f, 3.f, 3.f));
+
+		matrix_t<double, 5, 5> big(1.0);
+		for (unsigned int i = 0; i < 5; ++i) big(i, i) = 3.0;
+		assert(big.determinant() == 112.0);
+		const matrix_t<double, 5, 5> product = big * big.inverse(canInvert);
+		assert(canInvert);
+		for (unsigned int i = 0; i < 25; ++i)
+			assert(std::abs(product.data[i] - matrix_t<double, 5, 5>::identity.data[i]) < 1e-12);
+
+		const matrix4 axis = matrix4::rotate(vec3(0.f, 0.f, 1.f), 90.f);
+		const matrix4 z = matrix4::rotate_z(90.f);
+		assert(std::abs(axis.m01 - z.m01) < 1e-6f && std::abs(axis.m10 - z.m10) < 1e-6f);
+		(void)product;
+		(void)axis;
+		(void)z;
+	}
+
+	// affine3
+	{
+		const matrix4 m = matrix4::scale(vec3(2.f, 4.f, 1.f)) * matrix4::rotate_z(90.f) * matrix4::translate(vec3(1.f, 2.f, 3.f));
+		const matrix4 n = matrix4::translate(vec3(-1.f, 0.f, 5.f)) * matrix4::scale(vec3(0.5f, 0.5f, 2.f));
+		const affine3 a(m), b(n);
+		assert(to_matrix4(a) == m);
+		assert(a * b == affine3(m * n));
+
+		const vec3 p(3.f, -2.f, 1.f);
+		const vec4 q = vec4(p.x, p.y, p.z, 1.f);
+		const vec3 ap = a.transform_point(p);
+		assert(std::abs(ap.x - (q * vec4(m.m00, m.m10, m.m20, m.m30))) < 1e-5f);
+		assert(std::abs(ap.y - (q * vec4(m.m01, m.m11, m.m21, m.m31))) < 1e-5f);
+
+		const vec3 back = a.inverse(canInvert).transform_point(ap);
+		assert(canInvert && std::abs(back.x - p.x) < 1e-5f && std::abs(back.y - p.y) < 1e-5f && std::abs(back.z - p.z) < 1e-5f);
+
+		math::transform t;
+		t.position = vec3(1.f, 2.f, 3.f);
+		t.update();
+		assert(t.affine().translation() == vec3(1.f, 2.f, 3.f));
+		(void)q;
+		(void)back;
+	}
+
+	// expression templates
+	{
+		const vec3 a(1.f, 2.f, 3.f), b(4.f, 5.f, 6.f), c(1.f, 1.f, 1.f);
+		const vec3 r = lazy(a) * 2.f + b - c;
+		assert(r == a * 2.f + b - c);
+		assert(vec3(-(lazy(a) - b) / 3.f) == vec3(1.f, 1.f, 1.f));
+
+		const matrix4 m = lazy(matrix4::identity) * 2.f - matrix4::identity;
+		assert(m == matrix4::identity);
+
+		const std::vector<float> xs = { 1.f, 2.f, 3.f, 4.f, 5.f };
+		std::vector<float> ys = { 5.f, 4.f, 3.f, 2.f, 1.f };
+		evaluate(2.f * lazy(xs) + ys - xs, ys);
+		assert(ys == std::vector<float>(5, 6.f));
+		(void)r;
+		(void)m;
+	}
+
 	// rectangle
 	{
 		rectangle rect(0.f, 0.f, 100.f, 100.f);
 		assert(rect.contains(vec2(10.f, 10.f)) == true);
+		assert(rect.intersects(rectangle(150.f, 0.f, 60.f, 10.f)) == true);
+		assert(rect.intersects(rectangle(0.f, 150.f, 10.f, 40.f)) == false);
+	}
+
+	// rectangle array
+	{
+		const rectangle rects[4] = {
+			rectangle(0.f, 0.f, 1.f, 1.f),
+			rectangle(1.5f, 0.f, 1.f, 1.f),
+			rectangle(10.f, 10.f, 1.f, 1.f),
+			rectangle(0.f, 1.5f, 1.f, 1.f)
+		};
+		const rectangle_array array(rects, 4);
+
+		std::uint8_t mask[1] = {};
+		assert(array.contains(vec2(0.5f, 0.5f), mask) == 3);
+		assert(mask[0] == 0x0b);
+		assert(array.intersects(rectangle(10.f, 8.f, 1.f, 1.f), mask) == 1);
+		assert(mask[0] == 0x04);
+
+		std::vector<rectangle_array::pair_t> pairs;
+		array.overlaps(pairs);
+		assert(pairs.size() == 3);
+		assert(pairs[0] == rectangle_array::pair_t(0, 1));
+		assert(pairs[2] == rectangle_array::pair_t(1, 3));
+
+		assert(array.intersection_area(rectangle(0.f, 0.f, 1.f, 1.f)) == 6.f);
+		assert(array.bounds() == rectangle(5.f, 5.f, 6.f, 6.f));
+
+		// 0, 1 and 3 overlap each other, the pairs and the triple counted once
+		assert(array.area() == 16.f);
+		assert(array.union_area() == 14.f);
+		assert(rectangle_array().union_area() == 0.f);
+
+		// a nested, a repeated and a touching rectangle
+		const rectangle nested[4] = {
+			rectangle(0.f, 0.f, 2.f, 2.f),
+			rectangle(0.5f, 0.5f, 0.5f, 0.5f),
+			rectangle(0.f, 0.f, 2.f, 2.f),
+			rectangle(3.f, 0.f, 1.f, 1.f)
+		};
+		assert(rectangle_array(nested, 4).union_area() == 20.f);
+
+		drect_array doubles;
+		doubles.push_back(drectangle(0.0, 0.0, 1.0, 1.0));
+		doubles.push_back(drectangle(1.0, 0.0, 1.0, 1.0));
+		assert(doubles.union_area() == 6.0);
+		(void)nested;
+		(void)mask;
+	}
+
+	// circle
+	{
+		const circle c(0.f, 0.f, 2.f);
+		assert(c.contains(vec2(1.f, 1.f)) == true);
+		assert(c.intersects(circle(3.f, 0.f, 1.f)) == true);
+		assert(c.intersects(circle(3.5f, 0.f, 1.f)) == false);
+
+		const circle others[10] = {
+			circle(0.f, 0.f, 1.f), circle(10.f, 0.f, 1.f), circle(3.f, 0.f, 1.f), circle(0.f, 4.f, 1.f),
+			circle(0.f, 9.f, 1.f), circle(1.f, 1.f, 1.f), circle(-3.f, 0.f, 1.f), circle(5.f, 5.f, 1.f),
+			circle(2.f, 2.f, 1.f), circle(0.f, -20.f, 1.f)
+		};
+		std::uint8_t mask[2] = {};
+		assert(c.intersects(others, 10, mask) == 5);
+		assert(mask[0] == 0x65 && mask[1] == 0x01);
+
+		std::uint32_t indices[10] = {};
+		assert(c.intersects(others, 10, indices) == 5);
+		assert(indices[0] == 0 && indices[1] == 2 && indices[4] == 8);
+		(void)others;
+		(void)mask;
+		(void)indices;
+	}
+
+	// sweep and prune
+	{
+		sweep_and_prune sap;
+		const auto a = sap.insert(rectangle(0.f, 0.f, 1.f, 1.f));
+		const auto b = sap.insert(rectangle(1.5f, 0.f, 1.f, 1.f));
+		const auto c = sap.insert(circle(10.f, 0.f, 1.f));
+		sap.sweep();
+		assert(sap.added().size() == 1);
+		assert(sap.added()[0] == sweep_and_prune::pair_t(a, b));
+
+		// move c over a but far on y, then down on y only
+		sap.update(c, circle(0.f, 5.f, 1.f));
+		sap.sweep();
+		assert(sap.added().empty() && sap.removed().empty());
+		sap.update(c, circle(0.f, 1.5f, 1.f));
+		sap.sweep();
+		assert(sap.added().size() == 2 && sap.removed().empty());
+
+		sap.remove(a);
+		sap.sweep();
+		assert(sap.removed().size() == 2);
+
+		std::vector<sweep_and_prune::pair_t> pairs;
+		sap.pairs(pairs);
+		assert(pairs.size() == 1 && pairs[0] == sweep_and_prune::pair_t(b, c));
+		(void)b;
+	}
+
+	// ray
+	{
+		float distance = 0.f;
+		const ray2 r2(vec2(-5.f, 0.f), vec2(1.f, 0.f));
+		assert(r2.intersects(circle(0.f, 0.f, 1.f), distance) && distance == 4.f);
+		assert(r2.intersects(rectangle(0.f, 0.f, 2.f, 2.f), distance) && distance == 3.f);
+		assert(r2.intersects(rectangle(0.f, 5.f, 2.f, 2.f), distance) == false);
+		assert(ray2::segment(vec2(-5.f, 0.f), vec2(-4.f, 0.f)).intersects(circle(0.f, 0.f, 1.f), distance, 1.f) == false);
+
+		const ray3 r3(vec3(0.f, 0.f, 10.f), vec3(0.f, 0.f, -1.f));
+		assert(r3.intersects_sphere(vec3::zero, 2.f, distance) && distance == 8.f);
+		assert(r3.intersects_box(vec3(-1.f, -1.f, -1.f), vec3(1.f, 1.f, 1.f), distance) && distance == 9.f);
+		assert(r3.intersects_triangle(vec3(-1.f, -1.f, 0.f), vec3(1.f, -1.f, 0.f), vec3(0.f, 1.f, 0.f), distance) && distance == 10.f);
+		assert(r3.intersects_triangle(vec3(2.f, 2.f, 0.f), vec3(3.f, 2.f, 0.f), vec3(2.f, 3.f, 0.f), distance) == false);
+
+		ray3 rays[4] = {
+			r3,
+			ray3(vec3(5.f, 0.f, 10.f), vec3(0.f, 0.f, -1.f)),
+			ray3(vec3(0.f, 0.f, -10.f), vec3(0.f, 0.f, 1.f)),
+			ray3(vec3(-10.f, 0.5f, 0.f), vec3(1.f, 0.f, 0.f))
+		};
+		const ray3_packet4 packet(rays);
+		float distances[4] = {};
+		assert(packet.intersects_box(vec3(-1.f, -1.f, -1.f), vec3(1.f, 1.f, 1.f), distances) == 0xd);
+		assert(distances[0] == 9.f && distances[2] == 9.f && distances[3] == 9.f);
+		assert(packet.intersects_sphere(vec3::zero, 2.f, distances) == 0xd);
+		assert(packet.intersects_triangle(vec3(-1.f, -1.f, 0.f), vec3(1.f, -1.f, 0.f), vec3(0.f, 1.f, 0.f), distances) == 0x5);
+
+		// the default rays have the inverse of their direction
+		assert(ray3().inv_direction == ray3(vec3::zero, vec3::forward).inv_direction);
+		assert(ray2().inv_direction.x == 1.f);
+
+		// axis parallel rays on a face of the box, 0 * inf on that axis
+		const ray3 onFace(vec3(-1.f, 0.5f, 10.f), vec3(0.f, 0.f, -1.f));
+		const ray3 offFace(vec3(-1.5f, 0.5f, 10.f), vec3(0.f, 0.f, -1.f));
+		assert(onFace.intersects_box(vec3(-1.f, -1.f, -1.f), vec3(1.f, 1.f, 1.f), distance) && distance == 9.f);
+		assert(offFace.intersects_box(vec3(-1.f, -1.f, -1.f), vec3(1.f, 1.f, 1.f), distance) == false);
+		const ray3 faceRays[4] = { onFace, offFace, onFace, offFace };
+		assert(ray3_packet4(faceRays).intersects_box(vec3(-1.f, -1.f, -1.f), vec3(1.f, 1.f, 1.f), distances) == 0x5);
+		assert(ray2(vec2(-5.f, 2.f), vec2(1.f, 0.f)).intersects(rectangle(0.f, 0.f, 2.f, 2.f), distance) && distance == 3.f);
+		const ray2 edgeRays[4] = { ray2(vec2(-5.f, 2.f), vec2(1.f, 0.f)), ray2(vec2(-5.f, 2.5f), vec2(1.f, 0.f)), ray2(vec2(2.f, -5.f), vec2(0.f, 1.f)), ray2(vec2(-2.f, 5.f), vec2(0.f, -1.f)) };
+		assert(ray2_packet4(edgeRays).intersects(rectangle(0.f, 0.f, 2.f, 2.f), distances) == 0xd);
+
+		// the determinant of a small triangle is below the float epsilon
+		const float small = 0.0001f;
+		assert(r3.intersects_triangle(vec3(-small, -small, 0.f), vec3(small, -small, 0.f), vec3(0.f, small, 0.f), distance) && distance == 10.f);
+		assert(packet.intersects_triangle(vec3(-small, -small, 0.f), vec3(small, -small, 0.f), vec3(0.f, small, 0.f), distances) == 0x5);
+		assert(r3.intersects_triangle(vec3(0.f, 0.f, 0.f), vec3(0.f, 1.f, 0.f), vec3(0.f, 0.f, 1.f), distance) == false);
+		(void)distance;
+		(void)distances;
+		(void)faceRays;
+		(void)edgeRays;
+		(void)small;
+	}
+
+	// double precision
+	{
+		const dquat q(0.0, 0.0, 0.0, 1.0);
+		assert(q * dvec3(1.0, 2.0, 3.0) == dvec3(1.0, 2.0, 3.0));
+		assert(q.matrix() == dmat4::identity);
+
+		dtransform t;
+		t.position = dvec3(10000000.5, 0.0, -20000000.25);
+		t.update();
+
+		const dvec3 camera(10000000.0, 0.0, -20000000.0);
+		const mat4 relative = to_relative(t, camera);
+		assert(relative.m30 == .5f && relative.m32 == -.25f);
+		assert(to_relative(t.position, camera) == vec3(.5f, 0.f, -.25f));
+
+		const dmat4 view = dmat4::translate(-camera);
+		assert(to_relative_view(view, camera) == mat4::identity);
+		assert(mat4(dmat4::identity) == mat4::identity);
+
+		// the angles keep the double precision, 30.000001 is 30 in float
+		const double angle = 30.000001;
+		const double c = std::cos(radians(angle)), s = std::sin(radians(angle));
+		const dmat4 rotation = dmat4::rotate_z(angle);
+		assert(std::abs(rotation.m00 - c) < 1e-15 && std::abs(rotation.m10 - s) < 1e-15);
+		dtransform rotated;
+		rotated.rotation.z = angle;
+		rotated.update();
+		assert(std::abs(rotated.matrix().m00 - c) < 1e-15 && std::abs(rotated.matrix().m10 - s) < 1e-15);
+		(void)relative;
+		(void)view;
+		(void)c;
+		(void)s;
+		(void)rotation;
+	}
+
+	// fixed point, std::fixed is visible as well
+	{
+		typedef math::fixed real;
+		typedef vector2_t<real> rvec2;
+		typedef vector3_t<real> rvec3;
+
+		assert(real(1.5) * real(-2.25) == real(-3.375));
+		assert(real(7) / real(2) == real(3.5) && static_cast<int>(real(-3.75)) == -3);
+		assert(static_cast<real>(0.0) == real() && real(1) + 2 == real(3.0f));
+		assert(real::from_raw(1) > real(0) && -real(0.5) < real(0));
+		assert(std::numeric_limits<real>::max() + real::from_raw(1) == std::numeric_limits<real>::lowest());
+
+		// the narrow formats wrap at their own width
+		typedef fixed_t<8, 8> narrow;
+		assert(std::numeric_limits<narrow>::max() + narrow::from_raw(1) == std::numeric_limits<narrow>::lowest());
+		static_assert(narrow(300).raw() == 44 * 256 && narrow(-129).raw() == 127 * 256, "the narrow formats wrap at 16 bits");
+		assert(narrow(100) * narrow(2) == narrow(-56) && -std::numeric_limits<narrow>::lowest() == std::numeric_limits<narrow>::lowest());
+
+		assert(sqrt(real(16)) == real(4) && sqrt(real(2)).raw() == 92681);
+		for (int i = -40; i <= 40; ++i)
+		{
+			const real x(i * 0.25);
+			assert(std::abs(static_cast<double>(sin(x)) - std::sin(static_cast<double>(x))) < 2e-5);
+			assert(std::abs(static_cast<double>(cos(x)) - std::cos(static_cast<double>(x))) < 2e-5);
+			const real c(i / 40.0);
+			assert(std::abs(static_cast<double>(acos(c)) - std::acos(static_cast<double>(c))) < 2e-5);
+		}
+		// integer only, the same bits everywhere
+		assert(sin(real(1)).raw() == 55147 && cos(real(-2)).raw() == -27273);
+		assert(tan(real(0.5)).raw() == 35802 && acos(real(-0.3)).raw() == 122912);
+
+		const rvec3 a(real(3), real(4), real(0));
+		const rvec3 b(real(0), real(0), real(2));
+		assert(a.magnitude() == real(5));
+		assert(a.cross(b) == rvec3(real(8), real(-6), real(0)));
+		rvec3 unit = a;
+		unit.normalize();
+		assert(math::abs(unit.x - real(0.6)) <= real::from_raw(2) && math::abs(unit.y - real(0.8)) <= real::from_raw(2));
+
+		const matrix3_t<real> m(
+			real(2), real(0), real(0),
+			real(0), real(4), real(0),
+			real(1), real(2), real(1)
+		);
+		bool invertible = false;
+		const matrix3_t<real> inverse = m.inverse(invertible);
+		assert(invertible && m.determinant() == real(8));
+		assert(m * inverse == matrix3_t<real>::identity);
+
+		const rectangle_t<real> r(rvec2(real(0), real(0)), real(2), real(2));
+		assert(r.contains(rvec2(real(1.5), real(-1))));
+		assert(!r.contains(rvec2(real(2.5), real(0))));
+
+		// the rotations use the integer functions too
+		const real angle(30);
+		const real rad = radians(angle);
+		const matrix4_t<real> rotation = matrix4_t<real>::rotate_z(angle);
+		assert(rotation.m00 == cos(rad) && rotation.m10 == sin(rad) && rotation.m01 == -sin(rad));
+		assert(std::abs(static_cast<double>(rotation.m10) - 0.5) < 1e-4);
+		const affine2_t<real> planar = affine2_t<real>::rotate(angle);
+		assert(planar.m00 == cos(rad) && planar.m10 == sin(rad));
+		(void)inverse;
+		(void)rad;
+		(void)rotation;
+		(void)planar;
+	}
+
+	// aligned containers
+	{
+		aligned_array<vec3> points;
+		assert(points.empty() && points.data() == nullptr);
+		for (unsigned int i = 0; i < 100; ++i)
+			points.push_back(vec3(i * 1.f, 0.f, 0.f));
+		points.push_back(points[0]);
+		assert(points.size() == 101 && points.back() == vec3::zero);
+		assert(is_aligned(points.data(), 64));
+
+		const aligned_array<matrix4, 32> matrices = { matrix4::identity, matrix4::translate(vec3(1.f, 0.f, 0.f)) };
+		aligned_array<matrix4, 32> copy = matrices;
+		assert(copy.size() == 2 && copy[1] == matrices[1]);
+		copy.clear();
+		assert(copy.empty() && copy.capacity() >= 2);
+
+		std::vector<vec4, aligned_allocator<vec4>> vectors(3);
+		assert(is_aligned(vectors.data(), 64));
+
+		frame_arena arena(1024);
+		matrix4* const models = arena.allocate<matrix4>(8, matrix4::identity);
+		assert(is_aligned(models, 64) && models[7] == matrix4::identity);
+		assert(arena.used() == 8 * sizeof(matrix4));
+		// overflow, the arena grows with a new block
+		float* const scalars = arena.allocate<float>(1000);
+		assert(is_aligned(scalars, 64) && arena.capacity() > 1024);
+		scalars[999] = 1.f;
+		const std::size_t capacity = arena.capacity();
+		arena.reset();
+		assert(arena.used() == 0 && arena.capacity() == capacity);
+		arena.allocate<float>(1000);
+		assert(arena.capacity() == capacity);
+		(void)models;
+		(void)capacity;
+	}
+
+	// binary blobs
+	{
+		const char* const path = "vdtmath_sandbox.blob";
+		aligned_array<vec3> positions;
+		for (unsigned int i = 0; i < 1000; ++i)
+			positions.push_back(vec3(i * 1.f, i * 2.f, i * 3.f));
+		const quat rotations[2] = { quat(0.f, 0.f, 0.f, 1.f), quat(0.f, 1.f, 0.f, 0.f) };
+		const rect rects[1] = { rect(1.f, 2.f, 3.f, 4.f) };
+		const dvec2 large[1] = { dvec2(10000000.5, -2.25) };
+
+		blob_writer writer;
+		bool written = writer.open(path);
+		written &= writer.write("positions", positions.data(), positions.size());
+		written &= writer.write("rotations", rotations, 2);
+		// streamed in chunks
+		written &= writer.begin<matrix4>("bones");
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			const matrix4 bone = matrix4::translate(vec3(i * 1.f, 0.f, 0.f));
+			written &= writer.append(&bone, 1);
+		}
+		written &= writer.end();
+		written &= writer.write("rects", rects, 1);
+		written &= writer.write("large", large, 1);
+		written &= writer.close();
+		assert(written);
+
+		blob_reader reader;
+		const bool opened = reader.open(path);
+		assert(opened && !reader.swapped() && reader.array_count() == 5);
+		vec3 range[2];
+		const bool ranged = reader.read(reader.find("positions"), 998, 2, range);
+		assert(ranged && range[1] == positions[999]);
+		quat wrong[2];
+		const bool mismatched = reader.read(reader.find("positions"), 0, 2, wrong);
+		assert(!mismatched);
+		aligned_array<matrix4> bones;
+		const bool streamed = reader.read(reader.find("bones"), bones);
+		assert(streamed && bones.size() == 3 && bones[2].m30 == 2.f);
+		assert(reader.find("missing") == reader.array_count());
+		reader.close();
+
+		mapped_file file;
+		const bool mapped = file.open(path);
+		assert(mapped);
+		blob_view view;
+		const bool viewed = view.open(file.data(), file.size());
+		assert(viewed);
+		std::size_t count = 0;
+		const vec3* const positionData = view.data<vec3>("positions", count);
+		assert(positionData && count == 1000 && positionData[500] == positions[500] && is_aligned(positionData, blob_alignment));
+		assert(view.data<vec4>("positions", count) == nullptr && count == 0);
+		assert(view.data<dvec2>("large", count)[0] == large[0]);
+		assert(view.data<rect>("rects", count)[0].height == 4.f);
+		assert(!view.open(file.data(), sizeof(blob_header) - 1));
+
+		std::vector<unsigned char> bytes(static_cast<const unsigned char*>(file.data()), static_cast<const unsigned char*>(file.data()) + file.size());
+		file.close();
+		const auto save = [path](const std::vector<unsigned char>& data)
+			{
+				std::FILE* const out = std::fopen(path, "wb");
+				if (out == nullptr) return false;
+				const bool saved = std::fwrite(data.data(), 1, data.size(), out) == data.size();
+				return std::fclose(out) == 0 && saved;
+			};
+
+		// a corrupted table or a truncated file fail to open
+		std::vector<unsigned char> corrupted = bytes;
+		reinterpret_cast<blob_header*>(corrupted.data())->array_count = 0xffffffffu;
+		bool saved = save(corrupted);
+		assert(saved && !reader.open(path));
+		corrupted = bytes;
+		reinterpret_cast<blob_header*>(corrupted.data())->table_offset += 1;
+		saved = save(corrupted);
+		assert(saved && !reader.open(path));
+		corrupted.assign(bytes.begin(), bytes.end() - 64);
+		saved = save(corrupted);
+		assert(saved && !reader.open(path));
+
+		// a blob written with the other byte order
+		const auto swap = [](auto& field) { detail::swap_bytes(&field, sizeof(field), sizeof(field)); };
+		blob_header& header = *reinterpret_cast<blob_header*>(bytes.data());
+		blob_array* const arrays = reinterpret_cast<blob_array*>(bytes.data() + header.table_offset);
+		for (unsigned int i = 0; i < header.array_count; ++i)
+		{
+			blob_array& array = arrays[i];
+			detail::swap_bytes(bytes.data() + array.offset, static_cast<std::size_t>(array.count * array.element_size), array.scalar_size);
+			swap(array.type);
+			swap(array.element_size);
+			swap(array.scalar_size);
+			swap(array.count);
+			swap(array.offset);
+		}
+		swap(header.endian);
+		swap(header.version);
+		swap(header.array_count);
+		swap(header.table_offset);
+		swap(header.size);
+		saved = save(bytes);
+		assert(saved);
+		const bool remapped = file.open(path);
+		assert(remapped && !view.open(file.data(), file.size()));
+		file.close();
+		const bool swapped = reader.open(path);
+		assert(swapped && reader.swapped());
+		const bool swappedRange = reader.read(reader.find("positions"), 998, 2, range);
+		assert(swappedRange && range[1] == positions[999]);
+		dvec2 swappedLarge;
+		const bool swappedRead = reader.read(reader.find("large"), 0, 1, &swappedLarge);
+		assert(swappedRead && swappedLarge == large[0]);
+		reader.close();
+		(void)written;
+		(void)opened;
+		(void)ranged;
+		(void)mismatched;
+		(void)streamed;
+		(void)mapped;
+		(void)viewed;
+		(void)positionData;
+		(void)saved;
+		(void)remapped;
+		(void)swapped;
+		(void)swappedRange;
+		(void)swappedRead;
+		std::remove(path);
+	}
+
+	// quantization
+	{
+		assert(to_half(1.f) == 0x3c00 && to_half(-2.f) == 0xc000 && to_half(65520.f) == 0x7c00);
+		assert(from_half(to_half(0.1f)) == 0.0999755859375f);
+		assert(from_half(to_half(1e-7f)) == 1.1920928955078125e-07f);
+		assert(from_half(to_half(vec3(1.5f, -3.f, 0.f))) == vec3(1.5f, -3.f, 0.f));
+
+		// the NaN payloads are dropped, the signs kept
+		float payloadNan;
+		const std::uint32_t payloadBits = 0xff812345u;
+		std::memcpy(&payloadNan, &payloadBits, sizeof(payloadNan));
+		assert(to_half(payloadNan) == 0xfe00 && to_half(std::numeric_limits<float>::quiet_NaN()) == 0x7e00);
+		const float decodedNan = from_half(0x7c01);
+		std::uint32_t decodedBits;
+		std::memcpy(&decodedBits, &decodedNan, sizeof(decodedBits));
+		assert(decodedBits == 0x7fc00000u && from_half(0xfc00) == -std::numeric_limits<float>::infinity());
+		(void)payloadBits;
+		(void)decodedBits;
+
+		assert(decode_octahedral(encode_octahedral16(vec3::up)) == vec3::up);
+		assert(decode_octahedral(encode_octahedral32(vec3(0.f, 0.f, -1.f))) == vec3(0.f, 0.f, -1.f));
+		const vec3 normal = vec3(1.f, -2.f, -3.f).normalize();
+		// sine of the angular error
+		assert(decode_octahedral(encode_octahedral16(normal)).cross(normal).magnitude() < 0.017f);
+		assert(decode_octahedral(encode_octahedral32(normal)).cross(normal).magnitude() < 7e-5f);
+
+		const quat q = quat(0.2f, -0.4f, 0.1f, -0.8f).normalize();
+		const quat q32 = decode_quaternion(encode_quaternion32(q));
+		const quat q48 = decode_quaternion(encode_quaternion48(q));
+		// the largest component, w, is made positive
+		assert(std::abs(q32.x + q.x) < 2e-3f && std::abs(q32.w + q.w) < 2e-3f);
+		assert(std::abs(q48.y + q.y) < 7e-5f && std::abs(q48.w + q.w) < 7e-5f);
+
+		const position_quantizer quantizer(vec3(-100.f, 0.f, -10.f), vec3(100.f, 20.f, 10.f), 12);
+		const vec3 position(33.3f, 21.f, -10.f);
+		const vec3 decoded = quantizer.decode(quantizer.encode(position));
+		assert(std::abs(decoded.x - position.x) <= quantizer.error().x * 1.01f);
+		// clamped to the box
+		assert(decoded.y == 20.f && decoded.z == -10.f);
+		(void)normal;
+		(void)q32;
+		(void)q48;
+		(void)decoded;
+	}
+
+	// animation curves
+	{
+		float_curve linear;
+		linear.add_key(0.f, 1.f);
+		linear.add_key(1.f, 3.f);
+		linear.add_key(3.f, -1.f);
+		assert(linear.evaluate(0.5f) == 2.f && linear.evaluate(2.f) == 1.f);
+		// clamped
+		assert(linear.evaluate(-1.f) == 1.f && linear.evaluate(5.f) == -1.f);
+
+		float_curve step(interpolation::step);
+		step.add_key(0.f, 1.f);
+		step.add_key(1.f, 3.f);
+		assert(step.evaluate(0.99f) == 1.f && step.evaluate(1.f) == 3.f);
+
+		// a straight line with tangents matching its slope
+		float_curve hermite(interpolation::hermite);
+		hermite.add_key(0.f, 0.f, 2.f, 2.f);
+		hermite.add_key(2.f, 4.f, 2.f, 2.f);
+		assert(std::abs(hermite.evaluate(0.5f) - 1.f) < 1e-6f);
+
+		float_curve catmull(interpolation::catmull_rom);
+		for (int i = 0; i < 5; ++i)
+			catmull.add_key(static_cast<float>(i), static_cast<float>(i * 3));
+		assert(catmull.evaluate(2.f) == 6.f && std::abs(catmull.evaluate(2.5f) - 7.5f) < 1e-5f);
+
+		// control points at a third and two thirds of a line
+		float_curve bezier(interpolation::bezier);
+		bezier.add_key(0.f, 0.f, 0.f, 1.f);
+		bezier.add_key(1.f, 3.f, 2.f, 3.f);
+		assert(std::abs(bezier.evaluate(0.25f) - 0.75f) < 1e-6f);
+
+		// monotonic playback and a seek backwards
+		curve_cursor cursor;
+		for (int i = 0; i <= 40; ++i)
+		{
+			const float time = i * 0.1f;
+			const float value = catmull.evaluate(time, cursor);
+			assert(value == catmull.evaluate(time));
+			(void)value;
+		}
+		assert(cursor.segment == 3);
+		assert(catmull.evaluate(0.5f, cursor) == catmull.evaluate(0.5f) && cursor.segment == 0);
+
+		// the second key is flipped to the hemisphere of the first one
+		quaternion_curve rotation;
+		rotation.add_key(0.f, quat(0.f, 0.f, 0.f, 1.f));
+		rotation.add_key(1.f, quat(0.f, -0.7071068f, 0.f, -0.7071068f));
+		const quat half = rotation.evaluate(0.5f);
+		assert(std::abs(half.length() - 1.f) < 1e-6f);
+		assert(half.w > 0.9f && half.y > 0.38f && half.y < 0.39f);
+		(void)half;
+	}
+
+	// splines
+	{
+		const cubic_bezier2 line(vector2(0.f, 0.f), vector2(1.f, 0.f), vector2(2.f, 0.f), vector2(3.f, 0.f));
+		assert(line.evaluate(0.5f) == vector2(1.5f, 0.f) && line.derivative(0.2f) == vector2(3.f, 0.f));
+
+		const cubic_bezier2 arc(vector2(0.f, 0.f), vector2(0.f, 1.f), vector2(1.f, 1.f), vector2(1.f, 0.f));
+		vector2 samples[9];
+		arc.tessellate(8, samples);
+		for (unsigned int i = 0; i <= 8; ++i)
+			assert((samples[i] - arc.evaluate(i / 8.f)).magnitude() < 1e-5f);
+		cubic_bezier2 left, right;
+		arc.split(0.25f, left, right);
+		assert((right.evaluate(0.5f) - arc.evaluate(0.625f)).magnitude() < 1e-6f);
+
+		const quadratic_bezier3 quadratic(vec3(0.f, 0.f, 0.f), vec3(1.f, 2.f, 0.f), vec3(2.f, 0.f, 1.f));
+		assert((quadratic.cubic().evaluate(0.3f) - quadratic.evaluate(0.3f)).magnitude() < 1e-6f);
+
+		std::vector<vector2> polyline;
+		polyline.push_back(arc.p0);
+		flatten(arc, 0.001f, polyline);
+		assert(polyline.size() > 8 && polyline.back() == arc.p3);
+		for (std::size_t i = 1; i < polyline.size(); ++i)
+		{
+			// the middle of each chord is near the curve
+			const vector2 middle = (polyline[i - 1] + polyline[i]) * 0.5f;
+			float nearest = 1.f;
+			for (unsigned int k = 0; k <= 1000; ++k)
+				nearest = std::min(nearest, (arc.evaluate(k / 1000.f) - middle).magnitude());
+			assert(nearest < 0.0015f);
+		}
+
+		const vec3 points[] = { vec3(0.f, 0.f, 0.f), vec3(1.f, 1.f, 0.f), vec3(2.f, 0.f, 0.f), vec3(3.f, 1.f, 1.f) };
+		const spline3 catmull(spline_type::catmull_rom, points, 4);
+		assert(catmull.segment_count() == 3);
+		assert(catmull.evaluate(0.f) == points[0] && catmull.evaluate(2.f) == points[2] && catmull.evaluate(9.f) == points[3]);
+		const spline3 bspline(spline_type::bspline, points, 4);
+		assert(bspline.segment_count() == 1);
+		assert((bspline.evaluate(0.f) - vec3(1.f, 4.f / 6.f, 0.f)).magnitude() < 1e-6f);
+
+		// a straight path has the exact length
+		const vec3 straight[] = { vec3(0.f, 0.f, 0.f), vec3(1.f, 0.f, 0.f), vec3(2.f, 0.f, 0.f), vec3(4.f, 0.f, 0.f) };
+		const spline3 path(spline_type::bezier, straight, 4);
+		const arc_length_table3 table(path, 32);
+		assert(std::abs(table.length() - 4.f) < 1e-5f);
+		const float distances[] = { 0.f, 1.f, 2.5f, 4.f, 7.f };
+		vec3 moved[5];
+		table.evaluate(path, distances, moved, 5);
+		assert(std::abs(moved[1].x - 1.f) < 1e-3f && std::abs(moved[2].x - 2.5f) < 1e-3f);
+		assert(moved[0] == straight[0] && moved[4] == straight[3]);
+
+		// a quarter of a unit circle
+		const float k = 0.5522848f;
+		spline2 circle;
+		circle.add_segment(cubic_bezier2(vector2(1.f, 0.f), vector2(1.f, k), vector2(k, 1.f), vector2(0.f, 1.f)));
+		assert(std::abs(arc_length_table2(circle).length() - pi / 2.f) < 1e-3f);
+	}
+
+	// camera
+	{
+		const vec3 eye(1.f, 2.f, 5.f), target(1.f, 2.f, 0.f);
+		const matrix4 view = look_at(eye, target, vec3::up);
+		// the target is in front, down -z
+		vec3 transformed;
+		transform_points(view, &target, &transformed, 1);
+		assert((transformed - vec3(0.f, 0.f, -5.f)).magnitude() < 1e-6f);
+
+		// the depths of the near and far planes
+		const float fov = radians(60.f);
+		const vec3 nearPoint(0.f, 0.f, -0.1f), farPoint(0.f, 0.f, -100.f);
+		vec3 depth;
+		project_points(perspective_reverse_z(fov, 1.5f, 0.1f, 100.f), &nearPoint, &depth, 1);
+		assert(std::abs(depth.z - 1.f) < 1e-6f);
+		project_points(perspective_reverse_z(fov, 1.5f, 0.1f, 100.f), &farPoint, &depth, 1);
+		assert(std::abs(depth.z) < 1e-6f);
+		project_points(perspective_infinite_reverse_z(fov, 1.5f, 0.1f), &farPoint, &depth, 1);
+		assert(depth.z > 0.f && std::abs(depth.z - 0.001f) < 1e-7f);
+		project_points(perspective_infinite(fov, 1.5f, 0.1f), &nearPoint, &depth, 1);
+		assert(std::abs(depth.z + 1.f) < 1e-6f);
+		// the same x and y as the finite projection
+		assert(std::abs(perspective_infinite(fov, 1.5f, 0.1f).m00 - matrix4::perspective(fov, 1.5f, 0.1f, 100.f).m00) < 1e-6f);
+
+		// the frustum of the reverse z projections, spheres of radius 0.01
+		// before the near plane, inside and beyond the far plane
+		const vector4 depthSpheres[3] = { vector4(0.f, 0.f, -0.05f, 0.01f), vector4(0.f, 0.f, -50.f, 0.01f), vector4(0.f, 0.f, -200.f, 0.01f) };
+		vector4 depthPlanes[6];
+		std::uint8_t depthMask[1] = {};
+		frustum_planes(perspective_reverse_z(fov, 1.5f, 0.1f, 100.f), depthPlanes, clip_depth::one_to_zero);
+		assert(cull_spheres(depthPlanes, depthSpheres, 3, depthMask) == 1 && depthMask[0] == 0x02);
+		frustum_planes(perspective_infinite_reverse_z(fov, 1.5f, 0.1f), depthPlanes, clip_depth::one_to_zero);
+		assert(cull_spheres(depthPlanes, depthSpheres, 3, depthMask) == 2 && depthMask[0] == 0x06);
+		frustum_planes(perspective_infinite(fov, 1.5f, 0.1f), depthPlanes);
+		assert(cull_spheres(depthPlanes, depthSpheres, 3, depthMask) == 2 && depthMask[0] == 0x06);
+		(void)depthSpheres;
+		(void)depthMask;
+
+		camera cam;
+		cam.look_at(eye, target, vec3::up);
+		cam.set_projection(matrix4::perspective(fov, 1.5f, 0.1f, 100.f));
+		cam.set_viewport(vector4(0.f, 0.f, 1920.f, 1080.f));
+		assert(cam.is_invertible());
+		const vec3 centre = cam.project(target);
+		assert(std::abs(centre.x - 960.f) < 1e-3f && std::abs(centre.y - 540.f) < 1e-3f);
+
+		// the cached inverse against an inversion of the view projection
+		const vec3 screen(300.f, 200.f, 0.5f);
+		const vec3 world = cam.unproject(screen);
+		bool isInvertible = false;
+		const vec3 ndc(300.f / 960.f - 1.f, 200.f / 540.f - 1.f, 0.5f);
+		vec3 reference;
+		project_points(cam.view_projection().inverse(isInvertible), &ndc, &reference, 1);
+		assert(isInvertible && (world - reference).magnitude() < 1e-4f);
+		assert((cam.project(world) - screen).magnitude() < 1e-2f);
+
+		dcamera precise;
+		precise.set_projection(perspective_reverse_z(1.0, 1.0, 0.1, 10.0));
+		const dvec3 point(0.5, -0.25, -3.0);
+		assert((precise.unproject(precise.project(point)) - point).magnitude() < 1e-12);
+		(void)centre;
+		(void)world;
+	}
+
+	// trs
+	{
+		const quat rotation = quat(0.3f, -0.5f, 0.2f, 0.7f).normalize();
+		const trs source(vec3(4.f, -2.f, 1.f), rotation, vec3(2.f, 0.5f, 3.f));
+		const matrix4 composed = compose(source);
+		const matrix4 reference = matrix4::scale(source.scale) * rotation.matrix() * matrix4::translate(source.position);
+		for (unsigned int i = 0; i < 16; ++i)
+			assert(std::abs(composed.data[i] - reference.data[i]) < 1e-5f);
+		// the rotation of the matrix and of the quaternion agree
+		vec3 rotated;
+		transform_points(rotation.matrix(), &vec3::right, &rotated, 1);
+		assert((rotated - rotation * vec3::right).magnitude() < 1e-6f);
+
+		trs decomposed;
+		const bool decomposable = decompose(composed, decomposed);
+		assert(decomposable);
+		assert((decomposed.position - source.position).magnitude() < 1e-6f);
+		assert((decomposed.scale - source.scale).magnitude() < 1e-5f);
+		assert(std::abs(std::abs(decomposed.rotation.dot(rotation)) - 1.f) < 1e-5f);
+
+		// every branch of the quaternion extraction
+		for (const quat q : { quat(0.f, 0.f, 0.f, 1.f), quat(1.f, 0.f, 0.f, 0.f), quat(0.f, 1.f, 0.f, 0.f), quat(0.f, 0.f, 1.f, 0.f), quat(0.6f, 0.f, 0.8f, 0.f) })
+		{
+			const bool extracted = decompose(compose(trs(vec3::zero, q, vec3::ones)), decomposed);
+			assert(extracted && std::abs(std::abs(decomposed.rotation.dot(q)) - 1.f) < 1e-6f);
+			(void)extracted;
+		}
+
+		// a mirror goes to the x scale
+		const bool mirror = decompose(compose(trs(vec3::zero, rotation, vec3(1.f, -2.f, 1.f))), decomposed);
+		assert(mirror);
+		const matrix4 mirrored = compose(decomposed);
+		const matrix4 expected = compose(trs(vec3::zero, rotation, vec3(1.f, -2.f, 1.f)));
+		for (unsigned int i = 0; i < 16; ++i)
+			assert(std::abs(mirrored.data[i] - expected.data[i]) < 1e-5f);
+		assert(!decompose(matrix4::scale(vec3(1.f, 0.f, 1.f)), decomposed));
+
+		const dtrs a(dvec3(0.0, 0.0, 0.0), dquat(0.0, 0.0, 0.0, 1.0), dvec3(1.0, 1.0, 1.0));
+		const dtrs b(dvec3(2.0, 4.0, 0.0), dquat(0.0, 0.0, -0.7071067811865476, -0.7071067811865476), dvec3(3.0, 1.0, 1.0));
+		const dtrs half = interpolate(a, b, 0.5);
+		assert(half.position == dvec3(1.0, 2.0, 0.0) && half.scale == dvec3(2.0, 1.0, 1.0));
+		// the shortest arc, 45 degrees around z
+		assert(std::abs(half.rotation.z - 0.3826834323650898) < 1e-12 && std::abs(half.rotation.w - 0.9238795325112867) < 1e-12);
+		(void)composed;
+		(void)reference;
+		(void)decomposable;
+		(void)mirror;
+		(void)mirrored;
+		(void)expected;
+		(void)half;
+	}
+
+	// skeletal pose
+	{
+		// a spine with two arms
+		const std::int32_t parents[] = { -1, 0, 1, 1, 3 };
+		const std::int32_t unsorted[] = { -1, 2, 0 };
+		assert(is_parent_first(parents, 5) && !is_parent_first(unsorted, 3));
+
+		trs bind[5];
+		for (unsigned int i = 0; i < 5; ++i)
+			bind[i] = trs(vec3(0.f, 1.f, i * 0.5f), quat(0.f, 0.1f * i, 0.f, 1.f).normalize(), vec3::ones);
+		// the inverse of the model matrices of the bind pose
+		matrix4 inverseBind[5];
+		pose_matrices(bind, parents, nullptr, matrix4::identity, inverseBind, nullptr, 5);
+		for (matrix4& m : inverseBind)
+		{
+			bool isInvertible = false;
+			m = m.inverse(isInvertible);
+			assert(isInvertible);
+		}
+
+		skeleton character;
+		const bool rejected = !character.set(unsorted, inverseBind, 3);
+		assert(rejected);
+		const bool accepted = character.set(parents, inverseBind, 5);
+		assert(accepted && character.joint_count() == 5);
+
+		pose current(character);
+		for (unsigned int i = 0; i < 5; ++i)
+			current.locals()[i] = bind[i];
+		const matrix4 root = matrix4::translate(vec3(10.f, 0.f, 0.f));
+		current.update(root);
+		// in the bind pose the palette is the root placement
+		for (unsigned int i = 0; i < 5; ++i)
+			for (unsigned int k = 0; k < 16; ++k)
+				assert(std::abs(current.palette()[i].data[k] - root.data[k]) < 1e-5f);
+
+		current.locals()[3].rotation = quat(0.f, 0.f, 0.3826834f, 0.9238795f);
+		current.update();
+		const matrix4 hand = compose(current.locals()[4]) * compose(current.locals()[3]) * compose(current.locals()[1]) * compose(current.locals()[0]);
+		for (unsigned int k = 0; k < 16; ++k)
+			assert(std::abs(current.model()[4].data[k] - hand.data[k]) < 1e-5f);
+		(void)rejected;
+		(void)accepted;
+		(void)hand;
+	}
+
+	// parallel batches
+	{
+		thread_pool pool(4);
+		assert(pool.concurrency() == 4);
+		set_executor(&pool);
+		assert(&current_executor() == &pool);
+
+		// every index once, nested loops run inline
+		std::vector<std::atomic<int>> hits(10000);
+		parallel_for(hits.size(), 100, [&hits](const std::size_t begin, const std::size_t end)
+			{
+				parallel_for(end - begin, 10, [&hits, begin](const std::size_t b, const std::size_t e)
+					{
+						for (std::size_t i = b; i < e; ++i)
+							hits[begin + i].fetch_add(1);
+					});
+			});
+		for (const std::atomic<int>& hit : hits)
+		{
+			assert(hit.load() == 1);
+			(void)hit;
+		}
+
+		const std::size_t chunk = chunk_size(1000000, sizeof(vector4), 8);
+		assert(chunk % 8 == 0 && chunk * sizeof(vector4) <= std::max<std::size_t>(cache_size() / 2, 16 * 1024) + 8 * sizeof(vector4));
+		assert(chunk_size(10, sizeof(vector3)) >= 10);
+
+		const std::size_t count = 100001;
+		std::vector<vector3> points(count), serial(count), parallel(count);
+		for (std::size_t i = 0; i < count; ++i)
+			points[i] = vec3(i * 0.01f, 1.f - i * 0.02f, 3.f);
+		const matrix4 matrix = matrix4::rotate_y(30.f) * matrix4::translate(vec3(1.f, 2.f, 3.f));
+		transform_points(matrix, points.data(), serial.data(), count);
+		parallel_transform_points(matrix, points.data(), parallel.data(), count);
+		assert(serial == parallel);
+		parallel_transform_points(affine3(matrix), points.data(), parallel.data(), count);
+		assert((parallel[count - 1] - serial[count - 1]).magnitude() < 1e-3f);
+		normalize(serial.data(), count);
+		parallel_normalize(parallel.data(), count);
+		assert((parallel[777] - serial[777]).magnitude() < 1e-6f);
+
+		vector4 planes[6];
+		frustum_planes(matrix4::orthographic(-100.f, 100.f, -100.f, 100.f, -100.f, 100.f), planes);
+		std::vector<vector4> spheres(count);
+		for (std::size_t i = 0; i < count; ++i)
+			spheres[i] = vector4(i * 0.003f - 150.f, 0.f, 0.f, 1.f);
+		std::vector<std::uint8_t> serialMask(mask_size(count)), parallelMask(mask_size(count));
+		const std::size_t visible = cull_spheres(planes, spheres.data(), count, serialMask.data());
+		const std::size_t parallelVisible = parallel_cull_spheres(planes, spheres.data(), count, parallelMask.data());
+		assert(parallelVisible == visible && serialMask == parallelMask);
+
+		std::vector<math::transform> transforms(5000);
+		for (std::size_t i = 0; i < transforms.size(); ++i)
+			transforms[i].position = vec3(i * 1.f, 0.f, 0.f);
+		parallel_update(transforms.data(), transforms.size());
+		assert(transforms[4321].matrix().m30 == 4321.f);
+
+		set_executor(nullptr);
+		assert(&current_executor() == &default_executor());
+		(void)chunk;
+		(void)visible;
+		(void)parallelVisible;
+	}
+
+	// instrumentation, the counters but the transform ones and the timers need VDTMATH_PROFILE
+	{
+		chrome_trace_sink trace;
+		set_profile_sink(&trace);
+		reset_profile_counters();
+
+		const matrix4 a = matrix4::rotate_x(30.f);
+		const matrix4 b = matrix4::translate(vec3(1.f, 2.f, 3.f));
+		bool invertible = false;
+		const matrix4 product = (a * b).inverse(invertible);
+		matrix4 batch[4] = { a, b, product, a };
+		multiply(batch, batch, batch, 4);
+
+		math::transform t;
+		t.update();
+		t.update();
+		t.isStatic = true;
+		t.update();
+		t.update();
+
+		// the counts of the threads that have exited remain
+		std::thread([&a, &b]() { const matrix4 c = a * b; (void)c; }).join();
+
+		std::size_t callbacks = 0;
+		callback_sink callback([](const profile_event& event, void* context)
+			{
+				assert(std::strcmp(event.name, "normalize") == 0 && event.count == 3);
+				(void)event;
+				++*static_cast<std::size_t*>(context);
+			}, &callbacks);
+		set_profile_sink(&callback);
+		vec3 vectors[3] = { vec3::up, vec3::right, vec3::forward };
+		normalize(vectors, 3);
+		set_profile_sink(nullptr);
+		normalize(vectors, 3);
+
+		assert(profile_count(profile_counter::transform_rebuild) == 1);
+		assert(profile_count(profile_counter::transform_unchanged_skip) == 2);
+		assert(profile_count(profile_counter::transform_static_skip) == 1);
+#if defined(VDTMATH_PROFILE)
+		// a * b, the batch, the two products of the rebuild and the thread
+		assert(profile_count(profile_counter::matrix_multiply) == 1 + 4 + 2 + 1);
+		assert(profile_count(profile_counter::matrix_inverse) == 1);
+		assert(callbacks == 1);
+
+		std::ostringstream json;
+		trace.write(json);
+		assert(trace.size() == 1);
+		assert(json.str().find("{\"traceEvents\":[") == 0);
+		assert(json.str().find("\"name\":\"multiply\",\"cat\":\"vdtmath\",\"ph\":\"X\"") != std::string::npos);
+		assert(json.str().find("\"args\":{\"count\":4}") != std::string::npos);
+#else
+		assert(callbacks == 0 && trace.size() == 0);
+#endif
+		reset_profile_counters();
+		assert(profile_count(profile_counter::matrix_multiply) == 0);
+		assert(std::strcmp(to_string(profile_counter::transform_static_skip), "transform_static_skip") == 0);
+
+		// the updates of the worker threads are summed
+		std::vector<math::transform> transforms(5000);
+		for (std::size_t i = 0; i < transforms.size(); ++i)
+			transforms[i].isStatic = i % 2 == 0;
+		parallel_update(transforms.data(), transforms.size());
+		parallel_update(transforms.data(), transforms.size());
+		transforms[1].position = vec3(1.f, 0.f, 0.f);
+		parallel_update(transforms.data(), transforms.size());
+		const transform_statistics statistics = transform_telemetry();
+		assert(statistics.rebuilds == 5001);
+		assert(statistics.static_skips == 5000);
+		assert(statistics.unchanged_skips == 2500 + 2499);
+		std::uint64_t histogram = 0;
+		for (const std::uint64_t bucket : statistics.rebuild_histogram)
+			histogram += bucket;
+#if defined(VDTMATH_PROFILE)
+		assert(histogram == statistics.rebuilds && statistics.rebuild_time > 0);
+#else
+		assert(histogram == 0 && statistics.rebuild_time == 0);
+#endif
+		assert(rebuild_bound(0) == 32 && rebuild_bound(1) == 64);
+		(void)histogram;
+		(void)statistics;
+	}
+
+	// batch kernels, every supported simd level
+	{
+		const matrix4 a(
+			5.f, 7.f, 9.f, 10.f,
+			2.f, 3.f, 3.f, 8.f,
+			8.f, 10.f, 2.f, 3.f,
+			3.f, 3.f, 4.f, 8.f
+		);
+		const matrix4 b(
+			3.f, 10.f, 12.f, 18.f,
+			12.f, 1.f, 4.f, 9.f,
+			9.f, 10.f, 12.f, 2.f,
+			3.f, 12.f, 4.f, 10.f
+		);
+		const matrix4 transform = matrix4::scale(vec3(2.f, 2.f, 2.f)) * matrix4::translate(vec3(1.f, 2.f, 3.f));
+
+		vector4 planes[6];
+		frustum_planes(matrix4::orthographic(-10.f, 10.f, -10.f, 10.f, -10.f, 10.f), planes);
+
+		// the deterministic mode binds at most the sse2 kernels
+#if defined(VDTMATH_DETERMINISTIC)
+		const simd_level supported = std::min(supported_simd_level(), simd_level::sse2);
+#else
+		const simd_level supported = supported_simd_level();
+#endif
+		for (const simd_level level : { simd_level::none, simd_level::sse2, simd_level::avx2, simd_level::avx512 })
+		{
+			const bool accepted = set_simd_level(level);
+			assert(accepted == (level <= supported));
+			if (!accepted) continue;
+			assert(active_simd_level() == level);
+
+			matrix4 products[3] = { a, a, a };
+			const matrix4 others[3] = { b, b, b };
+			multiply(products, others, products, 3);
+			assert(products[2] == a * b);
+			multiply(a, others, products, 3);
+			assert(products[1] == a * b);
+
+			// aligned storage
+			aligned_array<matrix4> alignedProducts(5, a);
+			const aligned_array<matrix4> alignedOthers(5, b);
+			multiply(alignedProducts.data(), alignedOthers.data(), alignedProducts.data(), 5);
+			assert(alignedProducts[4] == a * b);
+			multiply(a, alignedOthers.data(), alignedProducts.data(), 5);
+			assert(alignedProducts[0] == a * b);
+
+			vec3 points[5] = { vec3(0.f, 0.f, 0.f), vec3(1.f, 1.f, 1.f), vec3(-1.f, 0.f, 2.f), vec3(3.f, 0.f, 0.f), vec3(0.f, 0.f, 4.f) };
+			transform_points(transform, points, points, 5);
+			assert(points[0] == vec3(1.f, 2.f, 3.f));
+			assert(points[2] == vec3(-1.f, 2.f, 7.f));
+			assert(points[4] == vec3(1.f, 2.f, 11.f));
+
+			affine3 affines[3] = { affine3(a), affine3(a), affine3(a) };
+			const affine3 moves[3] = { affine3(transform), affine3(transform), affine3(transform) };
+			multiply(affines, moves, affines, 3);
+			assert(affines[2] == affine3(a) * affine3(transform));
+
+			vec3 affinePoints[9];
+			for (unsigned int i = 0; i < 9; ++i)
+				affinePoints[i] = vec3(i * 1.f, 0.f, 1.f);
+			transform_points(affine3(transform), affinePoints, affinePoints, 9);
+			assert(affinePoints[0] == vec3(1.f, 2.f, 5.f) && affinePoints[8] == vec3(17.f, 2.f, 5.f));
+
+			vec3 normals[11];
+			for (unsigned int i = 0; i < 11; ++i)
+				normals[i] = vec3(1.f, 1.f, i * 1.f);
+			transform_normals(normal_matrix(matrix4::scale(vec3(2.f, 4.f, 1.f))), normals, normals, 11);
+			assert(normals[0] == vec3(0.5f, 0.25f, 0.f));
+			assert(normals[9] == vec3(0.5f, 0.25f, 9.f) && normals[10] == vec3(0.5f, 0.25f, 10.f));
+
+			vec3 vectors[11];
+			for (unsigned int i = 0; i < 11; ++i)
+				vectors[i] = vec3(0.f, i * 2.f, 0.f);
+			normalize(vectors, 11);
+			assert(vectors[0] == vec3::zero);
+			assert(vectors[7] == vec3::up && vectors[10] == vec3::up);
+
+			vector4 spheres[10];
+			for (unsigned int i = 0; i < 10; ++i)
+				spheres[i] = vector4(i * 3.f, 0.f, 0.f, 1.f);
+			std::uint8_t mask[2] = {};
+			assert(cull_spheres(planes, spheres, 10, mask) == 4);
+			assert(mask[0] == 0x0f && mask[1] == 0x00);
+
+			float scalars[13];
+			std::uint16_t halves[13];
+			for (unsigned int i = 0; i < 13; ++i)
+				scalars[i] = i * 0.3f - 2.f;
+			encode_half(scalars, halves, 13);
+			decode_half(halves, scalars, 13);
+			assert(halves[12] == to_half(12 * 0.3f - 2.f) && scalars[0] == -2.f && scalars[5] == from_half(to_half(5 * 0.3f - 2.f)));
+			assert(leaf_encode_half(scalars[7]) == halves[7]);
+
+			// the NaN lanes of the blocks, with payloads and signs
+			float nans[16];
+			std::uint16_t nanHalves[16];
+			const std::uint32_t nanBits[4] = { 0x7fc00000u, 0xff812345u, 0x7f800001u, 0xffffffffu };
+			const std::uint16_t halfNans[4] = { 0x7c01, 0xfe00, 0x7fff, 0xfd23 };
+			for (unsigned int i = 0; i < 16; ++i)
+			{
+				nans[i] = i * 0.5f - 3.f;
+				nanHalves[i] = to_half(nans[i]);
+			}
+			for (unsigned int i = 0; i < 4; ++i)
+			{
+				std::memcpy(&nans[i * 4 + 1], &nanBits[i], sizeof(float));
+				nanHalves[i * 4 + 2] = halfNans[i];
+			}
+			encode_half(nans, halves, 13);
+			for (unsigned int i = 0; i < 13; ++i)
+				assert(halves[i] == to_half(nans[i]));
+			float decoded[16];
+			decode_half(nanHalves, decoded, 16);
+			for (unsigned int i = 0; i < 16; ++i)
+			{
+				const float expected = from_half(nanHalves[i]);
+				assert(std::memcmp(&decoded[i], &expected, sizeof(float)) == 0);
+				(void)expected;
+			}
+			(void)nanBits;
+			(void)halfNans;
+
+			vec3 directions[11];
+			std::uint32_t octahedral[11];
+			for (unsigned int i = 0; i < 11; ++i)
+				directions[i] = vec3(i - 5.f, 1.f, 4.f - i).normalize();
+			encode_octahedral(directions, octahedral, 11);
+			assert(octahedral[3] == encode_octahedral32(directions[3]) && octahedral[10] == encode_octahedral32(directions[10]));
+			decode_octahedral(octahedral, directions, 11);
+			assert((directions[9] - decode_octahedral(octahedral[9])).magnitude() < 1e-6f);
+
+			const position_quantizer quantizer(vec3(-10.f, -10.f, -10.f), vec3(10.f, 10.f, 10.f));
+			packed_position packed[10];
+			encode_positions(quantizer, affinePoints, packed, 9);
+			assert(packed[8].x == quantizer.encode(affinePoints[8]).x);
+			decode_positions(quantizer, packed, affinePoints, 9);
+			assert(std::abs(affinePoints[0].z - 5.f) <= quantizer.error().z * 1.01f);
+
+			frame_arena arena(256);
+			vector4* const alignedSpheres = arena.allocate<vector4>(10);
+			for (unsigned int i = 0; i < 10; ++i)
+				alignedSpheres[i] = spheres[i];
+			assert(cull_spheres(planes, alignedSpheres, 10, mask) == 4);
+			assert(mask[0] == 0x0f && mask[1] == 0x00);
+
+			// the batch tests of mask.h against the single tests,
+			// full mask bytes and a tail
+			const circle center(0.3f, -0.2f, 2.1f);
+			circle circles[21];
+			vec2 circlePoints[21];
+			for (unsigned int i = 0; i < 21; ++i)
+			{
+				circles[i] = circle((i * 7 % 11) * 0.45f - 2.2f, (i * 5 % 13) * 0.35f - 2.1f, (i % 4) * 0.7f + 0.1f);
+				circlePoints[i] = vec2((i * 3 % 17) * 0.3f - 2.4f, (i * 11 % 7) * 0.6f - 1.9f);
+			}
+			std::uint8_t circleMasks[3][3] = {};
+			std::uint32_t circleIndices[3][21] = {};
+			const std::size_t circleHits[3] = {
+				center.intersects(circles, 21, circleMasks[0]),
+				center.contains(circles, 21, circleMasks[1]),
+				center.contains(circlePoints, 21, circleMasks[2])
+			};
+			assert(center.intersects(circles, 21, circleIndices[0]) == circleHits[0]);
+			assert(center.contains(circles, 21, circleIndices[1]) == circleHits[1]);
+			assert(center.contains(circlePoints, 21, circleIndices[2]) == circleHits[2]);
+			std::size_t circleCounts[3] = {};
+			for (unsigned int i = 0; i < 21; ++i)
+			{
+				const bool tests[3] = { center.intersects(circles[i]), center.contains(circles[i]), center.contains(circlePoints[i]) };
+				for (unsigned int k = 0; k < 3; ++k)
+				{
+					assert(mask_test(circleMasks[k], i) == tests[k]);
+					if (tests[k]) assert(circleIndices[k][circleCounts[k]++] == i);
+				}
+				(void)tests;
+			}
+			assert(circleCounts[0] == circleHits[0] && circleCounts[1] == circleHits[1] && circleCounts[2] == circleHits[2]);
+			assert(circleHits[0] > 0 && circleHits[0] < 21 && circleHits[1] > 0 && circleHits[2] > 0 && circleHits[2] < 21);
+
+			// more rectangles than a tile, the blocks and the tails of the overlaps
+			rectangle_array boxes;
+			for (unsigned int i = 0; i < 300; ++i)
+				boxes.push_back(rectangle((i * 37 % 101) * 0.5f, (i * 53 % 89) * 0.5f, (i % 5) * 0.6f + 0.2f, (i % 3) * 0.8f + 0.2f));
+			std::uint8_t boxMask[mask_size(300)] = {};
+			const std::size_t boxHits = boxes.intersects(rectangle(20.f, 20.f, 6.f, 4.f), boxMask);
+			std::size_t boxCount = 0;
+			for (unsigned int i = 0; i < 300; ++i)
+			{
+				const bool overlap = boxes.min_x[i] <= 26.f && boxes.max_x[i] >= 14.f && boxes.min_y[i] <= 24.f && boxes.max_y[i] >= 16.f;
+				assert(mask_test(boxMask, i) == overlap);
+				boxCount += overlap;
+			}
+			assert(boxHits == boxCount && boxHits > 0);
+			const std::size_t pointHits = boxes.contains(vec2(20.1f, 20.3f), boxMask);
+			std::size_t pointCount = 0;
+			for (unsigned int i = 0; i < 300; ++i)
+			{
+				const bool inside = boxes.min_x[i] <= 20.1f && boxes.max_x[i] >= 20.1f && boxes.min_y[i] <= 20.3f && boxes.max_y[i] >= 20.3f;
+				assert(mask_test(boxMask, i) == inside);
+				pointCount += inside;
+			}
+			assert(pointHits == pointCount);
+			std::vector<rectangle_array::pair_t> boxPairs, expectedPairs;
+			boxes.overlaps(boxPairs);
+			for (std::uint32_t i = 0; i < 300; ++i)
+			{
+				for (std::uint32_t j = i + 1; j < 300; ++j)
+				{
+					if (boxes.min_x[j] <= boxes.max_x[i] && boxes.max_x[j] >= boxes.min_x[i] && boxes.min_y[j] <= boxes.max_y[i] && boxes.max_y[j] >= boxes.min_y[i])
+						expectedPairs.emplace_back(i, j);
+				}
+			}
+			std::sort(boxPairs.begin(), boxPairs.end());
+			assert(boxPairs == expectedPairs && !expectedPairs.empty());
+			boxPairs.clear();
+			boxes.overlaps(boxes, boxPairs, 10, 280);
+			std::size_t crossPairs = 0;
+			for (const rectangle_array::pair_t& pair : expectedPairs)
+				crossPairs += (pair.first >= 10 && pair.first < 280) + (pair.second >= 10 && pair.second < 280);
+			// every row overlaps itself
+			assert(boxPairs.size() == crossPairs + 270);
+			(void)circleIndices;
+			(void)circleHits;
+			(void)circleCounts;
+			(void)boxHits;
+			(void)pointHits;
+			(void)crossPairs;
+
+			// a block and a tail of channels
+			std::vector<vector3_curve> curves(70, vector3_curve(interpolation::catmull_rom));
+			std::vector<const vector3_curve*> channels;
+			for (unsigned int i = 0; i < curves.size(); ++i)
+			{
+				for (unsigned int k = 0; k < 4; ++k)
+					curves[i].add_key(k + i * 0.01f, vec3(i * 1.f, k * 2.f, (i + k) % 3 * 1.f));
+				channels.push_back(&curves[i]);
+			}
+			std::vector<curve_cursor> cursors(curves.size());
+			std::vector<vec3> sampled(curves.size());
+			for (const float time : { 0.5f, 1.7f, 2.9f })
+			{
+				evaluate(time, channels.data(), cursors.data(), sampled.data(), curves.size());
+				for (unsigned int i = 0; i < curves.size(); ++i)
+					assert((sampled[i] - curves[i].evaluate(time)).magnitude() < 1e-5f);
+			}
+			evaluate(1.2f, channels.data(), nullptr, sampled.data(), curves.size());
+			assert((sampled[69] - curves[69].evaluate(1.2f)).magnitude() < 1e-5f);
+
+			camera cam;
+			cam.look_at(vec3(0.f, 3.f, 10.f), vec3::zero, vec3::up);
+			cam.set_projection(perspective_infinite_reverse_z(radians(70.f), 1.f, 0.5f));
+			cam.set_viewport(vector4(0.f, 0.f, 800.f, 800.f));
+			vec3 screens[7], unprojected[7];
+			for (unsigned int i = 0; i < 7; ++i)
+				screens[i] = vec3(i * 100.f, 700.f - i * 50.f, 0.1f * (i + 1));
+			cam.unproject(screens, unprojected, 7);
+			assert((unprojected[5] - cam.unproject(screens[5])).magnitude() < 1e-4f);
+			cam.project(unprojected, unprojected, 7);
+			for (unsigned int i = 0; i < 7; ++i)
+				assert((unprojected[i] - screens[i]).magnitude() < 1e-2f);
+
+			trs from[11], to[11], blended[11];
+			float weights[11];
+			for (unsigned int i = 0; i < 11; ++i)
+			{
+				from[i] = trs(vec3(i * 1.f, 0.f, 2.f), quat(0.1f * i, 0.2f, -0.3f, 0.9f).normalize(), vec3(1.f, 1.f, 1.f + i));
+				to[i] = trs(vec3(0.f, i * 2.f, 2.f), quat(-0.3f, 0.1f * i, 0.5f, -0.6f).normalize(), vec3(2.f, 1.f, 1.f));
+				weights[i] = i / 10.f;
+			}
+			blend(from, to, weights, blended, 11);
+			for (unsigned int i = 0; i < 11; ++i)
+			{
+				const trs expected = interpolate(from[i], to[i], weights[i]);
+				assert((blended[i].position - expected.position).magnitude() < 1e-5f);
+				assert((blended[i].scale - expected.scale).magnitude() < 1e-5f);
+				assert(std::abs(blended[i].rotation.dot(expected.rotation) - 1.f) < 1e-5f);
+				(void)expected;
+			}
+			blend(from, to, 0.25f, from, 11);
+			assert((from[9].position - vec3(6.75f, 4.5f, 2.f)).magnitude() < 1e-5f);
+
+			// a chain, in aligned and unaligned storage
+			std::vector<std::int32_t> chain(9);
+			for (unsigned int i = 0; i < 9; ++i)
+				chain[i] = static_cast<std::int32_t>(i) - 1;
+			aligned_array<matrix4> binds(9), models(9), palettes(9);
+			std::vector<matrix4> unalignedStorage(10);
+			matrix4* const unaligned = reinterpret_cast<matrix4*>(reinterpret_cast<float*>(unalignedStorage.data()) + 1);
+			for (unsigned int i = 0; i < 9; ++i)
+				binds[i] = compose(trs(vec3(0.f, -1.f * i, 0.f), quat::identity, vec3::ones));
+			pose_matrices(from, chain.data(), binds.data(), matrix4::identity, models.data(), palettes.data(), 9);
+			pose_matrices(from, chain.data(), binds.data(), matrix4::identity, unaligned, nullptr, 9);
+			matrix4 expected = matrix4::identity;
+			for (unsigned int i = 0; i < 9; ++i)
+			{
+				expected = compose(from[i]) * expected;
+				const matrix4 skin = binds[i] * expected;
+				for (unsigned int k = 0; k < 16; ++k)
+				{
+					assert(std::abs(models[i].data[k] - expected.data[k]) <= 1e-4f * (1.f + std::abs(expected.data[k])));
+					assert(std::abs(unaligned[i].data[k] - models[i].data[k]) <= 1e-4f * (1.f + std::abs(expected.data[k])));
+					assert(std::abs(palettes[i].data[k] - skin.data[k]) <= 1e-4f * (1.f + std::abs(skin.data[k])));
+				}
+				(void)skin;
+			}
+			(void)mask;
+		}
+		set_simd_level(supported);
+	}
+
+	// golden hashes of the deterministic functions and of the products,
+	// determinants and kernels, the same on every compiler and cpu when
+	// the multiplications and additions are not fused, see deterministic.h
+#if defined(VDTMATH_DETERMINISTIC) || !defined(__FMA__)
+	{
+		// fnv-1a of the bytes
+		const auto hash = [](std::uint64_t h, const void* data, const std::size_t size)
+		{
+			const unsigned char* const bytes = static_cast<const unsigned char*>(data);
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				h ^= bytes[i];
+				h *= 1099511628211ull;
+			}
+			return h;
+		};
+		const std::uint64_t basis = 14695981039346656037ull;
+
+		std::uint64_t functions = basis;
+		for (int i = -1000; i <= 1000; ++i)
+		{
+			const double x = i * 0.0123456789;
+			const double d[5] = { deterministic::sin(x), deterministic::cos(x * 1000.0), deterministic::tan(x), deterministic::acos(i / 1000.0), deterministic::sqrt(x * x) };
+			const float f = static_cast<float>(x);
+			const float s[4] = { deterministic::sin(f), deterministic::cos(f * 3.f), deterministic::acos(i / 1000.f), deterministic::sqrt(f * f) };
+			functions = hash(functions, d, sizeof(d));
+			functions = hash(functions, s, sizeof(s));
+		}
+		assert(deterministic::sin(0.f) == 0.f && deterministic::cos(0.0) == 1.0);
+		assert(std::abs(deterministic::sin(radians(30.f)) - 0.5f) < 1e-7f);
+		assert(std::abs(deterministic::acos(-1.0) - 3.14159265358979323846) < 1e-15);
+		assert(functions == 0xe0af4fab4d295d5cull);
+
+		std::uint64_t products = basis;
+		std::vector<matrix4> left(64), right(64), results(64);
+		std::vector<vector3> points(64), transformed(64);
+		for (unsigned int i = 0; i < 64; ++i)
+		{
+			for (unsigned int k = 0; k < 16; ++k)
+			{
+				left[i].data[k] = static_cast<float>((i * 7 + k * 13) % 17) * 0.37f - 3.f;
+				right[i].data[k] = static_cast<float>((i * 5 + k * 11) % 19) * 0.29f - 2.5f;
+			}
+			points[i] = vec3(i * 0.1f, 1.f - i * 0.3f, i * 0.7f - 5.f);
+
+			const matrix4 product = left[i] * right[i];
+			const float determinant = product.determinant();
+			const matrix3 minor(left[i].data[0], left[i].data[1], left[i].data[2], left[i].data[4], left[i].data[5], left[i].data[6], left[i].data[8], left[i].data[9], left[i].data[10]);
+			const float minorDeterminant = minor.determinant();
+			products = hash(products, &product, sizeof(product));
+			products = hash(products, &determinant, sizeof(determinant));
+			products = hash(products, &minorDeterminant, sizeof(minorDeterminant));
+		}
+		assert(products == 0xc0cf8ef755c4c79full);
+
+		// the scalar and the sse2 kernels
+		const simd_level active = active_simd_level();
+		for (const simd_level level : { simd_level::none, simd_level::sse2 })
+		{
+			if (!set_simd_level(level)) continue;
+			std::uint64_t kernels = basis;
+			multiply(left.data(), right.data(), results.data(), 64);
+			kernels = hash(kernels, results.data(), 64 * sizeof(matrix4));
+			transform_points(left[3], points.data(), transformed.data(), 64);
+			kernels = hash(kernels, transformed.data(), 64 * sizeof(vector3));
+			normalize(transformed.data(), 64);
+			kernels = hash(kernels, transformed.data(), 64 * sizeof(vector3));
+			assert(kernels == 0xa728fc49b49a65eeull);
+			for (unsigned int i = 0; i < 64; ++i)
+			{
+				const matrix4 product = left[i] * right[i];
+				assert(std::memcmp(&results[i], &product, sizeof(matrix4)) == 0);
+				(void)product;
+			}
+		}
+		set_simd_level(active);
+
+#if defined(VDTMATH_DETERMINISTIC)
+		// the library uses the deterministic functions
+		std::uint64_t rotations = basis;
+		for (int i = 0; i < 360; i += 7)
+		{
+			const matrix4 r[4] = {
+				matrix4::rotate_x(static_cast<float>(i)),
+				matrix4::rotate_y(static_cast<float>(i)),
+				matrix4::rotate(vec3(0.6f, 0.f, 0.8f), static_cast<float>(i)),
+				matrix4::perspective(radians(static_cast<float>(i % 120 + 30)), 1.5f, 0.1f, 100.f)
+			};
+			rotations = hash(rotations, r, sizeof(r));
+		}
+		assert(rotations == 0x876f498c50b740bcull);
+#endif
 	}
-}
\ No newline at end of file
+#endif
+}
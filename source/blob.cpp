@@ -0,0 +1,454 @@
+#include <vdtmath/blob.h>
+
+#include <cstring>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+namespace math
+{
+	namespace detail
+	{
+		constexpr std::uint32_t blob_endian = 0x01020304;
+		constexpr std::uint32_t blob_endian_swapped = 0x04030201;
+
+		VDTMATH_API std::size_t blob_find(const blob_array* arrays, const std::size_t count, const char* name)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				if (std::strncmp(arrays[i].name, name, blob_name_size) == 0)
+					return i;
+			}
+			return count;
+		}
+
+		VDTMATH_API void swap_bytes(void* data, const std::size_t size, const std::size_t scalar_size)
+		{
+			unsigned char* bytes = static_cast<unsigned char*>(data);
+			for (std::size_t i = 0; i + scalar_size <= size; i += scalar_size)
+			{
+				for (std::size_t a = i, b = i + scalar_size - 1; a < b; ++a, --b)
+				{
+					const unsigned char byte = bytes[a];
+					bytes[a] = bytes[b];
+					bytes[b] = byte;
+				}
+			}
+		}
+
+		template <typename T>
+		inline void swap_field(T& value)
+		{
+			swap_bytes(&value, sizeof(T), sizeof(T));
+		}
+
+		VDTMATH_API bool seek(std::FILE* file, const std::uint64_t offset)
+		{
+#if defined(_WIN32)
+			return _fseeki64(file, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+			return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+		}
+
+		// the position is left at the end of the file
+		VDTMATH_API bool file_size(std::FILE* file, std::uint64_t& size)
+		{
+#if defined(_WIN32)
+			if (_fseeki64(file, 0, SEEK_END) != 0) return false;
+			const __int64 end = _ftelli64(file);
+#else
+			if (fseeko(file, 0, SEEK_END) != 0) return false;
+			const off_t end = ftello(file);
+#endif
+			if (end < 0) return false;
+			size = static_cast<std::uint64_t>(end);
+			return true;
+		}
+
+		// the table entries are checked against the size of the blob
+		VDTMATH_API bool blob_validate(const blob_array* arrays, const std::size_t count, const std::uint64_t size)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const blob_array& array = arrays[i];
+				if (array.name[blob_name_size - 1] != '\0'
+					|| array.element_size == 0
+					|| array.scalar_size == 0
+					|| array.element_size % array.scalar_size != 0
+					|| array.offset % blob_alignment != 0
+					|| array.offset > size
+					|| array.count > (size - array.offset) / array.element_size)
+					return false;
+			}
+			return true;
+		}
+	}
+
+	// blob_writer
+
+	VDTMATH_API blob_writer::blob_writer()
+		: m_file(nullptr)
+		, m_arrays()
+		, m_offset(0)
+		, m_inArray(false)
+		, m_failed(false)
+	{
+
+	}
+
+	VDTMATH_API blob_writer::~blob_writer()
+	{
+		close();
+	}
+
+	VDTMATH_API bool blob_writer::open(const char* path)
+	{
+		close();
+		m_file = std::fopen(path, "wb");
+		if (m_file == nullptr) return false;
+
+		m_arrays.clear();
+		m_offset = 0;
+		m_inArray = false;
+		m_failed = false;
+
+		// patched by close
+		const blob_header header{};
+		return write_bytes(&header, sizeof(header));
+	}
+
+	VDTMATH_API bool blob_writer::close()
+	{
+		if (m_file == nullptr) return false;
+
+		if (m_inArray) end();
+
+		pad();
+		const std::uint64_t tableOffset = m_offset;
+		if (!m_arrays.empty())
+		{
+			write_bytes(m_arrays.data(), m_arrays.size() * sizeof(blob_array));
+		}
+
+		blob_header header{};
+		std::memcpy(header.magic, "VDTM", 4);
+		header.endian = detail::blob_endian;
+		header.version = blob_version;
+		header.array_count = static_cast<std::uint32_t>(m_arrays.size());
+		header.table_offset = tableOffset;
+		header.size = m_offset;
+		m_failed |= !detail::seek(m_file, 0);
+		m_failed |= std::fwrite(&header, sizeof(header), 1, m_file) != 1;
+		m_failed |= std::fclose(m_file) != 0;
+		m_file = nullptr;
+		return !m_failed;
+	}
+
+	VDTMATH_API bool blob_writer::end()
+	{
+		assert(m_inArray);
+		m_inArray = false;
+		return !m_failed;
+	}
+
+	VDTMATH_API bool blob_writer::begin_array(const char* name, const std::uint32_t type, const std::uint32_t elementSize, const std::uint32_t scalarSize)
+	{
+		assert(m_file != nullptr && !m_inArray);
+		assert(std::strlen(name) < blob_name_size);
+		if (m_file == nullptr || !pad()) return false;
+
+		blob_array array{};
+		std::strncpy(array.name, name, blob_name_size - 1);
+		array.type = type;
+		array.element_size = elementSize;
+		array.scalar_size = scalarSize;
+		array.count = 0;
+		array.offset = m_offset;
+		m_arrays.push_back(array);
+		m_inArray = true;
+		return true;
+	}
+
+	VDTMATH_API bool blob_writer::append_bytes(const void* data, const std::size_t size)
+	{
+		if (!write_bytes(data, size)) return false;
+		blob_array& array = m_arrays.back();
+		array.count += size / array.element_size;
+		return true;
+	}
+
+	VDTMATH_API bool blob_writer::write_bytes(const void* data, const std::size_t size)
+	{
+		if (m_failed) return false;
+		if (size > 0 && std::fwrite(data, 1, size, m_file) != size)
+		{
+			m_failed = true;
+			return false;
+		}
+		m_offset += size;
+		return true;
+	}
+
+	VDTMATH_API bool blob_writer::pad()
+	{
+		static const unsigned char zeros[blob_alignment] = {};
+		const std::size_t padding = static_cast<std::size_t>((blob_alignment - m_offset % blob_alignment) % blob_alignment);
+		return write_bytes(zeros, padding);
+	}
+
+	// blob_reader
+
+	VDTMATH_API blob_reader::blob_reader()
+		: m_file(nullptr)
+		, m_arrays()
+		, m_swapped(false)
+	{
+
+	}
+
+	VDTMATH_API blob_reader::~blob_reader()
+	{
+		close();
+	}
+
+	VDTMATH_API bool blob_reader::open(const char* path)
+	{
+		close();
+		m_file = std::fopen(path, "rb");
+		if (m_file == nullptr) return false;
+
+		blob_header header;
+		if (std::fread(&header, sizeof(header), 1, m_file) != 1
+			|| std::memcmp(header.magic, "VDTM", 4) != 0
+			|| (header.endian != detail::blob_endian && header.endian != detail::blob_endian_swapped))
+		{
+			close();
+			return false;
+		}
+
+		m_swapped = header.endian == detail::blob_endian_swapped;
+		if (m_swapped)
+		{
+			detail::swap_field(header.version);
+			detail::swap_field(header.array_count);
+			detail::swap_field(header.table_offset);
+			detail::swap_field(header.size);
+		}
+
+		// the table is checked before its allocation, a corrupted
+		// array_count would ask for gigabytes
+		std::uint64_t size = 0;
+		if (header.version == 0 || header.version > blob_version
+			|| !detail::file_size(m_file, size)
+			|| header.size > size
+			|| header.table_offset % blob_alignment != 0
+			|| header.table_offset > header.size
+			|| header.array_count > (header.size - header.table_offset) / sizeof(blob_array))
+		{
+			close();
+			return false;
+		}
+
+		m_arrays.resize(header.array_count);
+		if (!detail::seek(m_file, header.table_offset)
+			|| (!m_arrays.empty() && std::fread(m_arrays.data(), sizeof(blob_array), m_arrays.size(), m_file) != m_arrays.size()))
+		{
+			close();
+			return false;
+		}
+
+		if (m_swapped)
+		{
+			for (blob_array& array : m_arrays)
+			{
+				detail::swap_field(array.type);
+				detail::swap_field(array.element_size);
+				detail::swap_field(array.scalar_size);
+				detail::swap_field(array.count);
+				detail::swap_field(array.offset);
+			}
+		}
+
+		if (!detail::blob_validate(m_arrays.data(), m_arrays.size(), header.size))
+		{
+			close();
+			return false;
+		}
+		return true;
+	}
+
+	VDTMATH_API void blob_reader::close()
+	{
+		if (m_file)
+		{
+			std::fclose(m_file);
+			m_file = nullptr;
+		}
+		m_arrays.clear();
+		m_swapped = false;
+	}
+
+	VDTMATH_API bool blob_reader::read_elements(const std::size_t index, const std::uint64_t first, const std::size_t count, void* values)
+	{
+		const blob_array& array = m_arrays[index];
+		assert(first + count <= array.count);
+		if (m_file == nullptr || first + count > array.count) return false;
+		if (count == 0) return true;
+
+		const std::size_t size = count * array.element_size;
+		if (!detail::seek(m_file, array.offset + first * array.element_size)
+			|| std::fread(values, 1, size, m_file) != size)
+			return false;
+
+		if (m_swapped)
+		{
+			detail::swap_bytes(values, size, array.scalar_size);
+		}
+		return true;
+	}
+
+	// blob_view
+
+	VDTMATH_API blob_view::blob_view()
+		: m_data(nullptr)
+		, m_arrays(nullptr)
+		, m_count(0)
+	{
+
+	}
+
+	VDTMATH_API bool blob_view::open(const void* data, const std::size_t size)
+	{
+		m_data = nullptr;
+		m_arrays = nullptr;
+		m_count = 0;
+
+		if (data == nullptr || size < sizeof(blob_header)) return false;
+
+		const blob_header& header = *static_cast<const blob_header*>(data);
+		if (std::memcmp(header.magic, "VDTM", 4) != 0
+			|| header.endian != detail::blob_endian
+			|| header.version == 0 || header.version > blob_version
+			|| header.size > size
+			|| header.table_offset % blob_alignment != 0
+			|| header.table_offset > header.size
+			|| header.array_count > (header.size - header.table_offset) / sizeof(blob_array))
+			return false;
+
+		const unsigned char* const bytes = static_cast<const unsigned char*>(data);
+		const blob_array* const arrays = reinterpret_cast<const blob_array*>(bytes + header.table_offset);
+		if (!detail::blob_validate(arrays, header.array_count, header.size)) return false;
+
+		m_data = bytes;
+		m_arrays = arrays;
+		m_count = header.array_count;
+		return true;
+	}
+
+	// mapped_file
+
+	VDTMATH_API mapped_file::mapped_file()
+		: m_data(nullptr)
+		, m_size(0)
+#if defined(_WIN32)
+		, m_mapping(nullptr)
+#endif
+	{
+
+	}
+
+	VDTMATH_API mapped_file::~mapped_file()
+	{
+		close();
+	}
+
+#if defined(_WIN32)
+	VDTMATH_API bool mapped_file::open(const char* path)
+	{
+		close();
+		const HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) return false;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		// the mapping keeps the file open
+		const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file);
+		if (mapping == nullptr) return false;
+
+		m_data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (m_data == nullptr)
+		{
+			CloseHandle(mapping);
+			return false;
+		}
+		m_mapping = mapping;
+		m_size = static_cast<std::size_t>(size.QuadPart);
+		return true;
+	}
+
+	VDTMATH_API void mapped_file::close()
+	{
+		if (m_data)
+		{
+			UnmapViewOfFile(m_data);
+			CloseHandle(static_cast<HANDLE>(m_mapping));
+		}
+		m_data = nullptr;
+		m_mapping = nullptr;
+		m_size = 0;
+	}
+#else
+	VDTMATH_API bool mapped_file::open(const char* path)
+	{
+		close();
+		const int file = ::open(path, O_RDONLY);
+		if (file < 0) return false;
+
+		struct stat status;
+		if (fstat(file, &status) != 0 || status.st_size <= 0)
+		{
+			::close(file);
+			return false;
+		}
+
+		// the mapping keeps the file open
+		void* const data = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		::close(file);
+		if (data == MAP_FAILED) return false;
+
+		m_data = data;
+		m_size = static_cast<std::size_t>(status.st_size);
+		return true;
+	}
+
+	VDTMATH_API void mapped_file::close()
+	{
+		if (m_data)
+		{
+			munmap(const_cast<void*>(m_data), m_size);
+		}
+		m_data = nullptr;
+		m_size = 0;
+	}
+#endif
+}
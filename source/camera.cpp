@@ -0,0 +1,126 @@
+#include <vdtmath/camera.h>
+#include <vdtmath/kernels.h>
+
+namespace math
+{
+	namespace detail
+	{
+		inline void camera_project(const matrix4_t<float>& matrix, const vector3_t<float>* points, vector3_t<float>* result, const std::size_t count)
+		{
+			math::project_points(matrix, points, result, count);
+		}
+
+		inline void camera_project(const matrix4_t<double>& m, const vector3_t<double>* points, vector3_t<double>* result, const std::size_t count)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const double x = points[i].x, y = points[i].y, z = points[i].z;
+				const double w = 1.0 / (x * m.m03 + y * m.m13 + z * m.m23 + m.m33);
+				result[i].x = (x * m.m00 + y * m.m10 + z * m.m20 + m.m30) * w;
+				result[i].y = (x * m.m01 + y * m.m11 + z * m.m21 + m.m31) * w;
+				result[i].z = (x * m.m02 + y * m.m12 + z * m.m22 + m.m32) * w;
+			}
+		}
+	}
+
+	template <typename T>
+	camera_t<T>::camera_t()
+		: m_view(matrix4_t<T>::identity)
+		, m_projection(matrix4_t<T>::identity)
+		, m_viewport(static_cast<T>(0.0), static_cast<T>(0.0), static_cast<T>(1.0), static_cast<T>(1.0))
+		, m_viewProjection(matrix4_t<T>::identity)
+		, m_inverseViewProjection(matrix4_t<T>::identity)
+		, m_screen(matrix4_t<T>::identity)
+		, m_inverseScreen(matrix4_t<T>::identity)
+		, m_isInvertible(true)
+	{
+		update();
+	}
+
+	template <typename T>
+	void camera_t<T>::set_view(const matrix4_t<T>& view)
+	{
+		m_view = view;
+		update();
+	}
+
+	template <typename T>
+	void camera_t<T>::look_at(const vector3_t<T>& eye, const vector3_t<T>& target, const vector3_t<T>& up)
+	{
+		set_view(math::look_at(eye, target, up));
+	}
+
+	template <typename T>
+	void camera_t<T>::set_projection(const matrix4_t<T>& projection)
+	{
+		m_projection = projection;
+		update();
+	}
+
+	template <typename T>
+	void camera_t<T>::set_viewport(const vector4_t<T>& viewport)
+	{
+		assert(viewport.z != static_cast<T>(0.0) && viewport.w != static_cast<T>(0.0));
+		m_viewport = viewport;
+		update();
+	}
+
+	template <typename T>
+	vector3_t<T> camera_t<T>::project(const vector3_t<T>& point) const
+	{
+		vector3_t<T> result;
+		detail::camera_project(m_screen, &point, &result, 1);
+		return result;
+	}
+
+	template <typename T>
+	vector3_t<T> camera_t<T>::unproject(const vector3_t<T>& point) const
+	{
+		vector3_t<T> result;
+		detail::camera_project(m_inverseScreen, &point, &result, 1);
+		return result;
+	}
+
+	template <typename T>
+	void camera_t<T>::project(const vector3_t<T>* points, vector3_t<T>* result, const std::size_t count) const
+	{
+		detail::camera_project(m_screen, points, result, count);
+	}
+
+	template <typename T>
+	void camera_t<T>::unproject(const vector3_t<T>* points, vector3_t<T>* result, const std::size_t count) const
+	{
+		detail::camera_project(m_inverseScreen, points, result, count);
+	}
+
+	template <typename T>
+	void camera_t<T>::update()
+	{
+		m_viewProjection = m_view * m_projection;
+		m_inverseViewProjection = m_viewProjection.inverse(m_isInvertible);
+
+		// ndc to screen, x and y from [-1, 1] to the viewport
+		const T half = static_cast<T>(0.5);
+		const T hw = m_viewport.z * half, hh = m_viewport.w * half;
+		matrix4_t<T> viewport = matrix4_t<T>::identity;
+		viewport.m00 = hw;
+		viewport.m11 = hh;
+		viewport.m30 = hw + m_viewport.x;
+		viewport.m31 = hh + m_viewport.y;
+
+		// and its closed form inverse
+		matrix4_t<T> inverse = matrix4_t<T>::identity;
+		inverse.m00 = static_cast<T>(1.0) / hw;
+		inverse.m11 = static_cast<T>(1.0) / hh;
+		inverse.m30 = -(hw + m_viewport.x) / hw;
+		inverse.m31 = -(hh + m_viewport.y) / hh;
+
+		m_screen = m_viewProjection * viewport;
+		m_inverseScreen = inverse * m_inverseViewProjection;
+	}
+
+#if !defined(VDTMATH_HEADER_ONLY)
+	template class camera_t<float>;
+	template class camera_t<double>;
+#endif
+}
@@ -0,0 +1,188 @@
+#include <vdtmath/cpu.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#include "kernels_table.h"
+
+#if VDTMATH_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace math
+{
+	namespace detail
+	{
+#if VDTMATH_X86
+		VDTMATH_API void cpuid(const unsigned int leaf, const unsigned int subleaf, unsigned int registers[4])
+		{
+#if defined(_MSC_VER)
+			int values[4];
+			__cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+			for (int i = 0; i < 4; ++i) registers[i] = static_cast<unsigned int>(values[i]);
+#else
+			__cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+		}
+
+		// state components enabled by the operating system
+		VDTMATH_API unsigned long long xgetbv()
+		{
+#if defined(_MSC_VER)
+			return _xgetbv(0);
+#else
+			unsigned int eax, edx;
+			__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+			return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+		}
+#endif
+
+		VDTMATH_API cpu_features detect()
+		{
+			cpu_features features{};
+#if VDTMATH_X86
+			unsigned int registers[4];
+			cpuid(0, 0, registers);
+			const unsigned int maxLeaf = registers[0];
+			if (maxLeaf < 1) return features;
+
+			cpuid(1, 0, registers);
+			features.sse2 = (registers[3] & (1u << 26)) != 0;
+			features.sse41 = (registers[2] & (1u << 19)) != 0;
+			const bool osxsave = (registers[2] & (1u << 27)) != 0;
+			const bool avx = (registers[2] & (1u << 28)) != 0;
+			const bool fma = (registers[2] & (1u << 12)) != 0;
+			const bool f16c = (registers[2] & (1u << 29)) != 0;
+
+			// the ymm and zmm registers must be saved by the operating system
+			const unsigned long long xcr0 = osxsave ? xgetbv() : 0;
+			const bool ymm = (xcr0 & 0x6) == 0x6;
+			const bool zmm = (xcr0 & 0xe6) == 0xe6;
+
+			features.avx = avx && ymm;
+			features.fma = fma && ymm;
+			features.f16c = f16c && ymm;
+			if (maxLeaf >= 7)
+			{
+				cpuid(7, 0, registers);
+				features.avx2 = features.avx && (registers[1] & (1u << 5)) != 0;
+				features.avx512f = zmm && (registers[1] & (1u << 16)) != 0;
+			}
+#endif
+			return features;
+		}
+
+		VDTMATH_API const kernel_table& kernels_for(const simd_level level)
+		{
+			switch (level)
+			{
+#if VDTMATH_X86
+			case simd_level::sse2: return sse2_kernels();
+			case simd_level::avx2: return avx2_kernels();
+			case simd_level::avx512: return avx512_kernels();
+#endif
+			default: return scalar_kernels();
+			}
+		}
+
+		// the avx2 and avx512 kernels fuse the multiplications and additions,
+		// the sse2 ones have the same results as the scalar ones
+		VDTMATH_API simd_level maximum_level()
+		{
+			const simd_level supported = math::supported_simd_level();
+#if defined(VDTMATH_DETERMINISTIC)
+			return supported < simd_level::sse2 ? supported : simd_level::sse2;
+#else
+			return supported;
+#endif
+		}
+
+		VDTMATH_API simd_level requested_level()
+		{
+			const simd_level supported = maximum_level();
+			const char* const value = std::getenv("VDTMATH_SIMD");
+			if (value == nullptr) return supported;
+
+			for (const simd_level level : { simd_level::none, simd_level::sse2, simd_level::avx2, simd_level::avx512 })
+			{
+				if (std::strcmp(value, to_string(level)) == 0)
+				{
+					return level <= supported ? level : supported;
+				}
+			}
+			return supported;
+		}
+
+		struct binding
+		{
+			binding()
+				: level(requested_level())
+				, kernels(&kernels_for(level.load()))
+			{
+
+			}
+
+			std::atomic<simd_level> level;
+			std::atomic<const kernel_table*> kernels;
+		};
+
+		VDTMATH_API binding& bound()
+		{
+			static binding instance;
+			return instance;
+		}
+
+		VDTMATH_API const kernel_table& kernels()
+		{
+			return *bound().kernels.load(std::memory_order_relaxed);
+		}
+	}
+
+	VDTMATH_API const cpu_features& cpu()
+	{
+		static const cpu_features features = detail::detect();
+		return features;
+	}
+
+	VDTMATH_API simd_level supported_simd_level()
+	{
+		const cpu_features& features = cpu();
+		// the avx2 kernels also use fma and the half float conversions
+		const bool avx2 = features.avx2 && features.fma && features.f16c;
+		if (features.avx512f && avx2) return simd_level::avx512;
+		if (avx2) return simd_level::avx2;
+		if (features.sse2) return simd_level::sse2;
+		return simd_level::none;
+	}
+
+	VDTMATH_API simd_level active_simd_level()
+	{
+		return detail::bound().level.load();
+	}
+
+	VDTMATH_API bool set_simd_level(const simd_level level)
+	{
+		if (level > detail::maximum_level()) return false;
+		detail::binding& b = detail::bound();
+		b.kernels.store(&detail::kernels_for(level));
+		b.level.store(level);
+		return true;
+	}
+
+	VDTMATH_API const char* to_string(const simd_level level)
+	{
+		switch (level)
+		{
+		case simd_level::sse2: return "sse2";
+		case simd_level::avx2: return "avx2";
+		case simd_level::avx512: return "avx512";
+		default: return "none";
+		}
+	}
+}
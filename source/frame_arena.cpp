@@ -0,0 +1,74 @@
+#include <vdtmath/frame_arena.h>
+
+namespace math
+{
+	VDTMATH_API frame_arena::frame_arena(const std::size_t capacity)
+		: m_block(nullptr)
+		, m_cursor(0)
+		, m_end(0)
+		, m_retired(0)
+		, m_capacity(0)
+	{
+		push_block(capacity);
+	}
+
+	VDTMATH_API frame_arena::~frame_arena()
+	{
+		free_blocks();
+	}
+
+	VDTMATH_API void frame_arena::reset()
+	{
+		if (m_block->previous != nullptr)
+		{
+			// the frame did not fit, the next ones get a single block
+			const std::size_t capacity = m_capacity;
+			free_blocks();
+			push_block(capacity);
+		}
+		m_cursor = reinterpret_cast<std::uintptr_t>(m_block) + header_size;
+		m_retired = 0;
+	}
+
+	VDTMATH_API std::size_t frame_arena::used() const
+	{
+		return m_retired + static_cast<std::size_t>(m_cursor - (reinterpret_cast<std::uintptr_t>(m_block) + header_size));
+	}
+
+	VDTMATH_API void* frame_arena::allocate_block(const std::size_t size, const std::size_t alignment)
+	{
+		m_retired += static_cast<std::size_t>(m_cursor - (reinterpret_cast<std::uintptr_t>(m_block) + header_size));
+
+		// the blocks grow geometrically, a large request gets its own size
+		const std::size_t needed = size + alignment;
+		push_block(m_block->size > needed ? m_block->size * 2 : needed * 2);
+
+		void* const result = allocate(size, alignment);
+		assert(result != nullptr);
+		return result;
+	}
+
+	VDTMATH_API void frame_arena::push_block(const std::size_t size)
+	{
+		void* const memory = aligned_malloc(header_size + size, cache_line_size);
+		block* const b = static_cast<block*>(memory);
+		b->previous = m_block;
+		b->size = size;
+
+		m_block = b;
+		m_cursor = reinterpret_cast<std::uintptr_t>(memory) + header_size;
+		m_end = m_cursor + size;
+		m_capacity += size;
+	}
+
+	VDTMATH_API void frame_arena::free_blocks()
+	{
+		while (m_block)
+		{
+			block* const previous = m_block->previous;
+			aligned_free(m_block, cache_line_size);
+			m_block = previous;
+		}
+		m_capacity = 0;
+	}
+}
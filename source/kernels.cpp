@@ -0,0 +1,511 @@
+#include <vdtmath/kernels.h>
+
+#include <cmath>
+
+#include <vdtmath/curve.h>
+#include <vdtmath/mask.h>
+#include <vdtmath/pose.h>
+#include <vdtmath/quantize.h>
+#include <vdtmath/trs.h>
+
+#if defined(VDTMATH_PROFILE)
+#include <vdtmath/profile.h>
+#endif
+
+#include "kernels_table.h"
+
+namespace math
+{
+	namespace detail
+	{
+		VDTMATH_API void multiply_scalar(const matrix4& a, const matrix4& b, matrix4& result)
+		{
+			float r[16];
+			for (unsigned int row = 0; row < 4; ++row)
+			{
+				for (unsigned int column = 0; column < 4; ++column)
+				{
+					r[row * 4 + column] = a.data[row * 4 + 0] * b.data[0 * 4 + column]
+						+ a.data[row * 4 + 1] * b.data[1 * 4 + column]
+						+ a.data[row * 4 + 2] * b.data[2 * 4 + column]
+						+ a.data[row * 4 + 3] * b.data[3 * 4 + column];
+				}
+			}
+			for (unsigned int i = 0; i < 16; ++i)
+				result.data[i] = r[i];
+		}
+
+		VDTMATH_API void multiply_scalar(const matrix4* a, const matrix4* b, matrix4* result, const std::size_t count)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				multiply_scalar(a[i], b[i], result[i]);
+			}
+		}
+
+		VDTMATH_API void multiply_one_scalar(const matrix4& matrix, const matrix4* b, matrix4* result, const std::size_t count)
+		{
+			const matrix4 a(matrix);
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				multiply_scalar(a, b[i], result[i]);
+			}
+		}
+
+		VDTMATH_API void multiply_affine_scalar(const affine3* a, const affine3* b, affine3* result, const std::size_t count)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				result[i] = a[i] * b[i];
+			}
+		}
+
+		VDTMATH_API void transform_points_scalar(const matrix4& matrix, const vector3* points, vector3* result, const std::size_t count)
+		{
+			const matrix4 m(matrix);
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const float x = points[i].x, y = points[i].y, z = points[i].z;
+				result[i].x = x * m.m00 + y * m.m10 + z * m.m20 + m.m30;
+				result[i].y = x * m.m01 + y * m.m11 + z * m.m21 + m.m31;
+				result[i].z = x * m.m02 + y * m.m12 + z * m.m22 + m.m32;
+			}
+		}
+
+		VDTMATH_API void project_points_scalar(const matrix4& matrix, const vector3* points, vector3* result, const std::size_t count)
+		{
+			const matrix4 m(matrix);
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const float x = points[i].x, y = points[i].y, z = points[i].z;
+				const float w = 1.f / (x * m.m03 + y * m.m13 + z * m.m23 + m.m33);
+				result[i].x = (x * m.m00 + y * m.m10 + z * m.m20 + m.m30) * w;
+				result[i].y = (x * m.m01 + y * m.m11 + z * m.m21 + m.m31) * w;
+				result[i].z = (x * m.m02 + y * m.m12 + z * m.m22 + m.m32) * w;
+			}
+		}
+
+		VDTMATH_API void transform_points_affine_scalar(const affine3& affine, const vector3* points, vector3* result, const std::size_t count)
+		{
+			const affine3 m(affine);
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				result[i] = m.transform_point(points[i]);
+			}
+		}
+
+		VDTMATH_API void transform_normals_scalar(const matrix3& matrix, const vector3* normals, vector3* result, const std::size_t count)
+		{
+			const matrix3 m(matrix);
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const float x = normals[i].x, y = normals[i].y, z = normals[i].z;
+				result[i].x = x * m.m00 + y * m.m10 + z * m.m20;
+				result[i].y = x * m.m01 + y * m.m11 + z * m.m21;
+				result[i].z = x * m.m02 + y * m.m12 + z * m.m22;
+			}
+		}
+
+		VDTMATH_API void normalize_scalar(vector3* vectors, const std::size_t count)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				vectors[i].normalize();
+			}
+		}
+
+		VDTMATH_API std::size_t cull_spheres_scalar(const vector4* planes, const vector4* spheres, const std::size_t count, std::uint8_t* mask)
+		{
+			return test_mask(count, mask, [planes, spheres](const std::size_t i)
+				{
+					const vector4& s = spheres[i];
+					bool visible = true;
+					for (unsigned int p = 0; p < 6; ++p)
+					{
+						const float d = s.x * planes[p].x + s.y * planes[p].y + s.z * planes[p].z + planes[p].w;
+						visible &= d >= -s.w;
+					}
+					return visible;
+				});
+		}
+
+		VDTMATH_API void encode_half_scalar(const float* values, std::uint16_t* result, const std::size_t count)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				result[i] = to_half(values[i]);
+			}
+		}
+
+		VDTMATH_API void decode_half_scalar(const std::uint16_t* values, float* result, const std::size_t count)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				result[i] = from_half(values[i]);
+			}
+		}
+
+		VDTMATH_API void encode_octahedral_scalar(const vector3* normals, std::uint32_t* result, const std::size_t count)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				result[i] = encode_octahedral32(normals[i]);
+			}
+		}
+
+		VDTMATH_API void decode_octahedral_scalar(const std::uint32_t* values, vector3* result, const std::size_t count)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				result[i] = decode_octahedral(values[i]);
+			}
+		}
+
+		VDTMATH_API void encode_positions_scalar(const position_quantizer& quantizer, const vector3* positions, packed_position* result, const std::size_t count)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				result[i] = quantizer.encode(positions[i]);
+			}
+		}
+
+		VDTMATH_API void decode_positions_scalar(const position_quantizer& quantizer, const packed_position* positions, vector3* result, const std::size_t count)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				result[i] = quantizer.decode(positions[i]);
+			}
+		}
+
+		VDTMATH_API void evaluate_hermite_scalar(const float* u, const float* p0, const float* m0, const float* p1, const float* m1, float* result, const std::size_t count)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const float s = u[i], s2 = s * s, s3 = s2 * s;
+				result[i] = (2.f * s3 - 3.f * s2 + 1.f) * p0[i] + (s3 - 2.f * s2 + s) * m0[i]
+					+ (3.f * s2 - 2.f * s3) * p1[i] + (s3 - s2) * m1[i];
+			}
+		}
+
+		VDTMATH_API void blend_trs_scalar(const trs* a, const trs* b, const float* weights, const std::size_t weight_stride, trs* result, const std::size_t count)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				result[i] = interpolate(a[i], b[i], weights[i * weight_stride]);
+			}
+		}
+
+		VDTMATH_API void pose_matrices_scalar(const trs* locals, const std::int32_t* parents, const matrix4* inverse_bind, const matrix4& root, matrix4* model, matrix4* palette, const std::size_t count)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				model[i] = compose(locals[i]) * (parents[i] < 0 ? root : model[parents[i]]);
+				if (palette)
+				{
+					palette[i] = inverse_bind[i] * model[i];
+				}
+			}
+		}
+
+		VDTMATH_API std::size_t circle_contains_points_scalar(const float* circle, const float* points, const std::size_t count, std::uint8_t* mask)
+		{
+			return test_mask(count, mask, [circle, points](const std::size_t i)
+				{
+					const float deltaX = circle[0] - points[i * 2 + 0];
+					const float deltaY = circle[1] - points[i * 2 + 1];
+					return deltaX * deltaX + deltaY * deltaY <= circle[2] * circle[2];
+				});
+		}
+
+		VDTMATH_API std::size_t circle_contains_circles_scalar(const float* circle, const float* circles, const std::size_t count, std::uint8_t* mask)
+		{
+			return test_mask(count, mask, [circle, circles](const std::size_t i)
+				{
+					const float deltaX = circle[0] - circles[i * 3 + 0];
+					const float deltaY = circle[1] - circles[i * 3 + 1];
+					return (deltaX * deltaX + deltaY * deltaY <= circle[2] * circle[2])
+						& (circles[i * 3 + 2] <= circle[2]);
+				});
+		}
+
+		VDTMATH_API std::size_t circle_intersects_circles_scalar(const float* circle, const float* circles, const std::size_t count, std::uint8_t* mask)
+		{
+			return test_mask(count, mask, [circle, circles](const std::size_t i)
+				{
+					const float deltaX = circle[0] - circles[i * 3 + 0];
+					const float deltaY = circle[1] - circles[i * 3 + 1];
+					const float sum = circle[2] + circles[i * 3 + 2];
+					return deltaX * deltaX + deltaY * deltaY <= sum * sum;
+				});
+		}
+
+		VDTMATH_API std::size_t overlap_boxes_scalar(const float* box, const float* min_x, const float* min_y, const float* max_x, const float* max_y, const std::size_t count, std::uint8_t* mask)
+		{
+			return test_mask(count, mask, [=](const std::size_t i)
+				{
+					return (min_x[i] <= box[2]) & (max_x[i] >= box[0]) & (min_y[i] <= box[3]) & (max_y[i] >= box[1]);
+				});
+		}
+
+		VDTMATH_API const kernel_table& scalar_kernels()
+		{
+			static const kernel_table table = {
+				&multiply_scalar,
+				&multiply_one_scalar,
+				&multiply_affine_scalar,
+				&transform_points_scalar,
+				&transform_points_affine_scalar,
+				&transform_normals_scalar,
+				&normalize_scalar,
+				&cull_spheres_scalar,
+				&encode_half_scalar,
+				&decode_half_scalar,
+				&encode_octahedral_scalar,
+				&decode_octahedral_scalar,
+				&encode_positions_scalar,
+				&decode_positions_scalar,
+				&evaluate_hermite_scalar,
+				&project_points_scalar,
+				&blend_trs_scalar,
+				&pose_matrices_scalar,
+				&circle_contains_points_scalar,
+				&circle_contains_circles_scalar,
+				&circle_intersects_circles_scalar,
+				&overlap_boxes_scalar
+			};
+			return table;
+		}
+
+		// batch tests, see mask.h
+
+		VDTMATH_API std::size_t circle_contains_points(const float* circle, const float* points, const std::size_t count, std::uint8_t* mask)
+		{
+			return kernels().circle_contains_points(circle, points, count, mask);
+		}
+
+		VDTMATH_API std::size_t circle_contains_circles(const float* circle, const float* circles, const std::size_t count, std::uint8_t* mask)
+		{
+			return kernels().circle_contains_circles(circle, circles, count, mask);
+		}
+
+		VDTMATH_API std::size_t circle_intersects_circles(const float* circle, const float* circles, const std::size_t count, std::uint8_t* mask)
+		{
+			return kernels().circle_intersects_circles(circle, circles, count, mask);
+		}
+
+		VDTMATH_API std::size_t overlap_boxes(const float* box, const float* min_x, const float* min_y, const float* max_x, const float* max_y, const std::size_t count, std::uint8_t* mask)
+		{
+			return kernels().overlap_boxes(box, min_x, min_y, max_x, max_y, count, mask);
+		}
+	}
+
+	VDTMATH_API void multiply(const matrix4* a, const matrix4* b, matrix4* result, const std::size_t count)
+	{
+		VDTMATH_PROFILE_SCOPE("multiply", count);
+		VDTMATH_PROFILE_COUNT(matrix_multiply, count);
+		detail::kernels().multiply(a, b, result, count);
+	}
+
+	VDTMATH_API void multiply(const matrix4& matrix, const matrix4* b, matrix4* result, const std::size_t count)
+	{
+		VDTMATH_PROFILE_SCOPE("multiply", count);
+		VDTMATH_PROFILE_COUNT(matrix_multiply, count);
+		detail::kernels().multiply_one(matrix, b, result, count);
+	}
+
+	VDTMATH_API void multiply(const affine3* a, const affine3* b, affine3* result, const std::size_t count)
+	{
+		VDTMATH_PROFILE_SCOPE("multiply", count);
+		VDTMATH_PROFILE_COUNT(matrix_multiply, count);
+		detail::kernels().multiply_affine(a, b, result, count);
+	}
+
+	VDTMATH_API void transform_points(const matrix4& matrix, const vector3* points, vector3* result, const std::size_t count)
+	{
+		VDTMATH_PROFILE_SCOPE("transform_points", count);
+		detail::kernels().transform_points(matrix, points, result, count);
+	}
+
+	VDTMATH_API void project_points(const matrix4& matrix, const vector3* points, vector3* result, const std::size_t count)
+	{
+		VDTMATH_PROFILE_SCOPE("project_points", count);
+		detail::kernels().project_points(matrix, points, result, count);
+	}
+
+	VDTMATH_API void transform_points(const affine3& affine, const vector3* points, vector3* result, const std::size_t count)
+	{
+		VDTMATH_PROFILE_SCOPE("transform_points", count);
+		detail::kernels().transform_points_affine(affine, points, result, count);
+	}
+
+	VDTMATH_API void transform_normals(const matrix3& matrix, const vector3* normals, vector3* result, const std::size_t count)
+	{
+		VDTMATH_PROFILE_SCOPE("transform_normals", count);
+		detail::kernels().transform_normals(matrix, normals, result, count);
+	}
+
+	VDTMATH_API void normalize(vector3* vectors, const std::size_t count)
+	{
+		VDTMATH_PROFILE_SCOPE("normalize", count);
+		detail::kernels().normalize(vectors, count);
+	}
+
+	VDTMATH_API void frustum_planes(const matrix4& m, vector4* planes, const clip_depth depth)
+	{
+		// clip = (p, 1) * m, the planes combine the columns of the matrix
+		const vector4 c0(m.m00, m.m10, m.m20, m.m30);
+		const vector4 c1(m.m01, m.m11, m.m21, m.m31);
+		const vector4 c2(m.m02, m.m12, m.m22, m.m32);
+		const vector4 c3(m.m03, m.m13, m.m23, m.m33);
+		planes[0] = c3 + c0;
+		planes[1] = c3 - c0;
+		planes[2] = c3 + c1;
+		planes[3] = c3 - c1;
+		if (depth == clip_depth::one_to_zero)
+		{
+			// z <= w at the near plane and z >= 0 at the far one
+			planes[4] = c3 - c2;
+			planes[5] = c2;
+		}
+		else
+		{
+			planes[4] = c3 + c2;
+			planes[5] = c3 - c2;
+		}
+		for (unsigned int i = 0; i < 6; ++i)
+		{
+			vector4& p = planes[i];
+			const float l = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+			if (l != 0.f)
+			{
+				p /= l;
+			}
+		}
+	}
+
+	VDTMATH_API std::size_t cull_spheres(const vector4* planes, const vector4* spheres, const std::size_t count, std::uint8_t* mask)
+	{
+		VDTMATH_PROFILE_SCOPE("cull_spheres", count);
+		return detail::kernels().cull_spheres(planes, spheres, count, mask);
+	}
+
+	// quantization, see quantize.h
+
+	VDTMATH_API void encode_half(const float* values, std::uint16_t* result, const std::size_t count)
+	{
+		VDTMATH_PROFILE_SCOPE("encode_half", count);
+		detail::kernels().encode_half(values, result, count);
+	}
+
+	VDTMATH_API void decode_half(const std::uint16_t* values, float* result, const std::size_t count)
+	{
+		VDTMATH_PROFILE_SCOPE("decode_half", count);
+		detail::kernels().decode_half(values, result, count);
+	}
+
+	VDTMATH_API void encode_octahedral(const vector3* normals, std::uint16_t* result, const std::size_t count)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			result[i] = encode_octahedral16(normals[i]);
+		}
+	}
+
+	VDTMATH_API void encode_octahedral(const vector3* normals, std::uint32_t* result, const std::size_t count)
+	{
+		VDTMATH_PROFILE_SCOPE("encode_octahedral", count);
+		detail::kernels().encode_octahedral(normals, result, count);
+	}
+
+	VDTMATH_API void decode_octahedral(const std::uint16_t* values, vector3* result, const std::size_t count)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			result[i] = decode_octahedral(values[i]);
+		}
+	}
+
+	VDTMATH_API void decode_octahedral(const std::uint32_t* values, vector3* result, const std::size_t count)
+	{
+		VDTMATH_PROFILE_SCOPE("decode_octahedral", count);
+		detail::kernels().decode_octahedral(values, result, count);
+	}
+
+	// the smallest three encoding branches on the largest component,
+	// the loops are left to the compiler
+
+	VDTMATH_API void encode_quaternions(const quaternion* quaternions, std::uint32_t* result, const std::size_t count)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			result[i] = encode_quaternion32(quaternions[i]);
+		}
+	}
+
+	VDTMATH_API void encode_quaternions(const quaternion* quaternions, packed_quaternion48* result, const std::size_t count)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			result[i] = encode_quaternion48(quaternions[i]);
+		}
+	}
+
+	VDTMATH_API void decode_quaternions(const std::uint32_t* values, quaternion* result, const std::size_t count)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			result[i] = decode_quaternion(values[i]);
+		}
+	}
+
+	VDTMATH_API void decode_quaternions(const packed_quaternion48* values, quaternion* result, const std::size_t count)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			result[i] = decode_quaternion(values[i]);
+		}
+	}
+
+	VDTMATH_API void encode_positions(const position_quantizer& quantizer, const vector3* positions, packed_position* result, const std::size_t count)
+	{
+		VDTMATH_PROFILE_SCOPE("encode_positions", count);
+		detail::kernels().encode_positions(quantizer, positions, result, count);
+	}
+
+	VDTMATH_API void decode_positions(const position_quantizer& quantizer, const packed_position* positions, vector3* result, const std::size_t count)
+	{
+		VDTMATH_PROFILE_SCOPE("decode_positions", count);
+		detail::kernels().decode_positions(quantizer, positions, result, count);
+	}
+
+	// curves, see curve.h
+
+	VDTMATH_API void evaluate_hermite(const float* u, const float* p0, const float* m0, const float* p1, const float* m1, float* result, const std::size_t count)
+	{
+		VDTMATH_PROFILE_SCOPE("evaluate_hermite", count);
+		detail::kernels().evaluate_hermite(u, p0, m0, p1, m1, result, count);
+	}
+
+	// trs, see trs.h
+
+	VDTMATH_API void blend(const trs* a, const trs* b, const float weight, trs* result, const std::size_t count)
+	{
+		VDTMATH_PROFILE_SCOPE("blend", count);
+		detail::kernels().blend_trs(a, b, &weight, 0, result, count);
+	}
+
+	VDTMATH_API void blend(const trs* a, const trs* b, const float* weights, trs* result, const std::size_t count)
+	{
+		VDTMATH_PROFILE_SCOPE("blend", count);
+		detail::kernels().blend_trs(a, b, weights, 1, result, count);
+	}
+
+	// poses, see pose.h
+
+	VDTMATH_API void pose_matrices(const trs* locals, const std::int32_t* parents, const matrix4* inverse_bind, const matrix4& root, matrix4* model, matrix4* palette, const std::size_t count)
+	{
+		VDTMATH_PROFILE_SCOPE("pose_matrices", count);
+		assert(model != nullptr && (palette == nullptr || inverse_bind != nullptr));
+		detail::kernels().pose_matrices(locals, parents, inverse_bind, root, model, palette, count);
+	}
+}
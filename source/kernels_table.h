@@ -0,0 +1,72 @@
+/// Copyright (c) Vito Domenico Tagliente
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vdtmath/affine3.h>
+#include <vdtmath/config.h>
+#include <vdtmath/matrix3.h>
+#include <vdtmath/matrix4.h>
+#include <vdtmath/vector3.h>
+#include <vdtmath/vector4.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define VDTMATH_X86 1
+#else
+#define VDTMATH_X86 0
+#endif
+
+namespace math
+{
+	// quantize.h includes the kernels in header only mode
+	struct packed_position;
+	struct position_quantizer;
+	template <typename T> struct trs_t;
+
+	namespace detail
+	{
+		// one implementation of every batch kernel for a simd level
+		struct kernel_table
+		{
+			void (*multiply)(const matrix4* a, const matrix4* b, matrix4* result, const std::size_t count);
+			void (*multiply_one)(const matrix4& matrix, const matrix4* b, matrix4* result, const std::size_t count);
+			void (*multiply_affine)(const affine3* a, const affine3* b, affine3* result, const std::size_t count);
+			void (*transform_points)(const matrix4& matrix, const vector3* points, vector3* result, const std::size_t count);
+			void (*transform_points_affine)(const affine3& affine, const vector3* points, vector3* result, const std::size_t count);
+			void (*transform_normals)(const matrix3& matrix, const vector3* normals, vector3* result, const std::size_t count);
+			void (*normalize)(vector3* vectors, const std::size_t count);
+			std::size_t (*cull_spheres)(const vector4* planes, const vector4* spheres, const std::size_t count, std::uint8_t* mask);
+			void (*encode_half)(const float* values, std::uint16_t* result, const std::size_t count);
+			void (*decode_half)(const std::uint16_t* values, float* result, const std::size_t count);
+			void (*encode_octahedral)(const vector3* normals, std::uint32_t* result, const std::size_t count);
+			void (*decode_octahedral)(const std::uint32_t* values, vector3* result, const std::size_t count);
+			void (*encode_positions)(const position_quantizer& quantizer, const vector3* positions, packed_position* result, const std::size_t count);
+			void (*decode_positions)(const position_quantizer& quantizer, const packed_position* positions, vector3* result, const std::size_t count);
+			void (*evaluate_hermite)(const float* u, const float* p0, const float* m0, const float* p1, const float* m1, float* result, const std::size_t count);
+			void (*project_points)(const matrix4& matrix, const vector3* points, vector3* result, const std::size_t count);
+			// a weight_stride of 0 for one weight, 1 for one per element
+			void (*blend_trs)(const trs_t<float>* a, const trs_t<float>* b, const float* weights, const std::size_t weight_stride, trs_t<float>* result, const std::size_t count);
+			void (*pose_matrices)(const trs_t<float>* locals, const std::int32_t* parents, const matrix4* inverse_bind, const matrix4& root, matrix4* model, matrix4* palette, const std::size_t count);
+			// the batch tests of mask.h
+			std::size_t (*circle_contains_points)(const float* circle, const float* points, const std::size_t count, std::uint8_t* mask);
+			std::size_t (*circle_contains_circles)(const float* circle, const float* circles, const std::size_t count, std::uint8_t* mask);
+			std::size_t (*circle_intersects_circles)(const float* circle, const float* circles, const std::size_t count, std::uint8_t* mask);
+			std::size_t (*overlap_boxes)(const float* box, const float* min_x, const float* min_y, const float* max_x, const float* max_y, const std::size_t count, std::uint8_t* mask);
+		};
+
+		VDTMATH_API const kernel_table& scalar_kernels();
+#if VDTMATH_X86
+		VDTMATH_API const kernel_table& sse2_kernels();
+		VDTMATH_API const kernel_table& avx2_kernels();
+		VDTMATH_API const kernel_table& avx512_kernels();
+#endif
+
+		// the table bound to the active simd level, see cpu.cpp
+		VDTMATH_API const kernel_table& kernels();
+	}
+}
+
+// kernels() lives in cpu.cpp, which header only builds pull through cpu.h
+#include <vdtmath/cpu.h>
@@ -0,0 +1,1434 @@
+#include "kernels_table.h"
+
+#if VDTMATH_X86
+
+#include <immintrin.h>
+
+#include <vdtmath/aligned_array.h>
+#include <vdtmath/mask.h>
+#include <vdtmath/pose.h>
+#include <vdtmath/quantize.h>
+#include <vdtmath/trs.h>
+
+// the functions are compiled for their instruction set whatever
+// the flags of the translation unit and only called when supported
+#if defined(_MSC_VER) && !defined(__clang__)
+#define VDTMATH_TARGET(features)
+#else
+#define VDTMATH_TARGET(features) __attribute__((target(features)))
+#endif
+
+namespace math
+{
+	namespace detail
+	{
+		static_assert(sizeof(vector3) % sizeof(float) == 0, "vector3 arrays are read with a float stride");
+		static_assert(sizeof(vector4) % sizeof(float) == 0, "vector4 arrays are read with a float stride");
+
+		// distance between two consecutive elements, in floats
+		constexpr int vector3_stride = static_cast<int>(sizeof(vector3) / sizeof(float));
+		constexpr int vector4_stride = static_cast<int>(sizeof(vector4) / sizeof(float));
+
+		static_assert(sizeof(matrix4) % 64 == 0, "every matrix4 of an aligned array is aligned");
+		static_assert(sizeof(vector4) % 16 == 0, "every vector4 of an aligned array is aligned");
+
+		// the arrays in aligned storage, see aligned_array.h, take the
+		// paths with aligned loads and stores, the unaligned ones are
+		// slower on older cpus and split cache lines
+		inline bool are_aligned(const void* a, const void* b, const void* c, const std::size_t alignment)
+		{
+			return is_aligned(a, alignment) && is_aligned(b, alignment) && is_aligned(c, alignment);
+		}
+
+		// sse2
+
+		template <bool Aligned>
+		VDTMATH_TARGET("sse2")
+		inline __m128 load_sse2(const float* p)
+		{
+			return Aligned ? _mm_load_ps(p) : _mm_loadu_ps(p);
+		}
+
+		template <bool Aligned>
+		VDTMATH_TARGET("sse2")
+		inline void store_sse2(float* p, const __m128 v)
+		{
+			if (Aligned) _mm_store_ps(p, v);
+			else _mm_storeu_ps(p, v);
+		}
+
+		template <bool Aligned>
+		VDTMATH_TARGET("sse2")
+		inline void multiply_rows_sse2(const float* a, const __m128 b0, const __m128 b1, const __m128 b2, const __m128 b3, float* result)
+		{
+			__m128 rows[4];
+			for (unsigned int row = 0; row < 4; ++row)
+			{
+				__m128 r = _mm_mul_ps(_mm_set1_ps(a[row * 4 + 0]), b0);
+				r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a[row * 4 + 1]), b1));
+				r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a[row * 4 + 2]), b2));
+				r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a[row * 4 + 3]), b3));
+				rows[row] = r;
+			}
+			// stored at the end, the result can alias the inputs
+			for (unsigned int row = 0; row < 4; ++row)
+				store_sse2<Aligned>(result + row * 4, rows[row]);
+		}
+
+		template <bool Aligned>
+		VDTMATH_TARGET("sse2")
+		inline void multiply_loop_sse2(const matrix4* a, const matrix4* b, matrix4* result, const std::size_t count)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const float* const m = b[i].data;
+				multiply_rows_sse2<Aligned>(a[i].data, load_sse2<Aligned>(m), load_sse2<Aligned>(m + 4), load_sse2<Aligned>(m + 8), load_sse2<Aligned>(m + 12), result[i].data);
+			}
+		}
+
+		VDTMATH_TARGET("sse2")
+		VDTMATH_API void multiply_sse2(const matrix4* a, const matrix4* b, matrix4* result, const std::size_t count)
+		{
+			if (are_aligned(a, b, result, 16)) multiply_loop_sse2<true>(a, b, result, count);
+			else multiply_loop_sse2<false>(a, b, result, count);
+		}
+
+		template <bool Aligned>
+		VDTMATH_TARGET("sse2")
+		inline void multiply_one_loop_sse2(const float* a, const matrix4* b, matrix4* result, const std::size_t count)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const float* const m = b[i].data;
+				multiply_rows_sse2<Aligned>(a, load_sse2<Aligned>(m), load_sse2<Aligned>(m + 4), load_sse2<Aligned>(m + 8), load_sse2<Aligned>(m + 12), result[i].data);
+			}
+		}
+
+		VDTMATH_TARGET("sse2")
+		VDTMATH_API void multiply_one_sse2(const matrix4& matrix, const matrix4* b, matrix4* result, const std::size_t count)
+		{
+			alignas(64) float a[16];
+			for (unsigned int i = 0; i < 16; ++i) a[i] = matrix.data[i];
+			if (are_aligned(a, b, result, 16)) multiply_one_loop_sse2<true>(a, b, result, count);
+			else multiply_one_loop_sse2<false>(a, b, result, count);
+		}
+
+		template <bool Aligned>
+		VDTMATH_TARGET("sse2")
+		inline void pose_loop_sse2(const trs* locals, const std::int32_t* parents, const matrix4* inverse_bind, const float* root, matrix4* model, matrix4* palette, const std::size_t count)
+		{
+			alignas(64) matrix4 local;
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				local = compose(locals[i]);
+				const float* const m = parents[i] < 0 ? root : model[parents[i]].data;
+				multiply_rows_sse2<Aligned>(local.data, load_sse2<Aligned>(m), load_sse2<Aligned>(m + 4), load_sse2<Aligned>(m + 8), load_sse2<Aligned>(m + 12), model[i].data);
+				if (palette)
+				{
+					const float* const p = model[i].data;
+					multiply_rows_sse2<Aligned>(inverse_bind[i].data, load_sse2<Aligned>(p), load_sse2<Aligned>(p + 4), load_sse2<Aligned>(p + 8), load_sse2<Aligned>(p + 12), palette[i].data);
+				}
+			}
+		}
+
+		VDTMATH_TARGET("sse2")
+		VDTMATH_API void pose_matrices_sse2(const trs* locals, const std::int32_t* parents, const matrix4* inverse_bind, const matrix4& root, matrix4* model, matrix4* palette, const std::size_t count)
+		{
+			alignas(64) float r[16];
+			for (unsigned int i = 0; i < 16; ++i) r[i] = root.data[i];
+			if (are_aligned(inverse_bind, model, palette, 16)) pose_loop_sse2<true>(locals, parents, inverse_bind, r, model, palette, count);
+			else pose_loop_sse2<false>(locals, parents, inverse_bind, r, model, palette, count);
+		}
+
+		VDTMATH_TARGET("sse2")
+		VDTMATH_API void multiply_affine_sse2(const affine3* a, const affine3* b, affine3* result, const std::size_t count)
+		{
+			// each row of the result combines the rows of a
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const float* const m = a[i].data;
+				const __m128 a0 = _mm_loadu_ps(m);
+				const __m128 a1 = _mm_loadu_ps(m + 4);
+				const __m128 a2 = _mm_loadu_ps(m + 8);
+				__m128 rows[3];
+				for (unsigned int row = 0; row < 3; ++row)
+				{
+					const float* const r = b[i].data + row * 4;
+					__m128 v = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(r[0]), a0), _mm_mul_ps(_mm_set1_ps(r[1]), a1));
+					v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(r[2]), a2));
+					rows[row] = _mm_add_ps(v, _mm_setr_ps(0.f, 0.f, 0.f, r[3]));
+				}
+				float* const out = result[i].data;
+				_mm_storeu_ps(out, rows[0]);
+				_mm_storeu_ps(out + 4, rows[1]);
+				_mm_storeu_ps(out + 8, rows[2]);
+			}
+		}
+
+		VDTMATH_TARGET("sse2")
+		VDTMATH_API void transform_points_affine_sse2(const affine3& affine, const vector3* points, vector3* result, const std::size_t count)
+		{
+			const float* const m = affine.data;
+			const __m128 c0 = _mm_setr_ps(m[0], m[4], m[8], 0.f);
+			const __m128 c1 = _mm_setr_ps(m[1], m[5], m[9], 0.f);
+			const __m128 c2 = _mm_setr_ps(m[2], m[6], m[10], 0.f);
+			const __m128 c3 = _mm_setr_ps(m[3], m[7], m[11], 0.f);
+			alignas(16) float p[4];
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				__m128 v = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(points[i].x), c0), _mm_mul_ps(_mm_set1_ps(points[i].y), c1));
+				v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(points[i].z), c2));
+				v = _mm_add_ps(v, c3);
+				_mm_store_ps(p, v);
+				result[i].x = p[0];
+				result[i].y = p[1];
+				result[i].z = p[2];
+			}
+		}
+
+		VDTMATH_TARGET("sse2")
+		VDTMATH_API void transform_points_sse2(const matrix4& matrix, const vector3* points, vector3* result, const std::size_t count)
+		{
+			const __m128 r0 = _mm_loadu_ps(matrix.data);
+			const __m128 r1 = _mm_loadu_ps(matrix.data + 4);
+			const __m128 r2 = _mm_loadu_ps(matrix.data + 8);
+			const __m128 r3 = _mm_loadu_ps(matrix.data + 12);
+			alignas(16) float p[4];
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				__m128 v = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(points[i].x), r0), _mm_mul_ps(_mm_set1_ps(points[i].y), r1));
+				v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(points[i].z), r2));
+				v = _mm_add_ps(v, r3);
+				_mm_store_ps(p, v);
+				result[i].x = p[0];
+				result[i].y = p[1];
+				result[i].z = p[2];
+			}
+		}
+
+		VDTMATH_TARGET("sse2")
+		VDTMATH_API void project_points_sse2(const matrix4& matrix, const vector3* points, vector3* result, const std::size_t count)
+		{
+			const __m128 r0 = _mm_loadu_ps(matrix.data);
+			const __m128 r1 = _mm_loadu_ps(matrix.data + 4);
+			const __m128 r2 = _mm_loadu_ps(matrix.data + 8);
+			const __m128 r3 = _mm_loadu_ps(matrix.data + 12);
+			alignas(16) float p[4];
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				__m128 v = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(points[i].x), r0), _mm_mul_ps(_mm_set1_ps(points[i].y), r1));
+				v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(points[i].z), r2));
+				v = _mm_add_ps(v, r3);
+				// the reciprocal of w as the scalar kernel, for the same results
+				v = _mm_mul_ps(v, _mm_div_ps(_mm_set1_ps(1.f), _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+				_mm_store_ps(p, v);
+				result[i].x = p[0];
+				result[i].y = p[1];
+				result[i].z = p[2];
+			}
+		}
+
+		VDTMATH_TARGET("sse2")
+		VDTMATH_API void transform_normals_sse2(const matrix3& matrix, const vector3* normals, vector3* result, const std::size_t count)
+		{
+			const float* const m = matrix.data;
+			const __m128 r0 = _mm_setr_ps(m[0], m[1], m[2], 0.f);
+			const __m128 r1 = _mm_setr_ps(m[3], m[4], m[5], 0.f);
+			const __m128 r2 = _mm_setr_ps(m[6], m[7], m[8], 0.f);
+			alignas(16) float p[4];
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				__m128 v = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(normals[i].x), r0), _mm_mul_ps(_mm_set1_ps(normals[i].y), r1));
+				v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(normals[i].z), r2));
+				_mm_store_ps(p, v);
+				result[i].x = p[0];
+				result[i].y = p[1];
+				result[i].z = p[2];
+			}
+		}
+
+		VDTMATH_TARGET("sse2")
+		VDTMATH_API void normalize_sse2(vector3* vectors, const std::size_t count)
+		{
+			const __m128 one = _mm_set1_ps(1.f);
+			const __m128 zero = _mm_setzero_ps();
+			alignas(16) float x[4], y[4], z[4];
+			std::size_t i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				vector3* const v = vectors + i;
+				const __m128 vx = _mm_set_ps(v[3].x, v[2].x, v[1].x, v[0].x);
+				const __m128 vy = _mm_set_ps(v[3].y, v[2].y, v[1].y, v[0].y);
+				const __m128 vz = _mm_set_ps(v[3].z, v[2].z, v[1].z, v[0].z);
+				const __m128 magnitude = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz)));
+				const __m128 valid = _mm_cmpneq_ps(magnitude, zero);
+				// zero length lanes are multiplied by 1
+				const __m128 f = _mm_or_ps(_mm_and_ps(valid, _mm_div_ps(one, magnitude)), _mm_andnot_ps(valid, one));
+				_mm_store_ps(x, _mm_mul_ps(vx, f));
+				_mm_store_ps(y, _mm_mul_ps(vy, f));
+				_mm_store_ps(z, _mm_mul_ps(vz, f));
+				for (unsigned int lane = 0; lane < 4; ++lane)
+				{
+					v[lane].x = x[lane];
+					v[lane].y = y[lane];
+					v[lane].z = z[lane];
+				}
+			}
+			for (; i < count; ++i)
+			{
+				vectors[i].normalize();
+			}
+		}
+
+		template <bool Aligned>
+		VDTMATH_TARGET("sse2")
+		inline unsigned int cull_block_sse2(const vector4* planes, const vector4* s)
+		{
+			__m128 cx = load_sse2<Aligned>(s[0].data);
+			__m128 cy = load_sse2<Aligned>(s[1].data);
+			__m128 cz = load_sse2<Aligned>(s[2].data);
+			__m128 r = load_sse2<Aligned>(s[3].data);
+			_MM_TRANSPOSE4_PS(cx, cy, cz, r);
+			const __m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), r);
+			__m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (unsigned int p = 0; p < 6; ++p)
+			{
+				__m128 d = _mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(planes[p].x)), _mm_mul_ps(cy, _mm_set1_ps(planes[p].y)));
+				d = _mm_add_ps(d, _mm_mul_ps(cz, _mm_set1_ps(planes[p].z)));
+				d = _mm_add_ps(d, _mm_set1_ps(planes[p].w));
+				visible = _mm_and_ps(visible, _mm_cmpge_ps(d, negativeRadius));
+			}
+			return static_cast<unsigned int>(_mm_movemask_ps(visible));
+		}
+
+		template <bool Aligned>
+		VDTMATH_TARGET("sse2")
+		inline std::size_t cull_spheres_loop_sse2(const vector4* planes, const vector4* spheres, const std::size_t count, std::uint8_t* mask)
+		{
+			std::size_t visible = 0;
+			std::size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const unsigned int bits = cull_block_sse2<Aligned>(planes, spheres + i) | (cull_block_sse2<Aligned>(planes, spheres + i + 4) << 4);
+				mask[i / 8] = static_cast<std::uint8_t>(bits);
+				visible += popcount8(bits);
+			}
+			if (i < count)
+			{
+				visible += scalar_kernels().cull_spheres(planes, spheres + i, count - i, mask + i / 8);
+			}
+			return visible;
+		}
+
+		VDTMATH_TARGET("sse2")
+		VDTMATH_API std::size_t cull_spheres_sse2(const vector4* planes, const vector4* spheres, const std::size_t count, std::uint8_t* mask)
+		{
+			return is_aligned(spheres, 16)
+				? cull_spheres_loop_sse2<true>(planes, spheres, count, mask)
+				: cull_spheres_loop_sse2<false>(planes, spheres, count, mask);
+		}
+
+		// batch tests of mask.h, two blocks of 4 lanes per mask byte
+
+		VDTMATH_TARGET("sse2")
+		inline unsigned int contains_points_block_sse2(const __m128 cx, const __m128 cy, const __m128 squaredRadius, const float* p)
+		{
+			// 4 packed points, deinterleaved
+			const __m128 a = _mm_loadu_ps(p);
+			const __m128 b = _mm_loadu_ps(p + 4);
+			const __m128 dx = _mm_sub_ps(cx, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+			const __m128 dy = _mm_sub_ps(cy, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+			const __m128 d = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+			return static_cast<unsigned int>(_mm_movemask_ps(_mm_cmple_ps(d, squaredRadius)));
+		}
+
+		VDTMATH_TARGET("sse2")
+		VDTMATH_API std::size_t circle_contains_points_sse2(const float* circle, const float* points, const std::size_t count, std::uint8_t* mask)
+		{
+			const __m128 cx = _mm_set1_ps(circle[0]);
+			const __m128 cy = _mm_set1_ps(circle[1]);
+			const __m128 squaredRadius = _mm_set1_ps(circle[2] * circle[2]);
+			std::size_t hits = 0;
+			std::size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const float* const p = points + i * 2;
+				const unsigned int bits = contains_points_block_sse2(cx, cy, squaredRadius, p) | (contains_points_block_sse2(cx, cy, squaredRadius, p + 8) << 4);
+				mask[i / 8] = static_cast<std::uint8_t>(bits);
+				hits += popcount8(bits);
+			}
+			if (i < count)
+			{
+				hits += scalar_kernels().circle_contains_points(circle, points + i * 2, count - i, mask + i / 8);
+			}
+			return hits;
+		}
+
+		template <bool Contains>
+		VDTMATH_TARGET("sse2")
+		inline unsigned int circles_block_sse2(const float* circle, const float* c)
+		{
+			const __m128 x = _mm_setr_ps(c[0], c[3], c[6], c[9]);
+			const __m128 y = _mm_setr_ps(c[1], c[4], c[7], c[10]);
+			const __m128 r = _mm_setr_ps(c[2], c[5], c[8], c[11]);
+			const __m128 radius = _mm_set1_ps(circle[2]);
+			const __m128 dx = _mm_sub_ps(_mm_set1_ps(circle[0]), x);
+			const __m128 dy = _mm_sub_ps(_mm_set1_ps(circle[1]), y);
+			const __m128 d = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+			if (Contains)
+			{
+				return static_cast<unsigned int>(_mm_movemask_ps(_mm_and_ps(_mm_cmple_ps(d, _mm_mul_ps(radius, radius)), _mm_cmple_ps(r, radius))));
+			}
+			const __m128 sum = _mm_add_ps(radius, r);
+			return static_cast<unsigned int>(_mm_movemask_ps(_mm_cmple_ps(d, _mm_mul_ps(sum, sum))));
+		}
+
+		template <bool Contains>
+		VDTMATH_TARGET("sse2")
+		inline std::size_t circles_loop_sse2(const float* circle, const float* circles, const std::size_t count, std::uint8_t* mask)
+		{
+			std::size_t hits = 0;
+			std::size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const float* const c = circles + i * 3;
+				const unsigned int bits = circles_block_sse2<Contains>(circle, c) | (circles_block_sse2<Contains>(circle, c + 12) << 4);
+				mask[i / 8] = static_cast<std::uint8_t>(bits);
+				hits += popcount8(bits);
+			}
+			if (i < count)
+			{
+				hits += Contains
+					? scalar_kernels().circle_contains_circles(circle, circles + i * 3, count - i, mask + i / 8)
+					: scalar_kernels().circle_intersects_circles(circle, circles + i * 3, count - i, mask + i / 8);
+			}
+			return hits;
+		}
+
+		VDTMATH_TARGET("sse2")
+		VDTMATH_API std::size_t circle_contains_circles_sse2(const float* circle, const float* circles, const std::size_t count, std::uint8_t* mask)
+		{
+			return circles_loop_sse2<true>(circle, circles, count, mask);
+		}
+
+		VDTMATH_TARGET("sse2")
+		VDTMATH_API std::size_t circle_intersects_circles_sse2(const float* circle, const float* circles, const std::size_t count, std::uint8_t* mask)
+		{
+			return circles_loop_sse2<false>(circle, circles, count, mask);
+		}
+
+		VDTMATH_TARGET("sse2")
+		inline unsigned int overlap_block_sse2(const __m128 minX, const __m128 minY, const __m128 maxX, const __m128 maxY,
+			const float* x0, const float* y0, const float* x1, const float* y1)
+		{
+			__m128 overlap = _mm_cmple_ps(_mm_loadu_ps(x0), maxX);
+			overlap = _mm_and_ps(overlap, _mm_cmpge_ps(_mm_loadu_ps(x1), minX));
+			overlap = _mm_and_ps(overlap, _mm_cmple_ps(_mm_loadu_ps(y0), maxY));
+			overlap = _mm_and_ps(overlap, _mm_cmpge_ps(_mm_loadu_ps(y1), minY));
+			return static_cast<unsigned int>(_mm_movemask_ps(overlap));
+		}
+
+		VDTMATH_TARGET("sse2")
+		VDTMATH_API std::size_t overlap_boxes_sse2(const float* box, const float* min_x, const float* min_y, const float* max_x, const float* max_y, const std::size_t count, std::uint8_t* mask)
+		{
+			const __m128 minX = _mm_set1_ps(box[0]);
+			const __m128 minY = _mm_set1_ps(box[1]);
+			const __m128 maxX = _mm_set1_ps(box[2]);
+			const __m128 maxY = _mm_set1_ps(box[3]);
+			std::size_t hits = 0;
+			std::size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const unsigned int bits = overlap_block_sse2(minX, minY, maxX, maxY, min_x + i, min_y + i, max_x + i, max_y + i)
+					| (overlap_block_sse2(minX, minY, maxX, maxY, min_x + i + 4, min_y + i + 4, max_x + i + 4, max_y + i + 4) << 4);
+				mask[i / 8] = static_cast<std::uint8_t>(bits);
+				hits += popcount8(bits);
+			}
+			if (i < count)
+			{
+				hits += scalar_kernels().overlap_boxes(box, min_x + i, min_y + i, max_x + i, max_y + i, count - i, mask + i / 8);
+			}
+			return hits;
+		}
+
+		// half floats, the bit manipulations of to_half and from_half on 4 lanes
+
+		VDTMATH_TARGET("sse2")
+		inline __m128i select_sse2(const __m128i mask, const __m128i a, const __m128i b)
+		{
+			return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+		}
+
+		VDTMATH_TARGET("sse2")
+		VDTMATH_API void encode_half_sse2(const float* values, std::uint16_t* result, const std::size_t count)
+		{
+			const __m128i magic = _mm_set1_epi32(0x3f000000);
+			std::size_t i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128i f = _mm_castps_si128(_mm_loadu_ps(values + i));
+				const __m128i sign = _mm_and_si128(f, _mm_set1_epi32(static_cast<int>(0x80000000u)));
+				f = _mm_xor_si128(f, sign);
+
+				const __m128i nan = _mm_cmpgt_epi32(f, _mm_set1_epi32(0x7f800000));
+				const __m128i large = _mm_or_si128(_mm_set1_epi32(0x7c00), _mm_and_si128(nan, _mm_set1_epi32(0x0200)));
+				const __m128i small = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(f), _mm_castsi128_ps(magic))), magic);
+				const __m128i odd = _mm_and_si128(_mm_srli_epi32(f, 13), _mm_set1_epi32(1));
+				const __m128i normal = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(f, _mm_set1_epi32(static_cast<int>(0xc8000fffu))), odd), 13);
+
+				__m128i h = select_sse2(_mm_cmplt_epi32(f, _mm_set1_epi32(0x38800000)), small, normal);
+				h = select_sse2(_mm_cmpgt_epi32(f, _mm_set1_epi32(0x477fffff)), large, h);
+				h = _mm_or_si128(h, _mm_srli_epi32(sign, 16));
+				// sign extended so that the signed pack keeps the 16 bits
+				h = _mm_srai_epi32(_mm_slli_epi32(h, 16), 16);
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(result + i), _mm_packs_epi32(h, h));
+			}
+			if (i < count)
+			{
+				scalar_kernels().encode_half(values + i, result + i, count - i);
+			}
+		}
+
+		VDTMATH_TARGET("sse2")
+		VDTMATH_API void decode_half_sse2(const std::uint16_t* values, float* result, const std::size_t count)
+		{
+			const __m128i exponentMask = _mm_set1_epi32(0x0f800000);
+			const __m128i bias = _mm_set1_epi32(0x38000000);
+			std::size_t i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				const __m128i h = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(values + i)), _mm_setzero_si128());
+				__m128i f = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x7fff)), 13);
+				const __m128i exponent = _mm_and_si128(f, exponentMask);
+				f = _mm_add_epi32(f, bias);
+
+				// infinity or NaN, NaN made canonical
+				const __m128i special = _mm_cmpeq_epi32(exponent, exponentMask);
+				const __m128i nan = _mm_andnot_si128(_mm_cmpeq_epi32(_mm_and_si128(h, _mm_set1_epi32(0x03ff)), _mm_setzero_si128()), special);
+				f = _mm_add_epi32(f, _mm_and_si128(special, bias));
+				f = select_sse2(nan, _mm_set1_epi32(0x7fc00000), f);
+				// subnormal or zero
+				const __m128i subnormal = _mm_castps_si128(_mm_sub_ps(
+					_mm_castsi128_ps(_mm_add_epi32(f, _mm_set1_epi32(0x00800000))),
+					_mm_castsi128_ps(_mm_set1_epi32(0x38800000))));
+				f = select_sse2(_mm_cmpeq_epi32(exponent, _mm_setzero_si128()), subnormal, f);
+
+				f = _mm_or_si128(f, _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16));
+				_mm_storeu_ps(result + i, _mm_castsi128_ps(f));
+			}
+			if (i < count)
+			{
+				scalar_kernels().decode_half(values + i, result + i, count - i);
+			}
+		}
+
+		VDTMATH_TARGET("sse2")
+		VDTMATH_API void evaluate_hermite_sse2(const float* u, const float* p0, const float* m0, const float* p1, const float* m1, float* result, const std::size_t count)
+		{
+			const __m128 one = _mm_set1_ps(1.f);
+			const __m128 two = _mm_set1_ps(2.f);
+			const __m128 three = _mm_set1_ps(3.f);
+			std::size_t i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				const __m128 s = _mm_loadu_ps(u + i);
+				const __m128 s2 = _mm_mul_ps(s, s);
+				const __m128 s3 = _mm_mul_ps(s2, s);
+				// the basis functions of scalar kernel, in the same order
+				const __m128 h00 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(two, s3), _mm_mul_ps(three, s2)), one);
+				const __m128 h10 = _mm_add_ps(_mm_sub_ps(s3, _mm_mul_ps(two, s2)), s);
+				const __m128 h01 = _mm_sub_ps(_mm_mul_ps(three, s2), _mm_mul_ps(two, s3));
+				const __m128 h11 = _mm_sub_ps(s3, s2);
+				__m128 r = _mm_add_ps(_mm_mul_ps(h00, _mm_loadu_ps(p0 + i)), _mm_mul_ps(h10, _mm_loadu_ps(m0 + i)));
+				r = _mm_add_ps(r, _mm_mul_ps(h01, _mm_loadu_ps(p1 + i)));
+				r = _mm_add_ps(r, _mm_mul_ps(h11, _mm_loadu_ps(m1 + i)));
+				_mm_storeu_ps(result + i, r);
+			}
+			if (i < count)
+			{
+				scalar_kernels().evaluate_hermite(u + i, p0 + i, m0 + i, p1 + i, m1 + i, result + i, count - i);
+			}
+		}
+
+		// avx2, fma
+
+		template <bool Aligned>
+		VDTMATH_TARGET("avx2,fma")
+		inline void multiply_rows_avx2(const float* a, const __m256 b0, const __m256 b1, const __m256 b2, const __m256 b3, float* result)
+		{
+			// two rows per register, each lane broadcasts its own row element
+			const __m256 a01 = Aligned ? _mm256_load_ps(a) : _mm256_loadu_ps(a);
+			const __m256 a23 = Aligned ? _mm256_load_ps(a + 8) : _mm256_loadu_ps(a + 8);
+			__m256 r01 = _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0x00), b0);
+			__m256 r23 = _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0x00), b0);
+			r01 = _mm256_fmadd_ps(_mm256_shuffle_ps(a01, a01, 0x55), b1, r01);
+			r23 = _mm256_fmadd_ps(_mm256_shuffle_ps(a23, a23, 0x55), b1, r23);
+			r01 = _mm256_fmadd_ps(_mm256_shuffle_ps(a01, a01, 0xaa), b2, r01);
+			r23 = _mm256_fmadd_ps(_mm256_shuffle_ps(a23, a23, 0xaa), b2, r23);
+			r01 = _mm256_fmadd_ps(_mm256_shuffle_ps(a01, a01, 0xff), b3, r01);
+			r23 = _mm256_fmadd_ps(_mm256_shuffle_ps(a23, a23, 0xff), b3, r23);
+			if (Aligned)
+			{
+				_mm256_store_ps(result, r01);
+				_mm256_store_ps(result + 8, r23);
+			}
+			else
+			{
+				_mm256_storeu_ps(result, r01);
+				_mm256_storeu_ps(result + 8, r23);
+			}
+		}
+
+		VDTMATH_TARGET("avx2,fma")
+		inline __m256 broadcast_row(const float* row)
+		{
+			return _mm256_broadcast_ps(reinterpret_cast<const __m128*>(row));
+		}
+
+		template <bool Aligned>
+		VDTMATH_TARGET("avx2,fma")
+		inline void multiply_loop_avx2(const matrix4* a, const matrix4* b, matrix4* result, const std::size_t count)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const float* const m = b[i].data;
+				multiply_rows_avx2<Aligned>(a[i].data, broadcast_row(m), broadcast_row(m + 4), broadcast_row(m + 8), broadcast_row(m + 12), result[i].data);
+			}
+		}
+
+		VDTMATH_TARGET("avx2,fma")
+		VDTMATH_API void multiply_avx2(const matrix4* a, const matrix4* b, matrix4* result, const std::size_t count)
+		{
+			// b is read by broadcasts, that have no alignment requirement
+			if (is_aligned(a, 32) && is_aligned(result, 32)) multiply_loop_avx2<true>(a, b, result, count);
+			else multiply_loop_avx2<false>(a, b, result, count);
+		}
+
+		VDTMATH_TARGET("avx2,fma")
+		VDTMATH_API void multiply_one_avx2(const matrix4& matrix, const matrix4* b, matrix4* result, const std::size_t count)
+		{
+			alignas(64) float a[16];
+			for (unsigned int i = 0; i < 16; ++i) a[i] = matrix.data[i];
+			if (is_aligned(result, 32))
+			{
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					const float* const m = b[i].data;
+					multiply_rows_avx2<true>(a, broadcast_row(m), broadcast_row(m + 4), broadcast_row(m + 8), broadcast_row(m + 12), result[i].data);
+				}
+				return;
+			}
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const float* const m = b[i].data;
+				multiply_rows_avx2<false>(a, broadcast_row(m), broadcast_row(m + 4), broadcast_row(m + 8), broadcast_row(m + 12), result[i].data);
+			}
+		}
+
+		VDTMATH_TARGET("avx2,fma")
+		VDTMATH_API void transform_points_avx2(const matrix4& matrix, const vector3* points, vector3* result, const std::size_t count)
+		{
+			// two points per register
+			const __m256 r0 = broadcast_row(matrix.data);
+			const __m256 r1 = broadcast_row(matrix.data + 4);
+			const __m256 r2 = broadcast_row(matrix.data + 8);
+			const __m256 r3 = broadcast_row(matrix.data + 12);
+			alignas(32) float p[8];
+			std::size_t i = 0;
+			for (; i + 2 <= count; i += 2)
+			{
+				const vector3* const v = points + i;
+				const __m256 x = _mm256_set_m128(_mm_set1_ps(v[1].x), _mm_set1_ps(v[0].x));
+				const __m256 y = _mm256_set_m128(_mm_set1_ps(v[1].y), _mm_set1_ps(v[0].y));
+				const __m256 z = _mm256_set_m128(_mm_set1_ps(v[1].z), _mm_set1_ps(v[0].z));
+				const __m256 t = _mm256_fmadd_ps(z, r2, _mm256_fmadd_ps(y, r1, _mm256_fmadd_ps(x, r0, r3)));
+				_mm256_store_ps(p, t);
+				result[i].x = p[0];
+				result[i].y = p[1];
+				result[i].z = p[2];
+				result[i + 1].x = p[4];
+				result[i + 1].y = p[5];
+				result[i + 1].z = p[6];
+			}
+			if (i < count)
+			{
+				transform_points_sse2(matrix, points + i, result + i, count - i);
+			}
+		}
+
+		VDTMATH_TARGET("avx2,fma")
+		VDTMATH_API void project_points_avx2(const matrix4& matrix, const vector3* points, vector3* result, const std::size_t count)
+		{
+			// two points per register
+			const __m256 r0 = broadcast_row(matrix.data);
+			const __m256 r1 = broadcast_row(matrix.data + 4);
+			const __m256 r2 = broadcast_row(matrix.data + 8);
+			const __m256 r3 = broadcast_row(matrix.data + 12);
+			const __m256 one = _mm256_set1_ps(1.f);
+			alignas(32) float p[8];
+			std::size_t i = 0;
+			for (; i + 2 <= count; i += 2)
+			{
+				const vector3* const v = points + i;
+				const __m256 x = _mm256_set_m128(_mm_set1_ps(v[1].x), _mm_set1_ps(v[0].x));
+				const __m256 y = _mm256_set_m128(_mm_set1_ps(v[1].y), _mm_set1_ps(v[0].y));
+				const __m256 z = _mm256_set_m128(_mm_set1_ps(v[1].z), _mm_set1_ps(v[0].z));
+				__m256 t = _mm256_fmadd_ps(z, r2, _mm256_fmadd_ps(y, r1, _mm256_fmadd_ps(x, r0, r3)));
+				t = _mm256_mul_ps(t, _mm256_div_ps(one, _mm256_permute_ps(t, _MM_SHUFFLE(3, 3, 3, 3))));
+				_mm256_store_ps(p, t);
+				result[i].x = p[0];
+				result[i].y = p[1];
+				result[i].z = p[2];
+				result[i + 1].x = p[4];
+				result[i + 1].y = p[5];
+				result[i + 1].z = p[6];
+			}
+			if (i < count)
+			{
+				project_points_sse2(matrix, points + i, result + i, count - i);
+			}
+		}
+
+		template <bool Aligned>
+		VDTMATH_TARGET("avx2,fma")
+		inline void pose_loop_avx2(const trs* locals, const std::int32_t* parents, const matrix4* inverse_bind, const float* root, matrix4* model, matrix4* palette, const std::size_t count)
+		{
+			// the parent rows are read by broadcasts
+			alignas(64) matrix4 local;
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				local = compose(locals[i]);
+				const float* const m = parents[i] < 0 ? root : model[parents[i]].data;
+				multiply_rows_avx2<Aligned>(local.data, broadcast_row(m), broadcast_row(m + 4), broadcast_row(m + 8), broadcast_row(m + 12), model[i].data);
+				if (palette)
+				{
+					const float* const p = model[i].data;
+					multiply_rows_avx2<Aligned>(inverse_bind[i].data, broadcast_row(p), broadcast_row(p + 4), broadcast_row(p + 8), broadcast_row(p + 12), palette[i].data);
+				}
+			}
+		}
+
+		VDTMATH_TARGET("avx2,fma")
+		VDTMATH_API void pose_matrices_avx2(const trs* locals, const std::int32_t* parents, const matrix4* inverse_bind, const matrix4& root, matrix4* model, matrix4* palette, const std::size_t count)
+		{
+			alignas(64) float r[16];
+			for (unsigned int i = 0; i < 16; ++i) r[i] = root.data[i];
+			if (are_aligned(inverse_bind, model, palette, 32)) pose_loop_avx2<true>(locals, parents, inverse_bind, r, model, palette, count);
+			else pose_loop_avx2<false>(locals, parents, inverse_bind, r, model, palette, count);
+		}
+
+		VDTMATH_TARGET("avx2,fma")
+		VDTMATH_API void multiply_affine_avx2(const affine3* a, const affine3* b, affine3* result, const std::size_t count)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const float* const m = a[i].data;
+				const __m128 a0 = _mm_loadu_ps(m);
+				const __m128 a1 = _mm_loadu_ps(m + 4);
+				const __m128 a2 = _mm_loadu_ps(m + 8);
+				__m128 rows[3];
+				for (unsigned int row = 0; row < 3; ++row)
+				{
+					const float* const r = b[i].data + row * 4;
+					const __m128 t = _mm_setr_ps(0.f, 0.f, 0.f, r[3]);
+					rows[row] = _mm_fmadd_ps(_mm_set1_ps(r[2]), a2, _mm_fmadd_ps(_mm_set1_ps(r[1]), a1, _mm_fmadd_ps(_mm_set1_ps(r[0]), a0, t)));
+				}
+				float* const out = result[i].data;
+				_mm_storeu_ps(out, rows[0]);
+				_mm_storeu_ps(out + 4, rows[1]);
+				_mm_storeu_ps(out + 8, rows[2]);
+			}
+		}
+
+		VDTMATH_TARGET("avx2,fma")
+		VDTMATH_API void transform_points_affine_avx2(const affine3& affine, const vector3* points, vector3* result, const std::size_t count)
+		{
+			// eight points per register, one coordinate per register
+			const __m256i index = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(vector3_stride));
+			__m256 m[12];
+			for (unsigned int k = 0; k < 12; ++k) m[k] = _mm256_set1_ps(affine.data[k]);
+			alignas(32) float x[8], y[8], z[8];
+			std::size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const vector3* const v = points + i;
+				const __m256 vx = _mm256_i32gather_ps(&v[0].x, index, 4);
+				const __m256 vy = _mm256_i32gather_ps(&v[0].y, index, 4);
+				const __m256 vz = _mm256_i32gather_ps(&v[0].z, index, 4);
+				_mm256_store_ps(x, _mm256_fmadd_ps(vz, m[2], _mm256_fmadd_ps(vy, m[1], _mm256_fmadd_ps(vx, m[0], m[3]))));
+				_mm256_store_ps(y, _mm256_fmadd_ps(vz, m[6], _mm256_fmadd_ps(vy, m[5], _mm256_fmadd_ps(vx, m[4], m[7]))));
+				_mm256_store_ps(z, _mm256_fmadd_ps(vz, m[10], _mm256_fmadd_ps(vy, m[9], _mm256_fmadd_ps(vx, m[8], m[11]))));
+				vector3* const r = result + i;
+				for (unsigned int lane = 0; lane < 8; ++lane)
+				{
+					r[lane].x = x[lane];
+					r[lane].y = y[lane];
+					r[lane].z = z[lane];
+				}
+			}
+			if (i < count)
+			{
+				transform_points_affine_sse2(affine, points + i, result + i, count - i);
+			}
+		}
+
+		VDTMATH_TARGET("avx2,fma")
+		VDTMATH_API void transform_normals_avx2(const matrix3& matrix, const vector3* normals, vector3* result, const std::size_t count)
+		{
+			// eight normals per register, one coordinate per register
+			const __m256i index = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(vector3_stride));
+			__m256 m[9];
+			for (unsigned int k = 0; k < 9; ++k) m[k] = _mm256_set1_ps(matrix.data[k]);
+			alignas(32) float x[8], y[8], z[8];
+			std::size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const vector3* const v = normals + i;
+				const __m256 vx = _mm256_i32gather_ps(&v[0].x, index, 4);
+				const __m256 vy = _mm256_i32gather_ps(&v[0].y, index, 4);
+				const __m256 vz = _mm256_i32gather_ps(&v[0].z, index, 4);
+				_mm256_store_ps(x, _mm256_fmadd_ps(vz, m[6], _mm256_fmadd_ps(vy, m[3], _mm256_mul_ps(vx, m[0]))));
+				_mm256_store_ps(y, _mm256_fmadd_ps(vz, m[7], _mm256_fmadd_ps(vy, m[4], _mm256_mul_ps(vx, m[1]))));
+				_mm256_store_ps(z, _mm256_fmadd_ps(vz, m[8], _mm256_fmadd_ps(vy, m[5], _mm256_mul_ps(vx, m[2]))));
+				vector3* const r = result + i;
+				for (unsigned int lane = 0; lane < 8; ++lane)
+				{
+					r[lane].x = x[lane];
+					r[lane].y = y[lane];
+					r[lane].z = z[lane];
+				}
+			}
+			if (i < count)
+			{
+				transform_normals_sse2(matrix, normals + i, result + i, count - i);
+			}
+		}
+
+		VDTMATH_TARGET("avx2,fma")
+		VDTMATH_API void normalize_avx2(vector3* vectors, const std::size_t count)
+		{
+			const __m256i index = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(vector3_stride));
+			const __m256 one = _mm256_set1_ps(1.f);
+			const __m256 zero = _mm256_setzero_ps();
+			alignas(32) float x[8], y[8], z[8];
+			std::size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				vector3* const v = vectors + i;
+				const __m256 vx = _mm256_i32gather_ps(&v[0].x, index, 4);
+				const __m256 vy = _mm256_i32gather_ps(&v[0].y, index, 4);
+				const __m256 vz = _mm256_i32gather_ps(&v[0].z, index, 4);
+				const __m256 magnitude = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)), _mm256_mul_ps(vz, vz)));
+				const __m256 valid = _mm256_cmp_ps(magnitude, zero, _CMP_NEQ_UQ);
+				// zero length lanes are multiplied by 1
+				const __m256 f = _mm256_blendv_ps(one, _mm256_div_ps(one, magnitude), valid);
+				_mm256_store_ps(x, _mm256_mul_ps(vx, f));
+				_mm256_store_ps(y, _mm256_mul_ps(vy, f));
+				_mm256_store_ps(z, _mm256_mul_ps(vz, f));
+				for (unsigned int lane = 0; lane < 8; ++lane)
+				{
+					v[lane].x = x[lane];
+					v[lane].y = y[lane];
+					v[lane].z = z[lane];
+				}
+			}
+			if (i < count)
+			{
+				normalize_sse2(vectors + i, count - i);
+			}
+		}
+
+		VDTMATH_TARGET("avx2,fma")
+		VDTMATH_API std::size_t cull_spheres_avx2(const vector4* planes, const vector4* spheres, const std::size_t count, std::uint8_t* mask)
+		{
+			const __m256i index = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(vector4_stride));
+			std::size_t visible = 0;
+			std::size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const vector4* const s = spheres + i;
+				const __m256 cx = _mm256_i32gather_ps(&s[0].x, index, 4);
+				const __m256 cy = _mm256_i32gather_ps(&s[0].y, index, 4);
+				const __m256 cz = _mm256_i32gather_ps(&s[0].z, index, 4);
+				const __m256 negativeRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_i32gather_ps(&s[0].w, index, 4));
+				__m256 result = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+				for (unsigned int p = 0; p < 6; ++p)
+				{
+					__m256 d = _mm256_add_ps(_mm256_mul_ps(cx, _mm256_set1_ps(planes[p].x)), _mm256_mul_ps(cy, _mm256_set1_ps(planes[p].y)));
+					d = _mm256_add_ps(d, _mm256_mul_ps(cz, _mm256_set1_ps(planes[p].z)));
+					d = _mm256_add_ps(d, _mm256_set1_ps(planes[p].w));
+					result = _mm256_and_ps(result, _mm256_cmp_ps(d, negativeRadius, _CMP_GE_OQ));
+				}
+				const unsigned int bits = static_cast<unsigned int>(_mm256_movemask_ps(result));
+				mask[i / 8] = static_cast<std::uint8_t>(bits);
+				visible += popcount8(bits);
+			}
+			if (i < count)
+			{
+				visible += scalar_kernels().cull_spheres(planes, spheres + i, count - i, mask + i / 8);
+			}
+			return visible;
+		}
+
+		// batch tests of mask.h, one mask byte per compare
+
+		VDTMATH_TARGET("avx2,fma")
+		VDTMATH_API std::size_t circle_contains_points_avx2(const float* circle, const float* points, const std::size_t count, std::uint8_t* mask)
+		{
+			const __m256 cx = _mm256_set1_ps(circle[0]);
+			const __m256 cy = _mm256_set1_ps(circle[1]);
+			const __m256 squaredRadius = _mm256_set1_ps(circle[2] * circle[2]);
+			std::size_t hits = 0;
+			std::size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				// 8 packed points, the shuffles deinterleave them
+				// per 128 bit lane, the permutes restore the order
+				const __m256 a = _mm256_loadu_ps(points + i * 2);
+				const __m256 b = _mm256_loadu_ps(points + i * 2 + 8);
+				const __m256 x = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0))), _MM_SHUFFLE(3, 1, 2, 0)));
+				const __m256 y = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1))), _MM_SHUFFLE(3, 1, 2, 0)));
+				const __m256 dx = _mm256_sub_ps(cx, x);
+				const __m256 dy = _mm256_sub_ps(cy, y);
+				const __m256 d = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+				const unsigned int bits = static_cast<unsigned int>(_mm256_movemask_ps(_mm256_cmp_ps(d, squaredRadius, _CMP_LE_OQ)));
+				mask[i / 8] = static_cast<std::uint8_t>(bits);
+				hits += popcount8(bits);
+			}
+			if (i < count)
+			{
+				hits += scalar_kernels().circle_contains_points(circle, points + i * 2, count - i, mask + i / 8);
+			}
+			return hits;
+		}
+
+		template <bool Contains>
+		VDTMATH_TARGET("avx2,fma")
+		inline std::size_t circles_loop_avx2(const float* circle, const float* circles, const std::size_t count, std::uint8_t* mask)
+		{
+			const __m256i index = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+			const __m256 cx = _mm256_set1_ps(circle[0]);
+			const __m256 cy = _mm256_set1_ps(circle[1]);
+			const __m256 radius = _mm256_set1_ps(circle[2]);
+			std::size_t hits = 0;
+			std::size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const float* const c = circles + i * 3;
+				const __m256 dx = _mm256_sub_ps(cx, _mm256_i32gather_ps(c, index, 4));
+				const __m256 dy = _mm256_sub_ps(cy, _mm256_i32gather_ps(c + 1, index, 4));
+				const __m256 r = _mm256_i32gather_ps(c + 2, index, 4);
+				const __m256 d = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+				__m256 result;
+				if (Contains)
+				{
+					result = _mm256_and_ps(_mm256_cmp_ps(d, _mm256_mul_ps(radius, radius), _CMP_LE_OQ), _mm256_cmp_ps(r, radius, _CMP_LE_OQ));
+				}
+				else
+				{
+					const __m256 sum = _mm256_add_ps(radius, r);
+					result = _mm256_cmp_ps(d, _mm256_mul_ps(sum, sum), _CMP_LE_OQ);
+				}
+				const unsigned int bits = static_cast<unsigned int>(_mm256_movemask_ps(result));
+				mask[i / 8] = static_cast<std::uint8_t>(bits);
+				hits += popcount8(bits);
+			}
+			if (i < count)
+			{
+				hits += Contains
+					? scalar_kernels().circle_contains_circles(circle, circles + i * 3, count - i, mask + i / 8)
+					: scalar_kernels().circle_intersects_circles(circle, circles + i * 3, count - i, mask + i / 8);
+			}
+			return hits;
+		}
+
+		VDTMATH_TARGET("avx2,fma")
+		VDTMATH_API std::size_t circle_contains_circles_avx2(const float* circle, const float* circles, const std::size_t count, std::uint8_t* mask)
+		{
+			return circles_loop_avx2<true>(circle, circles, count, mask);
+		}
+
+		VDTMATH_TARGET("avx2,fma")
+		VDTMATH_API std::size_t circle_intersects_circles_avx2(const float* circle, const float* circles, const std::size_t count, std::uint8_t* mask)
+		{
+			return circles_loop_avx2<false>(circle, circles, count, mask);
+		}
+
+		VDTMATH_TARGET("avx2,fma")
+		VDTMATH_API std::size_t overlap_boxes_avx2(const float* box, const float* min_x, const float* min_y, const float* max_x, const float* max_y, const std::size_t count, std::uint8_t* mask)
+		{
+			const __m256 minX = _mm256_set1_ps(box[0]);
+			const __m256 minY = _mm256_set1_ps(box[1]);
+			const __m256 maxX = _mm256_set1_ps(box[2]);
+			const __m256 maxY = _mm256_set1_ps(box[3]);
+			std::size_t hits = 0;
+			std::size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				__m256 overlap = _mm256_cmp_ps(_mm256_loadu_ps(min_x + i), maxX, _CMP_LE_OQ);
+				overlap = _mm256_and_ps(overlap, _mm256_cmp_ps(_mm256_loadu_ps(max_x + i), minX, _CMP_GE_OQ));
+				overlap = _mm256_and_ps(overlap, _mm256_cmp_ps(_mm256_loadu_ps(min_y + i), maxY, _CMP_LE_OQ));
+				overlap = _mm256_and_ps(overlap, _mm256_cmp_ps(_mm256_loadu_ps(max_y + i), minY, _CMP_GE_OQ));
+				const unsigned int bits = static_cast<unsigned int>(_mm256_movemask_ps(overlap));
+				mask[i / 8] = static_cast<std::uint8_t>(bits);
+				hits += popcount8(bits);
+			}
+			if (i < count)
+			{
+				hits += scalar_kernels().overlap_boxes(box, min_x + i, min_y + i, max_x + i, max_y + i, count - i, mask + i / 8);
+			}
+			return hits;
+		}
+
+		// half floats with the f16c conversions, which keep the NaN
+		// payloads, the NaN lanes are made canonical as by to_half and from_half
+
+		VDTMATH_TARGET("avx2,fma")
+		inline __m256 canonical_nan_avx2(const __m256 value)
+		{
+			const __m256 nan = _mm256_or_ps(_mm256_and_ps(value, _mm256_set1_ps(-0.f)), _mm256_castsi256_ps(_mm256_set1_epi32(0x7fc00000)));
+			return _mm256_blendv_ps(value, nan, _mm256_cmp_ps(value, value, _CMP_UNORD_Q));
+		}
+
+		VDTMATH_TARGET("avx2,fma,f16c")
+		VDTMATH_API void encode_half_avx2(const float* values, std::uint16_t* result, const std::size_t count)
+		{
+			std::size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				// the quiet NaN without payload converts to 0x7e00
+				const __m128i h = _mm256_cvtps_ph(canonical_nan_avx2(_mm256_loadu_ps(values + i)), _MM_FROUND_TO_NEAREST_INT);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(result + i), h);
+			}
+			if (i < count)
+			{
+				encode_half_sse2(values + i, result + i, count - i);
+			}
+		}
+
+		VDTMATH_TARGET("avx2,fma,f16c")
+		VDTMATH_API void decode_half_avx2(const std::uint16_t* values, float* result, const std::size_t count)
+		{
+			std::size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+				_mm256_storeu_ps(result + i, canonical_nan_avx2(_mm256_cvtph_ps(h)));
+			}
+			if (i < count)
+			{
+				decode_half_sse2(values + i, result + i, count - i);
+			}
+		}
+
+		// round half away from zero and convert, as detail::round_to_int
+		VDTMATH_TARGET("avx2,fma")
+		inline __m256i round_to_int_avx2(const __m256 value)
+		{
+			const __m256 half = _mm256_or_ps(_mm256_and_ps(value, _mm256_set1_ps(-0.f)), _mm256_set1_ps(.5f));
+			return _mm256_cvttps_epi32(_mm256_add_ps(value, half));
+		}
+
+		VDTMATH_TARGET("avx2,fma")
+		VDTMATH_API void encode_octahedral_avx2(const vector3* normals, std::uint32_t* result, const std::size_t count)
+		{
+			// eight normals per register, one coordinate per register
+			const __m256i index = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(vector3_stride));
+			const __m256 signMask = _mm256_set1_ps(-0.f);
+			const __m256 one = _mm256_set1_ps(1.f);
+			const __m256 zero = _mm256_setzero_ps();
+			const __m256 scale = _mm256_set1_ps(32767.f);
+			std::size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const vector3* const n = normals + i;
+				const __m256 x = _mm256_i32gather_ps(&n[0].x, index, 4);
+				const __m256 y = _mm256_i32gather_ps(&n[0].y, index, 4);
+				const __m256 z = _mm256_i32gather_ps(&n[0].z, index, 4);
+				const __m256 l = _mm256_add_ps(_mm256_add_ps(_mm256_andnot_ps(signMask, x), _mm256_andnot_ps(signMask, y)), _mm256_andnot_ps(signMask, z));
+				__m256 u = _mm256_div_ps(x, l);
+				__m256 v = _mm256_div_ps(y, l);
+
+				// the lower hemisphere is folded on the corners
+				const __m256 su = _mm256_blendv_ps(_mm256_set1_ps(-1.f), one, _mm256_cmp_ps(u, zero, _CMP_GE_OQ));
+				const __m256 sv = _mm256_blendv_ps(_mm256_set1_ps(-1.f), one, _mm256_cmp_ps(v, zero, _CMP_GE_OQ));
+				const __m256 fu = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_andnot_ps(signMask, v)), su);
+				const __m256 fv = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_andnot_ps(signMask, u)), sv);
+				const __m256 lower = _mm256_cmp_ps(z, zero, _CMP_LT_OQ);
+				u = _mm256_blendv_ps(u, fu, lower);
+				v = _mm256_blendv_ps(v, fv, lower);
+
+				const __m256i qu = round_to_int_avx2(_mm256_mul_ps(u, scale));
+				const __m256i qv = round_to_int_avx2(_mm256_mul_ps(v, scale));
+				const __m256i packed = _mm256_or_si256(_mm256_and_si256(qu, _mm256_set1_epi32(0xffff)), _mm256_slli_epi32(qv, 16));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(result + i), packed);
+			}
+			if (i < count)
+			{
+				scalar_kernels().encode_octahedral(normals + i, result + i, count - i);
+			}
+		}
+
+		VDTMATH_TARGET("avx2,fma")
+		VDTMATH_API void decode_octahedral_avx2(const std::uint32_t* values, vector3* result, const std::size_t count)
+		{
+			const __m256 signMask = _mm256_set1_ps(-0.f);
+			const __m256 one = _mm256_set1_ps(1.f);
+			const __m256 zero = _mm256_setzero_ps();
+			const __m256 scale = _mm256_set1_ps(32767.f);
+			alignas(32) float x[8], y[8], z[8];
+			std::size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const __m256i packed = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+				__m256 u = _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(packed, 16), 16)), scale);
+				__m256 v = _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(packed, 16)), scale);
+				const __m256 w = _mm256_sub_ps(_mm256_sub_ps(one, _mm256_andnot_ps(signMask, u)), _mm256_andnot_ps(signMask, v));
+
+				// unfold the corners of the lower hemisphere
+				const __m256 t = _mm256_max_ps(_mm256_sub_ps(zero, w), zero);
+				const __m256 negativeT = _mm256_sub_ps(zero, t);
+				u = _mm256_add_ps(u, _mm256_blendv_ps(t, negativeT, _mm256_cmp_ps(u, zero, _CMP_GE_OQ)));
+				v = _mm256_add_ps(v, _mm256_blendv_ps(t, negativeT, _mm256_cmp_ps(v, zero, _CMP_GE_OQ)));
+
+				const __m256 f = _mm256_div_ps(one, _mm256_sqrt_ps(_mm256_fmadd_ps(w, w, _mm256_fmadd_ps(v, v, _mm256_mul_ps(u, u)))));
+				_mm256_store_ps(x, _mm256_mul_ps(u, f));
+				_mm256_store_ps(y, _mm256_mul_ps(v, f));
+				_mm256_store_ps(z, _mm256_mul_ps(w, f));
+				vector3* const r = result + i;
+				for (unsigned int lane = 0; lane < 8; ++lane)
+				{
+					r[lane].x = x[lane];
+					r[lane].y = y[lane];
+					r[lane].z = z[lane];
+				}
+			}
+			if (i < count)
+			{
+				scalar_kernels().decode_octahedral(values + i, result + i, count - i);
+			}
+		}
+
+		VDTMATH_TARGET("avx2,fma")
+		VDTMATH_API void encode_positions_avx2(const position_quantizer& quantizer, const vector3* positions, packed_position* result, const std::size_t count)
+		{
+			const __m256i index = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(vector3_stride));
+			const __m256 zero = _mm256_setzero_ps();
+			const __m256 half = _mm256_set1_ps(.5f);
+			const __m256 maxCode = _mm256_set1_ps(quantizer.max_code);
+			__m256 min[3], inverseStep[3];
+			for (unsigned int k = 0; k < 3; ++k)
+			{
+				min[k] = _mm256_set1_ps(quantizer.min[k]);
+				inverseStep[k] = _mm256_set1_ps(quantizer.inverse_step[k]);
+			}
+			alignas(32) std::int32_t code[3][8];
+			std::size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const vector3* const p = positions + i;
+				for (unsigned int k = 0; k < 3; ++k)
+				{
+					const __m256 c = _mm256_i32gather_ps(p[0].data + k, index, 4);
+					__m256 value = _mm256_mul_ps(_mm256_sub_ps(c, min[k]), inverseStep[k]);
+					value = _mm256_min_ps(_mm256_max_ps(value, zero), maxCode);
+					_mm256_store_si256(reinterpret_cast<__m256i*>(code[k]), _mm256_cvttps_epi32(_mm256_add_ps(value, half)));
+				}
+				packed_position* const r = result + i;
+				for (unsigned int lane = 0; lane < 8; ++lane)
+				{
+					r[lane].x = static_cast<std::uint16_t>(code[0][lane]);
+					r[lane].y = static_cast<std::uint16_t>(code[1][lane]);
+					r[lane].z = static_cast<std::uint16_t>(code[2][lane]);
+				}
+			}
+			if (i < count)
+			{
+				scalar_kernels().encode_positions(quantizer, positions + i, result + i, count - i);
+			}
+		}
+
+		static_assert(sizeof(packed_position) == 6, "packed positions are gathered with a 6 bytes stride");
+
+		VDTMATH_TARGET("avx2,fma")
+		VDTMATH_API void decode_positions_avx2(const position_quantizer& quantizer, const packed_position* positions, vector3* result, const std::size_t count)
+		{
+			// 32 bit gathers of 16 bit codes, the last lane reads 2 bytes
+			// of the next element, so one more element must follow
+			const __m256i index = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(6));
+			const __m256i low = _mm256_set1_epi32(0xffff);
+			__m256 min[3], step[3];
+			for (unsigned int k = 0; k < 3; ++k)
+			{
+				min[k] = _mm256_set1_ps(quantizer.min[k]);
+				step[k] = _mm256_set1_ps(quantizer.step[k]);
+			}
+			alignas(32) float c[3][8];
+			std::size_t i = 0;
+			for (; i + 9 <= count; i += 8)
+			{
+				const int* const p = reinterpret_cast<const int*>(positions + i);
+				for (unsigned int k = 0; k < 3; ++k)
+				{
+					const __m256i code = _mm256_and_si256(_mm256_i32gather_epi32(reinterpret_cast<const int*>(reinterpret_cast<const char*>(p) + k * 2), index, 1), low);
+					_mm256_store_ps(c[k], _mm256_fmadd_ps(_mm256_cvtepi32_ps(code), step[k], min[k]));
+				}
+				vector3* const r = result + i;
+				for (unsigned int lane = 0; lane < 8; ++lane)
+				{
+					r[lane].x = c[0][lane];
+					r[lane].y = c[1][lane];
+					r[lane].z = c[2][lane];
+				}
+			}
+			if (i < count)
+			{
+				scalar_kernels().decode_positions(quantizer, positions + i, result + i, count - i);
+			}
+		}
+
+		VDTMATH_TARGET("avx2,fma")
+		VDTMATH_API void evaluate_hermite_avx2(const float* u, const float* p0, const float* m0, const float* p1, const float* m1, float* result, const std::size_t count)
+		{
+			const __m256 one = _mm256_set1_ps(1.f);
+			const __m256 two = _mm256_set1_ps(2.f);
+			const __m256 three = _mm256_set1_ps(3.f);
+			std::size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const __m256 s = _mm256_loadu_ps(u + i);
+				const __m256 s2 = _mm256_mul_ps(s, s);
+				const __m256 s3 = _mm256_mul_ps(s2, s);
+				const __m256 h00 = _mm256_fmadd_ps(two, s3, _mm256_fnmadd_ps(three, s2, one));
+				const __m256 h10 = _mm256_add_ps(_mm256_fnmadd_ps(two, s2, s3), s);
+				const __m256 h01 = _mm256_fmsub_ps(three, s2, _mm256_mul_ps(two, s3));
+				const __m256 h11 = _mm256_sub_ps(s3, s2);
+				__m256 r = _mm256_mul_ps(h00, _mm256_loadu_ps(p0 + i));
+				r = _mm256_fmadd_ps(h10, _mm256_loadu_ps(m0 + i), r);
+				r = _mm256_fmadd_ps(h01, _mm256_loadu_ps(p1 + i), r);
+				r = _mm256_fmadd_ps(h11, _mm256_loadu_ps(m1 + i), r);
+				_mm256_storeu_ps(result + i, r);
+			}
+			if (i < count)
+			{
+				evaluate_hermite_sse2(u + i, p0 + i, m0 + i, p1 + i, m1 + i, result + i, count - i);
+			}
+		}
+
+		VDTMATH_TARGET("avx2,fma")
+		VDTMATH_API void blend_trs_avx2(const trs* a, const trs* b, const float* weights, const std::size_t weight_stride, trs* result, const std::size_t count)
+		{
+			// one element per lane, the 10 floats gathered component by component
+			constexpr int trs_stride = static_cast<int>(sizeof(trs) / sizeof(float));
+			const __m256i index = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(trs_stride));
+			const __m256 one = _mm256_set1_ps(1.f);
+			const __m256 signMask = _mm256_set1_ps(-0.f);
+			alignas(32) float values[trs_stride][8];
+			std::size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const float* const pa = reinterpret_cast<const float*>(a + i);
+				const float* const pb = reinterpret_cast<const float*>(b + i);
+				const __m256 w = weight_stride == 0 ? _mm256_set1_ps(weights[0]) : _mm256_loadu_ps(weights + i);
+
+				__m256 qa[4], qb[4];
+				for (int k = 0; k < 4; ++k)
+				{
+					qa[k] = _mm256_i32gather_ps(pa + 3 + k, index, 4);
+					qb[k] = _mm256_i32gather_ps(pb + 3 + k, index, 4);
+				}
+				// the sign of the dot product flips b to the shortest arc
+				__m256 dot = _mm256_mul_ps(qa[0], qb[0]);
+				for (int k = 1; k < 4; ++k)
+					dot = _mm256_fmadd_ps(qa[k], qb[k], dot);
+				const __m256 sign = _mm256_and_ps(dot, signMask);
+				__m256 length = _mm256_setzero_ps();
+				for (int k = 0; k < 4; ++k)
+				{
+					qa[k] = _mm256_fmadd_ps(_mm256_sub_ps(_mm256_xor_ps(qb[k], sign), qa[k]), w, qa[k]);
+					length = _mm256_fmadd_ps(qa[k], qa[k], length);
+				}
+				const __m256 inverseLength = _mm256_div_ps(one, _mm256_sqrt_ps(length));
+				for (int k = 0; k < 4; ++k)
+					_mm256_store_ps(values[3 + k], _mm256_mul_ps(qa[k], inverseLength));
+
+				// position and scale
+				for (const int k : { 0, 1, 2, 7, 8, 9 })
+				{
+					const __m256 va = _mm256_i32gather_ps(pa + k, index, 4);
+					const __m256 vb = _mm256_i32gather_ps(pb + k, index, 4);
+					_mm256_store_ps(values[k], _mm256_fmadd_ps(_mm256_sub_ps(vb, va), w, va));
+				}
+
+				float* const r = reinterpret_cast<float*>(result + i);
+				for (int lane = 0; lane < 8; ++lane)
+				{
+					for (int k = 0; k < trs_stride; ++k)
+						r[lane * trs_stride + k] = values[k][lane];
+				}
+			}
+			if (i < count)
+			{
+				scalar_kernels().blend_trs(a + i, b + i, weights + i * weight_stride, weight_stride, result + i, count - i);
+			}
+		}
+
+		// avx512
+
+		template <bool Aligned>
+		VDTMATH_TARGET("avx512f")
+		inline void multiply_rows_avx512(const float* a, const __m512 b0, const __m512 b1, const __m512 b2, const __m512 b3, float* result)
+		{
+			// the whole matrix in one register, a cache line when aligned
+			// the full mask forms, the plain ones start from an undefined
+			// register that gcc 12 reports as maybe uninitialized
+			const __m512 m = Aligned ? _mm512_load_ps(a) : _mm512_loadu_ps(a);
+			__m512 r = _mm512_mul_ps(_mm512_mask_permute_ps(m, 0xffff, m, 0x00), b0);
+			r = _mm512_fmadd_ps(_mm512_mask_permute_ps(m, 0xffff, m, 0x55), b1, r);
+			r = _mm512_fmadd_ps(_mm512_mask_permute_ps(m, 0xffff, m, 0xaa), b2, r);
+			r = _mm512_fmadd_ps(_mm512_mask_permute_ps(m, 0xffff, m, 0xff), b3, r);
+			if (Aligned) _mm512_store_ps(result, r);
+			else _mm512_storeu_ps(result, r);
+		}
+
+		VDTMATH_TARGET("avx512f")
+		inline __m512 broadcast_row4(const float* row)
+		{
+			return _mm512_mask_broadcast_f32x4(_mm512_setzero_ps(), 0xffff, _mm_loadu_ps(row));
+		}
+
+		template <bool Aligned>
+		VDTMATH_TARGET("avx512f")
+		inline void multiply_loop_avx512(const matrix4* a, const matrix4* b, matrix4* result, const std::size_t count)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const float* const m = b[i].data;
+				multiply_rows_avx512<Aligned>(a[i].data, broadcast_row4(m), broadcast_row4(m + 4), broadcast_row4(m + 8), broadcast_row4(m + 12), result[i].data);
+			}
+		}
+
+		VDTMATH_TARGET("avx512f")
+		VDTMATH_API void multiply_avx512(const matrix4* a, const matrix4* b, matrix4* result, const std::size_t count)
+		{
+			if (is_aligned(a, 64) && is_aligned(result, 64)) multiply_loop_avx512<true>(a, b, result, count);
+			else multiply_loop_avx512<false>(a, b, result, count);
+		}
+
+		VDTMATH_TARGET("avx512f")
+		VDTMATH_API void multiply_one_avx512(const matrix4& matrix, const matrix4* b, matrix4* result, const std::size_t count)
+		{
+			alignas(64) float a[16];
+			for (unsigned int i = 0; i < 16; ++i) a[i] = matrix.data[i];
+			if (is_aligned(result, 64))
+			{
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					const float* const m = b[i].data;
+					multiply_rows_avx512<true>(a, broadcast_row4(m), broadcast_row4(m + 4), broadcast_row4(m + 8), broadcast_row4(m + 12), result[i].data);
+				}
+				return;
+			}
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const float* const m = b[i].data;
+				multiply_rows_avx512<false>(a, broadcast_row4(m), broadcast_row4(m + 4), broadcast_row4(m + 8), broadcast_row4(m + 12), result[i].data);
+			}
+		}
+
+		VDTMATH_API const kernel_table& sse2_kernels()
+		{
+			static const kernel_table table = {
+				&multiply_sse2,
+				&multiply_one_sse2,
+				&multiply_affine_sse2,
+				&transform_points_sse2,
+				&transform_points_affine_sse2,
+				&transform_normals_sse2,
+				&normalize_sse2,
+				&cull_spheres_sse2,
+				&encode_half_sse2,
+				&decode_half_sse2,
+				// gathers and blends are avx2
+				scalar_kernels().encode_octahedral,
+				scalar_kernels().decode_octahedral,
+				scalar_kernels().encode_positions,
+				scalar_kernels().decode_positions,
+				&evaluate_hermite_sse2,
+				&project_points_sse2,
+				scalar_kernels().blend_trs,
+				&pose_matrices_sse2,
+				&circle_contains_points_sse2,
+				&circle_contains_circles_sse2,
+				&circle_intersects_circles_sse2,
+				&overlap_boxes_sse2
+			};
+			return table;
+		}
+
+		VDTMATH_API const kernel_table& avx2_kernels()
+		{
+			static const kernel_table table = {
+				&multiply_avx2,
+				&multiply_one_avx2,
+				&multiply_affine_avx2,
+				&transform_points_avx2,
+				&transform_points_affine_avx2,
+				&transform_normals_avx2,
+				&normalize_avx2,
+				&cull_spheres_avx2,
+				&encode_half_avx2,
+				&decode_half_avx2,
+				&encode_octahedral_avx2,
+				&decode_octahedral_avx2,
+				&encode_positions_avx2,
+				&decode_positions_avx2,
+				&evaluate_hermite_avx2,
+				&project_points_avx2,
+				&blend_trs_avx2,
+				&pose_matrices_avx2,
+				&circle_contains_points_avx2,
+				&circle_contains_circles_avx2,
+				&circle_intersects_circles_avx2,
+				&overlap_boxes_avx2
+			};
+			return table;
+		}
+
+		// the kernels over vector3 and vector4 arrays are bound by
+		// gathers on their element stride, the affine rows fit
+		// a 128 bit register, the quantization kernels are bound
+		// by the scattered stores and the batch tests write a mask
+		// byte per 8 lanes, they keep the avx2 version
+		VDTMATH_API const kernel_table& avx512_kernels()
+		{
+			static const kernel_table table = {
+				&multiply_avx512,
+				&multiply_one_avx512,
+				&multiply_affine_avx2,
+				&transform_points_avx2,
+				&transform_points_affine_avx2,
+				&transform_normals_avx2,
+				&normalize_avx2,
+				&cull_spheres_avx2,
+				&encode_half_avx2,
+				&decode_half_avx2,
+				&encode_octahedral_avx2,
+				&decode_octahedral_avx2,
+				&encode_positions_avx2,
+				&decode_positions_avx2,
+				&evaluate_hermite_avx2,
+				&project_points_avx2,
+				&blend_trs_avx2,
+				&pose_matrices_avx2,
+				&circle_contains_points_avx2,
+				&circle_contains_circles_avx2,
+				&circle_intersects_circles_avx2,
+				&overlap_boxes_avx2
+			};
+			return table;
+		}
+	}
+}
+
+#endif
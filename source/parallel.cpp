@@ -0,0 +1,248 @@
+#include <vdtmath/parallel.h>
+#include <vdtmath/kernels.h>
+
+#if defined(VDTMATH_PROFILE)
+#include <vdtmath/profile.h>
+#endif
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace math
+{
+	namespace detail
+	{
+		// the pool whose tasks the thread is running
+		VDTMATH_API const thread_pool*& running_pool()
+		{
+			thread_local const thread_pool* pool = nullptr;
+			return pool;
+		}
+
+		VDTMATH_API std::atomic<executor*>& executor_override()
+		{
+			static std::atomic<executor*> value(nullptr);
+			return value;
+		}
+
+		// the chunks start on a multiple of the simd width of every kernel,
+		// the results are then the same as the ones of a single call
+		constexpr std::size_t kernel_granularity = 16;
+
+		VDTMATH_API std::size_t detect_cache_size()
+		{
+#if defined(_WIN32)
+			DWORD size = 0;
+			GetLogicalProcessorInformation(nullptr, &size);
+			std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(size / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+			if (!info.empty() && GetLogicalProcessorInformation(info.data(), &size))
+			{
+				for (const SYSTEM_LOGICAL_PROCESSOR_INFORMATION& i : info)
+				{
+					if (i.Relationship == RelationCache && i.Cache.Level == 2)
+						return i.Cache.Size;
+				}
+			}
+#elif defined(_SC_LEVEL2_CACHE_SIZE)
+			const long size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+			if (size > 0) return static_cast<std::size_t>(size);
+#endif
+			return 256 * 1024;
+		}
+	}
+
+	// thread_pool
+
+	VDTMATH_API thread_pool::thread_pool(const std::size_t threads)
+		: m_threads()
+		, m_task(nullptr)
+		, m_context(nullptr)
+		, m_count(0)
+		, m_next(0)
+		, m_active(0)
+		, m_generation(0)
+		, m_stop(false)
+	{
+		std::size_t count = threads;
+		if (count == 0)
+		{
+			count = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+		}
+		m_threads.reserve(count - 1);
+		for (std::size_t i = 1; i < count; ++i)
+		{
+			m_threads.emplace_back(&thread_pool::work, this);
+		}
+	}
+
+	VDTMATH_API thread_pool::~thread_pool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_wake.notify_all();
+		for (std::thread& thread : m_threads)
+		{
+			thread.join();
+		}
+	}
+
+	VDTMATH_API void thread_pool::run(const std::size_t count, void (*task)(void* context, const std::size_t index), void* context)
+	{
+		if (m_threads.empty() || count == 1 || detail::running_pool() == this)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+				task(context, i);
+			return;
+		}
+
+		std::lock_guard<std::mutex> run(m_runMutex);
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_task = task;
+			m_context = context;
+			m_count = count;
+			m_next.store(0, std::memory_order_relaxed);
+			m_active = m_threads.size();
+			++m_generation;
+		}
+		m_wake.notify_all();
+
+		execute();
+
+		// every worker has left the run before the next one
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_done.wait(lock, [this]() { return m_active == 0; });
+	}
+
+	VDTMATH_API void thread_pool::work()
+	{
+		std::uint64_t generation = 0;
+		std::unique_lock<std::mutex> lock(m_mutex);
+		for (;;)
+		{
+			m_wake.wait(lock, [this, generation]() { return m_stop || m_generation != generation; });
+			if (m_stop) return;
+			generation = m_generation;
+
+			lock.unlock();
+			execute();
+			lock.lock();
+
+			if (--m_active == 0)
+			{
+				m_done.notify_one();
+			}
+		}
+	}
+
+	VDTMATH_API void thread_pool::execute()
+	{
+		const thread_pool* const previous = detail::running_pool();
+		detail::running_pool() = this;
+		for (std::size_t i = m_next.fetch_add(1, std::memory_order_relaxed); i < m_count; i = m_next.fetch_add(1, std::memory_order_relaxed))
+		{
+			m_task(m_context, i);
+		}
+		detail::running_pool() = previous;
+	}
+
+	// executors
+
+	VDTMATH_API executor& default_executor()
+	{
+		static thread_pool pool;
+		return pool;
+	}
+
+	VDTMATH_API void set_executor(executor* instance)
+	{
+		detail::executor_override().store(instance, std::memory_order_release);
+	}
+
+	VDTMATH_API executor& current_executor()
+	{
+		executor* const e = detail::executor_override().load(std::memory_order_acquire);
+		return e ? *e : default_executor();
+	}
+
+	VDTMATH_API std::size_t cache_size()
+	{
+		static const std::size_t size = detail::detect_cache_size();
+		return size;
+	}
+
+	VDTMATH_API std::size_t chunk_size(const std::size_t count, const std::size_t bytes_per_element, const std::size_t granularity)
+	{
+		assert(bytes_per_element > 0 && granularity > 0);
+		const std::size_t threads = current_executor().concurrency();
+		const std::size_t minimum = std::max<std::size_t>(16 * 1024 / bytes_per_element, 1);
+		const std::size_t cached = std::max<std::size_t>(cache_size() / 2 / bytes_per_element, 1);
+		// 4 chunks per thread, for the threads that start late
+		const std::size_t balanced = (count + threads * 4 - 1) / (threads * 4);
+
+		std::size_t chunk = std::max(std::min(balanced, cached), minimum);
+		chunk = (chunk + granularity - 1) / granularity * granularity;
+		return chunk;
+	}
+
+	// batch kernels
+
+	VDTMATH_API void parallel_multiply(const matrix4* a, const matrix4* b, matrix4* result, const std::size_t count)
+	{
+		VDTMATH_PROFILE_SCOPE("parallel_multiply", count);
+		parallel_for(count, chunk_size(count, 3 * sizeof(matrix4), detail::kernel_granularity), [=](const std::size_t begin, const std::size_t end)
+			{
+				multiply(a + begin, b + begin, result + begin, end - begin);
+			});
+	}
+
+	VDTMATH_API void parallel_transform_points(const matrix4& matrix, const vector3* points, vector3* result, const std::size_t count)
+	{
+		VDTMATH_PROFILE_SCOPE("parallel_transform_points", count);
+		parallel_for(count, chunk_size(count, 2 * sizeof(vector3), detail::kernel_granularity), [&matrix, points, result](const std::size_t begin, const std::size_t end)
+			{
+				transform_points(matrix, points + begin, result + begin, end - begin);
+			});
+	}
+
+	VDTMATH_API void parallel_transform_points(const affine3& affine, const vector3* points, vector3* result, const std::size_t count)
+	{
+		VDTMATH_PROFILE_SCOPE("parallel_transform_points", count);
+		parallel_for(count, chunk_size(count, 2 * sizeof(vector3), detail::kernel_granularity), [&affine, points, result](const std::size_t begin, const std::size_t end)
+			{
+				transform_points(affine, points + begin, result + begin, end - begin);
+			});
+	}
+
+	VDTMATH_API void parallel_normalize(vector3* vectors, const std::size_t count)
+	{
+		VDTMATH_PROFILE_SCOPE("parallel_normalize", count);
+		parallel_for(count, chunk_size(count, sizeof(vector3), detail::kernel_granularity), [vectors](const std::size_t begin, const std::size_t end)
+			{
+				normalize(vectors + begin, end - begin);
+			});
+	}
+
+	VDTMATH_API std::size_t parallel_cull_spheres(const vector4* planes, const vector4* spheres, const std::size_t count, std::uint8_t* mask)
+	{
+		VDTMATH_PROFILE_SCOPE("parallel_cull_spheres", count);
+		// and whole bytes of the mask
+		std::atomic<std::size_t> visible(0);
+		parallel_for(count, chunk_size(count, sizeof(vector4), detail::kernel_granularity), [&](const std::size_t begin, const std::size_t end)
+			{
+				visible.fetch_add(cull_spheres(planes, spheres + begin, end - begin, mask + begin / 8), std::memory_order_relaxed);
+			});
+		return visible.load(std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,50 @@
+#include <vdtmath/pose.h>
+#include <vdtmath/kernels.h>
+
+namespace math
+{
+	VDTMATH_API bool is_parent_first(const std::int32_t* parents, const std::size_t count)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			if (parents[i] < -1 || (parents[i] >= 0 && static_cast<std::size_t>(parents[i]) >= i))
+				return false;
+		}
+		return true;
+	}
+
+	// skeleton
+
+	VDTMATH_API skeleton::skeleton()
+		: m_parents()
+		, m_inverseBind()
+	{
+
+	}
+
+	VDTMATH_API bool skeleton::set(const std::int32_t* parents, const matrix4* inverse_bind, const std::size_t count)
+	{
+		if (!is_parent_first(parents, count)) return false;
+
+		m_parents.assign(parents, count);
+		m_inverseBind.assign(inverse_bind, count);
+		return true;
+	}
+
+	// pose
+
+	VDTMATH_API pose::pose(const skeleton& skeleton)
+		: m_skeleton(&skeleton)
+		, m_locals(skeleton.joint_count())
+		, m_model(skeleton.joint_count(), matrix4::identity)
+		, m_palette(skeleton.joint_count(), matrix4::identity)
+	{
+
+	}
+
+	VDTMATH_API void pose::update(const matrix4& root)
+	{
+		assert(m_locals.size() == m_skeleton->joint_count());
+		pose_matrices(m_locals.data(), m_skeleton->parents(), m_skeleton->inverse_bind(), root, m_model.data(), m_palette.data(), m_locals.size());
+	}
+}
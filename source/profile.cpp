@@ -0,0 +1,259 @@
+#include <vdtmath/profile.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+
+namespace math
+{
+	namespace detail
+	{
+		// the slots of the counters of a thread: the profile counters,
+		// the rebuild histogram and the rebuild time
+		constexpr std::size_t profile_counter_count = static_cast<std::size_t>(profile_counter::count);
+		constexpr std::size_t profile_histogram_slot = profile_counter_count;
+		constexpr std::size_t profile_time_slot = profile_histogram_slot + rebuild_histogram_size;
+		constexpr std::size_t profile_slot_count = profile_time_slot + 1;
+
+		// the counters of a thread, written by it only and read by the
+		// others, the increments are plain loads and stores
+		struct profile_block
+		{
+			std::atomic<std::uint64_t> values[profile_slot_count];
+		};
+
+		struct profile_registry
+		{
+			std::mutex mutex;
+			std::vector<profile_block*> blocks;
+			// the counts of the threads that have exited
+			std::uint64_t retired[profile_slot_count] = {};
+		};
+
+		// never destroyed, the threads of the static pools exit after it
+		VDTMATH_API profile_registry& registry()
+		{
+			static profile_registry* const instance = new profile_registry();
+			return *instance;
+		}
+
+		struct profile_thread
+		{
+			profile_thread()
+			{
+				for (std::atomic<std::uint64_t>& value : block.values)
+					value.store(0, std::memory_order_relaxed);
+				profile_registry& r = registry();
+				std::lock_guard<std::mutex> lock(r.mutex);
+				r.blocks.push_back(&block);
+			}
+
+			~profile_thread()
+			{
+				profile_registry& r = registry();
+				std::lock_guard<std::mutex> lock(r.mutex);
+				for (std::size_t i = 0; i < profile_slot_count; ++i)
+					r.retired[i] += block.values[i].load(std::memory_order_relaxed);
+				for (std::size_t i = 0; i < r.blocks.size(); ++i)
+				{
+					if (r.blocks[i] == &block)
+					{
+						r.blocks[i] = r.blocks.back();
+						r.blocks.pop_back();
+						break;
+					}
+				}
+			}
+
+			profile_block block;
+		};
+
+		VDTMATH_API profile_block& thread_block()
+		{
+			thread_local profile_thread instance;
+			return instance.block;
+		}
+
+		VDTMATH_API void profile_add(const std::size_t slot, const std::uint64_t value)
+		{
+			std::atomic<std::uint64_t>& v = thread_block().values[slot];
+			v.store(v.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		}
+
+		VDTMATH_API void profile_add(const profile_counter counter, const std::uint64_t value)
+		{
+			profile_add(static_cast<std::size_t>(counter), value);
+		}
+
+		// the registry is locked
+		VDTMATH_API std::uint64_t profile_sum(const profile_registry& r, const std::size_t slot)
+		{
+			std::uint64_t sum = r.retired[slot];
+			for (const profile_block* block : r.blocks)
+				sum += block->values[slot].load(std::memory_order_relaxed);
+			return sum;
+		}
+
+		VDTMATH_API std::atomic<profile_sink*>& sink()
+		{
+			static std::atomic<profile_sink*> instance(nullptr);
+			return instance;
+		}
+
+		VDTMATH_API std::uint64_t profile_now()
+		{
+			typedef std::chrono::steady_clock clock;
+			static const clock::time_point start = clock::now();
+			return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count());
+		}
+
+		VDTMATH_API std::uint32_t profile_thread_index()
+		{
+			static std::atomic<std::uint32_t> next(1);
+			thread_local const std::uint32_t index = next.fetch_add(1, std::memory_order_relaxed);
+			return index;
+		}
+
+		VDTMATH_API rebuild_timer::~rebuild_timer()
+		{
+			const std::uint64_t duration = profile_now() - m_begin;
+			std::size_t bucket = 0;
+			while (bucket + 1 < rebuild_histogram_size && duration >= rebuild_bound(bucket))
+				++bucket;
+			profile_add(profile_histogram_slot + bucket, 1);
+			profile_add(profile_time_slot, duration);
+		}
+
+		// microseconds with 3 decimals
+		VDTMATH_API void write_microseconds(std::ostream& stream, const std::uint64_t nanoseconds)
+		{
+			const std::uint64_t fraction = nanoseconds % 1000;
+			stream << nanoseconds / 1000 << '.' << (fraction < 100 ? "0" : "") << (fraction < 10 ? "0" : "") << fraction;
+		}
+	}
+
+	VDTMATH_API const char* to_string(const profile_counter counter)
+	{
+		switch (counter)
+		{
+		case profile_counter::matrix_multiply: return "matrix_multiply";
+		case profile_counter::matrix_inverse: return "matrix_inverse";
+		case profile_counter::transform_rebuild: return "transform_rebuild";
+		case profile_counter::transform_static_skip: return "transform_static_skip";
+		case profile_counter::transform_unchanged_skip: return "transform_unchanged_skip";
+		default: return "unknown";
+		}
+	}
+
+	VDTMATH_API std::uint64_t profile_count(const profile_counter counter)
+	{
+		detail::profile_registry& r = detail::registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		return detail::profile_sum(r, static_cast<std::size_t>(counter));
+	}
+
+	// the increments of the threads running at the same time can be lost
+	VDTMATH_API void reset_profile_counters()
+	{
+		detail::profile_registry& r = detail::registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		for (std::size_t i = 0; i < detail::profile_slot_count; ++i)
+		{
+			r.retired[i] = 0;
+			for (detail::profile_block* block : r.blocks)
+				block->values[i].store(0, std::memory_order_relaxed);
+		}
+	}
+
+	VDTMATH_API transform_statistics transform_telemetry()
+	{
+		detail::profile_registry& r = detail::registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		transform_statistics statistics;
+		statistics.rebuilds = detail::profile_sum(r, static_cast<std::size_t>(profile_counter::transform_rebuild));
+		statistics.static_skips = detail::profile_sum(r, static_cast<std::size_t>(profile_counter::transform_static_skip));
+		statistics.unchanged_skips = detail::profile_sum(r, static_cast<std::size_t>(profile_counter::transform_unchanged_skip));
+		statistics.rebuild_time = detail::profile_sum(r, detail::profile_time_slot);
+		for (std::size_t i = 0; i < rebuild_histogram_size; ++i)
+			statistics.rebuild_histogram[i] = detail::profile_sum(r, detail::profile_histogram_slot + i);
+		return statistics;
+	}
+
+	VDTMATH_API void set_profile_sink(profile_sink* sink)
+	{
+		detail::sink().store(sink, std::memory_order_release);
+	}
+
+	VDTMATH_API profile_sink* current_profile_sink()
+	{
+		return detail::sink().load(std::memory_order_acquire);
+	}
+
+	// chrome_trace_sink
+
+	VDTMATH_API void chrome_trace_sink::record(const profile_event& event)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_events.push_back(event);
+	}
+
+	VDTMATH_API std::size_t chrome_trace_sink::size() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_events.size();
+	}
+
+	VDTMATH_API void chrome_trace_sink::clear()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_events.clear();
+	}
+
+	VDTMATH_API void chrome_trace_sink::write(std::ostream& stream) const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		stream << "{\"traceEvents\":[";
+		for (std::size_t i = 0; i < m_events.size(); ++i)
+		{
+			const profile_event& e = m_events[i];
+			stream << (i == 0 ? "\n" : ",\n") << "{\"name\":\"";
+			for (const char* c = e.name; *c != '\0'; ++c)
+			{
+				if (*c == '"' || *c == '\\') stream << '\\';
+				stream << *c;
+			}
+			stream << "\",\"cat\":\"vdtmath\",\"ph\":\"X\",\"ts\":";
+			detail::write_microseconds(stream, e.begin);
+			stream << ",\"dur\":";
+			detail::write_microseconds(stream, e.duration);
+			stream << ",\"pid\":1,\"tid\":" << e.thread << ",\"args\":{\"count\":" << e.count << "}}";
+		}
+		stream << "\n],\"displayTimeUnit\":\"ns\"}\n";
+	}
+
+	VDTMATH_API bool chrome_trace_sink::save(const char* path) const
+	{
+		std::ofstream file(path, std::ios::out | std::ios::trunc);
+		if (!file) return false;
+		write(file);
+		return static_cast<bool>(file);
+	}
+
+	// scoped_timer
+
+	VDTMATH_API scoped_timer::scoped_timer(const char* name, const std::size_t count)
+		: m_sink(current_profile_sink())
+		, m_name(name)
+		, m_count(count)
+		, m_begin(0)
+	{
+		if (m_sink) m_begin = detail::profile_now();
+	}
+
+	VDTMATH_API scoped_timer::~scoped_timer()
+	{
+		if (m_sink == nullptr) return;
+		const std::uint64_t end = detail::profile_now();
+		m_sink->record(profile_event{ m_name, m_begin, end - m_begin, detail::profile_thread_index(), m_count });
+	}
+}
@@ -2,15 +2,18 @@
 
 namespace math
 {
-	const quaternion quaternion::identity = quaternion(0.f, 0.f, 0.f, 1.0f);
+	template <typename T>
+	const quaternion_t<T> quaternion_t<T>::identity = quaternion_t<T>(0.0, 0.0, 0.0, 1.0);
 
-	quaternion::quaternion()
-		: x(), y(), z(), w(1.0f)
+	template <typename T>
+	quaternion_t<T>::quaternion_t()
+		: x(), y(), z(), w(static_cast<T>(1.0))
 	{
 
 	}
 
-	quaternion::quaternion(const vector3& vector, const float scalar)
+	template <typename T>
+	quaternion_t<T>::quaternion_t(const vector3_t<T>& vector, const T scalar)
 		: x(vector.x)
 		, y(vector.y)
 		, z(vector.z)
@@ -18,7 +21,8 @@ namespace math
 	{
 	}
 
-	quaternion::quaternion(const float _x, const float _y, const float _z, const float _w /* = 1.0f */)
+	template <typename T>
+	quaternion_t<T>::quaternion_t(const T _x, const T _y, const T _z, const T _w /* = 1.0 */)
 		: x(_x)
 		, y(_y)
 		, z(_z)
@@ -26,12 +30,14 @@ namespace math
 	{
 	}
 
-	float quaternion::dot(const quaternion& quaternion) const
+	template <typename T>
+	T quaternion_t<T>::dot(const quaternion_t& quaternion) const
 	{
 		return (*this) * quaternion;
 	}
 
-	quaternion quaternion::cross(const quaternion& quaternion) const
+	template <typename T>
+	quaternion_t<T> quaternion_t<T>::cross(const quaternion_t& quaternion) const
 	{
 		return {
 			w * quaternion.x + x * quaternion.w + y * quaternion.z - z * quaternion.y,
@@ -41,31 +47,33 @@ namespace math
 		};
 	}
 
-	matrix4 quaternion::matrix() const
+	template <typename T>
+	matrix4_t<T> quaternion_t<T>::matrix() const
 	{
-		const float xy = x * y;
-		const float xz = x * z;
-		const float yz = y * z;
-		const float x2 = x * x;
-		const float y2 = y * y;
-		const float z2 = z * z;
+		const T xy = x * y;
+		const T xz = x * z;
+		const T yz = y * z;
+		const T x2 = x * x;
+		const T y2 = y * y;
+		const T z2 = z * z;
 
-		matrix4 result(
-			1.0f - 2 * y2 - 2 * z2, 2 * xy + 2 * w * z, 2 * xz - 2 * w * y, 0.0f,
-			2 * xy - 2 * w * z, 1 - 2 * x2 - 2 * z2, 2 * yz + 2 * w * z, 0.0f,
-			2 * xz + 2 * w * y, 2 * yz - 2 * w * x, 1 - 2 * x2 - 2 * y2, 0.0f,
-			0.0f, 0.0f, 0.0f, 1.0f
+		matrix4_t<T> result(
+			1 - 2 * y2 - 2 * z2, 2 * xy + 2 * w * z, 2 * xz - 2 * w * y, 0,
+			2 * xy - 2 * w * z, 1 - 2 * x2 - 2 * z2, 2 * yz + 2 * w * x, 0,
+			2 * xz + 2 * w * y, 2 * yz - 2 * w * x, 1 - 2 * x2 - 2 * y2, 0,
+			0, 0, 0, 1
 		);
 		return result;
 	}
 
-	vector4 quaternion::axisAngle() const
+	template <typename T>
+	vector4_t<T> quaternion_t<T>::axisAngle() const
 	{
-		vector4 result;
-		const float angle = 2.0f * std::acos(w);
-		const float l = sqrt(1.0f - angle * angle);
-		assert(l != 0.0f);
-		const float f = 1.0f / l;
+		vector4_t<T> result;
+		const T angle = 2 * detail::acos(w);
+		const T l = std::sqrt(1 - angle * angle);
+		assert(l != static_cast<T>(0.0));
+		const T f = 1 / l;
 		result.x *= f;
 		result.y *= f;
 		result.z *= f;
@@ -75,38 +83,28 @@ namespace math
 
 	// operators overloading
 
-	quaternion& quaternion::operator= (const quaternion& quaternion)
-	{
-		// check for self-assignment
-		if (this == &quaternion)
-			return *this;
-
-		// copy 
-		x = quaternion.x;
-		y = quaternion.y;
-		z = quaternion.z;
-		w = quaternion.w;
-		return *this;
-	}
-
-	bool quaternion::operator== (const quaternion& quaternion) const
+	template <typename T>
+	bool quaternion_t<T>::operator== (const quaternion_t& quaternion) const
 	{
 		return x == quaternion.x && y == quaternion.y
 			&& z == quaternion.z && w == quaternion.w;
 	}
 
-	bool quaternion::operator!= (const quaternion& quaternion) const
+	template <typename T>
+	bool quaternion_t<T>::operator!= (const quaternion_t& quaternion) const
 	{
 		return x != quaternion.x || y != quaternion.y
 			|| z != quaternion.z || w != quaternion.w;
 	}
 
-	quaternion quaternion::operator- ()
+	template <typename T>
+	quaternion_t<T> quaternion_t<T>::operator- ()
 	{
 		return { -x, -y, -z, -w };
 	}
 
-	quaternion quaternion::operator+ (const quaternion& quaternion) const
+	template <typename T>
+	quaternion_t<T> quaternion_t<T>::operator+ (const quaternion_t& quaternion) const
 	{
 		return {
 			x + quaternion.x,
@@ -116,7 +114,8 @@ namespace math
 		};
 	}
 
-	quaternion& quaternion::operator+= (const quaternion& quaternion)
+	template <typename T>
+	quaternion_t<T>& quaternion_t<T>::operator+= (const quaternion_t& quaternion)
 	{
 		x += quaternion.x;
 		y += quaternion.y;
@@ -125,7 +124,8 @@ namespace math
 		return *this;
 	}
 
-	quaternion& quaternion::operator-= (const quaternion& quaternion)
+	template <typename T>
+	quaternion_t<T>& quaternion_t<T>::operator-= (const quaternion_t& quaternion)
 	{
 		x -= quaternion.x;
 		y -= quaternion.y;
@@ -134,12 +134,14 @@ namespace math
 		return *this;
 	}
 
-	quaternion quaternion::operator* (const float scalar) const
+	template <typename T>
+	quaternion_t<T> quaternion_t<T>::operator* (const T scalar) const
 	{
 		return { x * scalar, y * scalar, z * scalar, w * scalar };
 	}
 
-	quaternion& quaternion::operator*= (const float scalar)
+	template <typename T>
+	quaternion_t<T>& quaternion_t<T>::operator*= (const T scalar)
 	{
 		x *= scalar;
 		y *= scalar;
@@ -148,17 +150,19 @@ namespace math
 		return *this;
 	}
 
-	quaternion quaternion::operator/ (const float scalar) const
+	template <typename T>
+	quaternion_t<T> quaternion_t<T>::operator/ (const T scalar) const
 	{
-		assert(scalar != 0.0f);
-		const float f = 1.0f / scalar;
+		assert(scalar != static_cast<T>(0.0));
+		const T f = 1 / scalar;
 		return { x * f, y * f, z * f, w * f };
 	}
 
-	quaternion& quaternion::operator/= (const float scalar)
+	template <typename T>
+	quaternion_t<T>& quaternion_t<T>::operator/= (const T scalar)
 	{
-		assert(scalar != 0.0f);
-		const float f = 1.0f / scalar;
+		assert(scalar != static_cast<T>(0.0));
+		const T f = 1 / scalar;
 		x *= f;
 		y *= f;
 		z *= f;
@@ -166,55 +170,67 @@ namespace math
 		return *this;
 	}
 
-	float quaternion::length() const
+	template <typename T>
+	T quaternion_t<T>::length() const
 	{
 		return std::sqrt(x * x + y * y + z * z + w * w);
 	}
 
-	quaternion quaternion::normalize() const
+	template <typename T>
+	quaternion_t<T> quaternion_t<T>::normalize() const
 	{
-		const float l = length();
-		assert(l != 0.0f);
-		return (*this) * (1.0f / l);
+		const T l = length();
+		assert(l != static_cast<T>(0.0));
+		return (*this) * (1 / l);
 	}
 
-	quaternion quaternion::inverse() const
+	template <typename T>
+	quaternion_t<T> quaternion_t<T>::inverse() const
 	{
-		const float l = length();
-		assert(l != 0.0f);
-		const float f = 1.0f / static_cast<float>(std::pow(l, 2));
-		return quaternion(-x * f, -y * f, -z * f, w * f);
+		// the squared length, without the rounding of sqrt and pow
+		const T l2 = x * x + y * y + z * z + w * w;
+		assert(l2 != static_cast<T>(0.0));
+		const T f = 1 / l2;
+		return quaternion_t(-x * f, -y * f, -z * f, w * f);
 	}
 
-	float quaternion::operator* (const quaternion& quaternion) const
+	template <typename T>
+	T quaternion_t<T>::operator* (const quaternion_t& quaternion) const
 	{
 		return w * quaternion.w + x * quaternion.x + y * quaternion.y + z * quaternion.z;
 	}
 
-	vector3 quaternion::operator* (const vector3& vector) const
+	template <typename T>
+	vector3_t<T> quaternion_t<T>::operator* (const vector3_t<T>& vector) const
 	{
-		vector3 uv, uuv;
-		vector3 qvec(x, y, z);
+		vector3_t<T> uv, uuv;
+		vector3_t<T> qvec(x, y, z);
 		uv = qvec.cross(vector);
 		uuv = qvec.cross(uv);
-		uv *= 2.0f * w;
-		uuv *= 2.0f;
+		uv *= 2 * w;
+		uuv *= 2;
 
 		return vector + uv + uuv;
 	}
 
-	vector4 quaternion::operator* (const vector4& vector) const
+	template <typename T>
+	vector4_t<T> quaternion_t<T>::operator* (const vector4_t<T>& vector) const
 	{
-		vector3 vec(vector.x, vector.y, vector.z);
-		vector3 uv, uuv;
-		vector3 qvec(x, y, z);
+		vector3_t<T> vec(vector.x, vector.y, vector.z);
+		vector3_t<T> uv, uuv;
+		vector3_t<T> qvec(x, y, z);
 		uv = qvec.cross(vec);
 		uuv = qvec.cross(uv);
-		uv *= 2.0f * w;
-		uuv *= 2.0f;
+		uv *= 2 * w;
+		uuv *= 2;
 
-		const vector3 sum = vec + uv + uuv;
+		const vector3_t<T> sum = vec + uv + uuv;
 
-		return vector4(sum.x, sum.y, sum.z, 1.0f);
+		return vector4_t<T>(sum.x, sum.y, sum.z, 1);
 	}
-}
\ No newline at end of file
+
+#if !defined(VDTMATH_HEADER_ONLY)
+	template struct quaternion_t<float>;
+	template struct quaternion_t<double>;
+#endif
+}
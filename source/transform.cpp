@@ -1,32 +1,48 @@
 #include <vdtmath/transform.h>
 
+// the update counters are always on, only the rebuild timer needs VDTMATH_PROFILE
+#include <vdtmath/profile.h>
+
 namespace math
 {
-	transform::transform()
+	template <typename T>
+	transform_t<T>::transform_t()
 		: position()
 		, rotation()
-		, scale(1.0f, 1.0f, 1.0f)
+		, scale(1.0, 1.0, 1.0)
 		, isStatic(false)
-		, m_matrix(matrix4::identity)
+		, m_matrix(matrix4_t<T>::identity)
 		, m_wasStatic(isStatic)
 		, m_state()
 	{
 
 	}
 	
-	void transform::update()
+	template <typename T>
+	void transform_t<T>::update()
 	{
-		if (isStatic && m_wasStatic) return;
+		if (isStatic && m_wasStatic)
+		{
+			detail::profile_add(profile_counter::transform_static_skip, 1);
+			return;
+		}
 
 		if (bool isChanged = m_state.update(*this))
 		{
+			detail::profile_add(profile_counter::transform_rebuild, 1);
+			VDTMATH_PROFILE_REBUILD();
 			//m_matrix = matrix4::scale(scale) * rotation.matrix() * matrix4::translate(position);
-			m_matrix = matrix4::scale(scale) * matrix4::rotate_z(rotation.z) * matrix4::translate(position);
+			m_matrix = matrix4_t<T>::scale(scale) * matrix4_t<T>::rotate_z(rotation.z) * matrix4_t<T>::translate(position);
+		}
+		else
+		{
+			detail::profile_add(profile_counter::transform_unchanged_skip, 1);
 		}
 		m_wasStatic = isStatic;
 	}
 	
-	bool transform::State::update(transform& transform)
+	template <typename T>
+	bool transform_t<T>::State::update(transform_t& transform)
 	{
 		if (position != transform.position
 			|| rotation != transform.rotation
@@ -39,4 +55,9 @@ namespace math
 		}
 		return false;
 	}
-}
\ No newline at end of file
+
+#if !defined(VDTMATH_HEADER_ONLY)
+	template class transform_t<float>;
+	template class transform_t<double>;
+#endif
+}